@@ -46,9 +46,10 @@ if(NOT ORIGIN_INCLUDED)
   include(BoostUtils)
 
 
-  # Be sure to compile in C++11 mode!
+  # Be sure to compile in C++11 mode! Parallel algorithms use std::thread,
+  # which requires -pthread.
   # FIXME: Move the C++ configuration stuff into a separate config module.
-  set(CMAKE_CXX_FLAGS "-std=c++11")
+  set(CMAKE_CXX_FLAGS "-std=c++11 -pthread")
 
   # Make sure that we can include files as <origin/xxx>.
   # FIXME: It would be nice if...
@@ -61,6 +62,8 @@ if(NOT ORIGIN_INCLUDED)
   include(OriginVersion)
   include(OriginModule)
   include(OriginTest)
+  include(OriginExecutable)
+  include(OriginPerformance)
 
 endif()
 
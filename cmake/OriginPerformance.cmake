@@ -10,15 +10,15 @@
 # This module contains macros used to build performance testing targets.
 # Each performance test is hosted in a different directory (usually as a
 # subdirectory of tests/perf), and contains one or more programs that are
-# compiled and run (using 'make performance') to produce and compile results.
+# compiled and run (using 'make perform') to produce and compile results.
 #
 # Note that a full system for compiling performance test results is still
 # being worked out.
 
 
-# Tools used to analyze and graph results
-
-set(ORIGIN_PLOT_COMP_RATIO ${ORIGIN_ROOT}/tools/)
+# The perform target builds and runs every performance test. Performance
+# programs are not part of the default build.
+add_custom_target(perform)
 
 
 # Build a head-to-head performance comparison for two different source code
@@ -29,10 +29,14 @@ set(ORIGIN_PLOT_COMP_RATIO ${ORIGIN_ROOT}/tools/)
 # If REPEAT is not given, the default value is 1. For head-to-head performance
 # tests, that isn't generally a good idea.
 #
+# Each program is run with the number of repetitions as its only argument,
+# and its standard output is saved as perf_<target>_<name>.csv in the
+# current binary directory, where <name> is the name of the source file.
+# The programs link against the current module and its imports.
+#
 # TODO: Support arguments for annotating the resulting documents or selecting
-# the output format. Currently, we generate pdf, but generating png might be
-# useful for web reporting. Or build commands that generate generate all such
-# outputs and build a single target that intgrates the performance reporting.
+# the output format. A plotting tool that compiles the results into graphs
+# does not exist yet, so the results are left as CSV.
 #
 # FIXME: I will need to change the call mechanism when I get the performance
 # tester's argument parsing in better shape. Repetitions will probably be
@@ -55,34 +59,32 @@ macro(origin_perf_comparison id)
     get_filename_component(name ${i} NAME_WE)
     set(tgt ${main}_${name})
 
-    # Create a target for the test program.
+    # Create a target for the test program. It is only built by the
+    # performance target, and it is always optimized (without assertions),
+    # regardless of the build type.
     origin_executable(${tgt} ${i})
-    target_link_libraries(${tgt} origin)
+    set_target_properties(${tgt} PROPERTIES
+      EXCLUDE_FROM_ALL TRUE
+      COMPILE_FLAGS "-O2 -DNDEBUG")
+    link_imports(${tgt} ${ORIGIN_CURRENT_MODULE})
 
     # And create a command that will generate its output.
     # FIXME: This probably won't work in a non-unix environment or
     # anywhere where executable targets have a non-empty suffix.
     set(exe ${bin}/${tgt})
-    set(txt ${exe}.txt)
+    set(csv ${exe}.csv)
     add_custom_command(
-      OUTPUT ${txt}
-      COMMAND ${exe} ${repeat} > ${txt}
+      OUTPUT ${csv}
+      COMMAND ${exe} ${repeat} > ${csv}
       DEPENDS ${tgt})
 
-    # Add the output text to the list of dependencies that this
-    # performance comparison will depend upon.
-    list(APPEND results ${txt})
+    # Add the output to the list of dependencies that this performance
+    # comparison will depend upon.
+    list(APPEND results ${csv})
   endforeach()
 
-  # Generate a command to synthesize the output into a graph of some kind.
-  set(pdf ${main}.pdf)
-  add_custom_command(
-    OUTPUT ${pdf}
-    COMMAND ${ORIGIN_PLOT_COMP_RATIO}.py -o ${pdf} ${results}
-    DEPENDS ${results})
-
   # Build a target for this performance comparison
-  add_custom_target(${main} DEPENDS ${pdf})
+  add_custom_target(${main} DEPENDS ${results})
 
   # Register this performance test as a dependency of the perf target.
   add_dependencies(perform ${main})
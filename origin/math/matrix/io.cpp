@@ -0,0 +1,408 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include "io.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <istream>
+#include <limits>
+#include <ostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace origin
+{
+  namespace matrix_impl
+  {
+    namespace
+    {
+      // The matrix format begins with the magic string "OMAT", a version
+      // byte, the element kind and size, and the order, followed by the
+      // 64-bit extents. The header is padded to a multiple of 64 bytes.
+      const char matrix_magic[4] = {'O', 'M', 'A', 'T'};
+      constexpr unsigned char matrix_version = 1;
+
+      // The npy format begins with "\x93NUMPY", the major and minor version
+      // bytes, and the length of the header dictionary (2 bytes in version
+      // 1.0, 4 bytes otherwise).
+      const char npy_magic[6] = {'\x93', 'N', 'U', 'M', 'P', 'Y'};
+
+      constexpr std::size_t header_align = 64;
+
+      inline std::size_t
+      align_up(std::size_t n, std::size_t a)
+      {
+        return (n + a - 1) / a * a;
+      }
+
+      inline std::uint64_t
+      get_le(const char* p, std::size_t n)
+      {
+        std::uint64_t x = 0;
+        for (std::size_t i = n; i-- != 0; )
+          x = (x << 8) | static_cast<unsigned char>(p[i]);
+        return x;
+      }
+
+      inline void
+      put_le(char* p, std::uint64_t x, std::size_t n)
+      {
+        for (std::size_t i = 0; i != n; ++i, x >>= 8)
+          p[i] = static_cast<char>(x & 0xff);
+      }
+
+      // Returns true if the element kind and size are supported.
+      inline bool
+      valid_element(char kind, std::size_t size)
+      {
+        switch (kind) {
+        case 'b': return size == 1;
+        case 'f': return size == 4 || size == 8;
+        case 'i':
+        case 'u': return size == 1 || size == 2 || size == 4 || size == 8;
+        default: return false;
+        }
+      }
+
+
+      // Parse the matrix format header.
+      bool
+      parse_matrix_header(const char* p, std::size_t n, file_header& h)
+      {
+        if (static_cast<unsigned char>(p[4]) != matrix_version)
+          return false;
+        h.kind = p[5];
+        h.elem_size = static_cast<unsigned char>(p[6]);
+        h.order = static_cast<unsigned char>(p[7]);
+        h.column_major = false;
+        h.offset = n;
+        if (h.order == 0 || h.order > max_order)
+          return false;
+        if (8 + 8 * h.order > n)
+          return false;
+        for (std::size_t i = 0; i != h.order; ++i)
+          h.extents[i] = get_le(p + 8 + 8 * i, 8);
+        return valid_element(h.kind, h.elem_size);
+      }
+
+
+      // Returns true if the number of bytes of the elements described by
+      // the header can be represented. A header whose extents multiply past
+      // the range of size_t would otherwise describe an empty matrix with
+      // nonzero extents.
+      bool
+      valid_size(const file_header& h)
+      {
+        std::size_t bytes = h.elem_size;
+        for (std::size_t i = 0; i != h.order; ++i) {
+          const std::size_t e = h.extents[i];
+          if (e != 0 && bytes > std::numeric_limits<std::size_t>::max() / e)
+            return false;
+          bytes *= e;
+        }
+        return true;
+      }
+
+
+      // A minimal scanner for the Python dictionary literal in an npy
+      // header, e.g.:
+      //
+      //    {'descr': '<f8', 'fortran_order': False, 'shape': (3, 4), }
+      struct dict_scanner
+      {
+        void skip_space()
+        {
+          while (first != last && (*first == ' ' || *first == '\n'))
+            ++first;
+        }
+
+        bool expect(char c)
+        {
+          skip_space();
+          if (first == last || *first != c)
+            return false;
+          ++first;
+          return true;
+        }
+
+        bool peek(char c)
+        {
+          skip_space();
+          return first != last && *first == c;
+        }
+
+        bool string(std::string& s)
+        {
+          skip_space();
+          if (first == last || (*first != '\'' && *first != '"'))
+            return false;
+          char q = *first++;
+          const char* p = first;
+          while (first != last && *first != q)
+            ++first;
+          if (first == last)
+            return false;
+          s.assign(p, first++);
+          return true;
+        }
+
+        bool word(std::string& s)
+        {
+          skip_space();
+          const char* p = first;
+          while (first != last && std::isalnum(static_cast<unsigned char>(*first)))
+            ++first;
+          s.assign(p, first);
+          return !s.empty();
+        }
+
+        const char* first;
+        const char* last;
+      };
+
+      bool
+      parse_descr(const std::string& d, file_header& h)
+      {
+        if (d.size() < 3)
+          return false;
+        if (d[0] != '<' && d[0] != '|' && d[0] != '=')
+          return false;
+        h.kind = d[1];
+        std::size_t size = 0;
+        for (std::size_t i = 2; i != d.size(); ++i) {
+          if (!std::isdigit(static_cast<unsigned char>(d[i])))
+            return false;
+          size = size * 10 + (d[i] - '0');
+        }
+        h.elem_size = size;
+        return valid_element(h.kind, h.elem_size);
+      }
+
+      bool
+      parse_shape(dict_scanner& s, file_header& h)
+      {
+        h.order = 0;
+        if (!s.expect('('))
+          return false;
+        while (!s.peek(')')) {
+          std::string n;
+          if (!s.word(n) || h.order == max_order)
+            return false;
+          std::size_t x = 0;
+          for (char c : n) {
+            if (!std::isdigit(static_cast<unsigned char>(c)))
+              return false;
+            const std::size_t d = c - '0';
+            if (x > (std::numeric_limits<std::size_t>::max() - d) / 10)
+              return false;
+            x = x * 10 + d;
+          }
+          h.extents[h.order++] = x;
+          if (!s.peek(')') && !s.expect(','))
+            return false;
+        }
+        return s.expect(')');
+      }
+
+      // Parse the npy format header.
+      bool
+      parse_npy_header(const char* p, std::size_t n, file_header& h)
+      {
+        const std::size_t prefix = p[6] == 1 ? 10 : 12;
+        h.offset = n;
+        h.column_major = false;
+        dict_scanner s {p + prefix, p + n};
+        bool descr = false, order = false, shape = false;
+        if (!s.expect('{'))
+          return false;
+        while (!s.peek('}')) {
+          std::string key;
+          if (!s.string(key) || !s.expect(':'))
+            return false;
+          if (key == "descr") {
+            std::string d;
+            if (!s.string(d) || !parse_descr(d, h))
+              return false;
+            descr = true;
+          } else if (key == "fortran_order") {
+            std::string b;
+            if (!s.word(b) || (b != "True" && b != "False"))
+              return false;
+            h.column_major = b == "True";
+            order = true;
+          } else if (key == "shape") {
+            if (!parse_shape(s, h))
+              return false;
+            shape = true;
+          } else {
+            return false;
+          }
+          if (!s.peek('}') && !s.expect(','))
+            return false;
+        }
+
+        // NumPy stores scalars as arrays with an empty shape. They are not
+        // matrices.
+        return descr && order && shape && h.order != 0;
+      }
+
+    } // namespace
+
+
+    bool
+    little_endian()
+    {
+      const std::uint16_t x = 1;
+      char c;
+      std::memcpy(&c, &x, 1);
+      return c == 1;
+    }
+
+    std::size_t
+    header_length(const char* p, std::size_t n)
+    {
+      if (n < header_prefix || !little_endian())
+        return 0;
+      if (std::equal(matrix_magic, matrix_magic + 4, p)) {
+        const std::size_t order = static_cast<unsigned char>(p[7]);
+        return align_up(8 + 8 * order, header_align);
+      }
+      if (std::equal(npy_magic, npy_magic + 6, p)) {
+        switch (p[6]) {
+        case 1: return 10 + get_le(p + 8, 2);
+        case 2:
+        case 3: return 12 + get_le(p + 8, 4);
+        default: return 0;
+        }
+      }
+      return 0;
+    }
+
+    bool
+    parse_header(const char* p, std::size_t n, file_header& h)
+    {
+      if (header_length(p, n) != n)
+        return false;
+      const bool ok = p[0] == matrix_magic[0] ? parse_matrix_header(p, n, h)
+                                              : parse_npy_header(p, n, h);
+      return ok && valid_size(h);
+    }
+
+    bool
+    read_header(std::istream& is, file_header& h)
+    {
+      std::string buf(header_prefix, '\0');
+      if (!is.read(&buf[0], header_prefix))
+        return false;
+      const std::size_t n = header_length(buf.data(), buf.size());
+      if (n < header_prefix)
+        return false;
+      buf.resize(n);
+      if (!is.read(&buf[header_prefix], n - header_prefix))
+        return false;
+      return parse_header(buf.data(), n, h);
+    }
+
+    bool
+    write_header(std::ostream& os, char kind, std::size_t elem_size,
+                 std::size_t order, const std::size_t* extents)
+    {
+      if (!little_endian() || order > max_order)
+        return false;
+      std::string buf(align_up(8 + 8 * order, header_align), '\0');
+      std::copy(matrix_magic, matrix_magic + 4, &buf[0]);
+      buf[4] = static_cast<char>(matrix_version);
+      buf[5] = kind;
+      buf[6] = static_cast<char>(elem_size);
+      buf[7] = static_cast<char>(order);
+      for (std::size_t i = 0; i != order; ++i)
+        put_le(&buf[8 + 8 * i], extents[i], 8);
+      return bool(os.write(buf.data(), buf.size()));
+    }
+
+    bool
+    write_npy_header(std::ostream& os, char kind, std::size_t elem_size,
+                     std::size_t order, const std::size_t* extents)
+    {
+      if (!little_endian())
+        return false;
+
+      std::string dict = "{'descr': '";
+      dict += elem_size == 1 ? '|' : '<';
+      dict += kind;
+      dict += std::to_string(elem_size);
+      dict += "', 'fortran_order': False, 'shape': (";
+      for (std::size_t i = 0; i != order; ++i) {
+        dict += std::to_string(extents[i]);
+        if (order == 1 || i + 1 != order)
+          dict += ',';
+        if (i + 1 != order)
+          dict += ' ';
+      }
+      dict += "), }";
+
+      // Pad the dictionary with spaces and a newline so that the elements
+      // are aligned. Use version 2.0 only if the header is too long for 1.0.
+      std::size_t prefix = 10;
+      std::size_t total = align_up(prefix + dict.size() + 1, header_align);
+      if (total - prefix > 0xffff) {
+        prefix = 12;
+        total = align_up(prefix + dict.size() + 1, header_align);
+      }
+      dict.resize(total - prefix - 1, ' ');
+      dict += '\n';
+
+      char buf[12];
+      std::copy(npy_magic, npy_magic + 6, buf);
+      buf[6] = prefix == 10 ? 1 : 2;
+      buf[7] = 0;
+      put_le(buf + 8, dict.size(), prefix - 8);
+      return os.write(buf, prefix) && os.write(dict.data(), dict.size());
+    }
+
+  } // namespace matrix_impl
+
+
+  bool
+  mapped_file::open(const std::string& path)
+  {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      return false;
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+      ::close(fd);
+      return false;
+    }
+
+    // The mapping remains valid after the descriptor is closed.
+    void* p = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED)
+      return false;
+    ptr = p;
+    len = st.st_size;
+    return true;
+  }
+
+  void
+  mapped_file::close()
+  {
+    if (ptr) {
+      ::munmap(ptr, len);
+      ptr = nullptr;
+      len = 0;
+    }
+  }
+
+} // namespace origin
@@ -0,0 +1,634 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_IO_HPP
+#define ORIGIN_MATH_MATRIX_IO_HPP
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iosfwd>
+#include <iterator>
+#include <string>
+
+#include <origin/math/matrix/matrix.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                              [matrix.io]
+  //                            Binary Matrix I/O
+  //
+  // Matrices are stored in one of two binary formats:
+  //
+  //    matrix  -- A 64-byte aligned header giving the element type and the
+  //               extents, followed by the elements in row-major order.
+  //    npy     -- The NumPy array format (versions 1.0, 2.0 and 3.0).
+  //
+  // Both formats store their headers and elements in little-endian byte
+  // order; the operations in this file fail on big-endian hosts. Elements
+  // are never converted: reading a file whose element type or order differs
+  // from that of the target matrix fails.
+  //
+  // Readers detect the format of their input, so a matrix written in either
+  // format can be read by the same operation. Operations return false on
+  // failure, leaving their target matrix unmodified.
+  //
+  // A file in either format can also be memory-mapped (see mapped_matrix),
+  // giving a constant matrix reference to its elements without reading
+  // them.
+
+
+  namespace matrix_impl
+  {
+    // A description of the element type and layout of a stored matrix.
+    //
+    // kind is one of 'f' (floating point), 'i' (signed integer), 'u'
+    // (unsigned integer) or 'b' (bool). The offset is the position of the
+    // first element relative to the start of the header. NumPy arrays may be
+    // stored in column-major (Fortran) order. Stored matrices have at most
+    // max_order dimensions.
+    constexpr std::size_t max_order = 16;
+
+    struct file_header
+    {
+      char kind;
+      std::size_t elem_size;
+      std::size_t order;
+      std::size_t extents[max_order];
+      bool column_major;
+      std::size_t offset;
+    };
+
+    // Returns true if the host stores integers in little-endian byte order.
+    bool little_endian();
+
+    // Returns the length of the header beginning with the n bytes at p, or 0
+    // if the bytes do not begin a header. At least header_prefix bytes are
+    // required to determine the length.
+    constexpr std::size_t header_prefix = 12;
+    std::size_t header_length(const char* p, std::size_t n);
+
+    // Parse the complete header of length n at p into h. Returns false if
+    // the header is malformed.
+    bool parse_header(const char* p, std::size_t n, file_header& h);
+
+    // Read the header at the current position of is into h, leaving the
+    // stream positioned at the first element.
+    bool read_header(std::istream& is, file_header& h);
+
+    // Write a header in the matrix or npy format describing a matrix with
+    // the given element type and extents.
+    bool write_header(std::ostream& os, char kind, std::size_t elem_size,
+                      std::size_t order, const std::size_t* extents);
+    bool write_npy_header(std::ostream& os, char kind, std::size_t elem_size,
+                          std::size_t order, const std::size_t* extents);
+
+
+    // Returns the kind code of the element type T.
+    template <typename T>
+      constexpr char
+      element_kind()
+      {
+        return std::is_same<T, bool>::value ? 'b'
+             : std::is_floating_point<T>::value ? 'f'
+             : std::is_signed<T>::value ? 'i'
+             : 'u';
+      }
+
+    // Returns true if the header h describes an N-dimensional matrix of T.
+    template <typename T, std::size_t N>
+      inline bool
+      header_matches(const file_header& h)
+      {
+        static_assert(std::is_arithmetic<T>::value, "");
+        return h.kind == element_kind<T>()
+            && h.elem_size == sizeof(T)
+            && h.order == N;
+      }
+
+    // Returns the slice describing the elements of the stored matrix. The
+    // header has been validated by parse_header, so the number of elements
+    // does not overflow.
+    template <std::size_t N>
+      matrix_slice<N>
+      header_slice(const file_header& h)
+      {
+        matrix_slice<N> s;
+        s.start = 0;
+        s.size = 1;
+        for (std::size_t i = 0; i != N; ++i) {
+          s.extents[i] = h.extents[i];
+          s.size *= h.extents[i];
+        }
+        if (h.column_major) {
+          s.strides[0] = 1;
+          for (std::size_t i = 1; i != N; ++i)
+            s.strides[i] = s.strides[i - 1] * s.extents[i - 1];
+        } else {
+          s.strides[N - 1] = 1;
+          for (std::size_t i = N - 1; i != 0; --i)
+            s.strides[i - 1] = s.strides[i] * s.extents[i];
+        }
+        return s;
+      }
+
+    // Write the elements of m to os in row-major order. Contiguous
+    // row-major matrices are written directly; others are copied through a
+    // buffer. The elements are visited by index through a matrix_ref, since
+    // the iterators of a column-major matrix walk its columns.
+    template <typename M>
+      bool
+      write_elements(std::ostream& os, const M& m)
+      {
+        using T = Value_type<M>;
+        const auto s = merge_inner_extents(m.descriptor());
+        if (s.extents[M::order - 1] == s.size && s.strides[M::order - 1] == 1) {
+          os.write(reinterpret_cast<const char*>(m.data() + s.start),
+                   s.size * sizeof(T));
+          return bool(os);
+        }
+
+        std::vector<T> buf;
+        buf.reserve(std::min(s.size, std::size_t(1) << 16));
+        const matrix_ref<const T, M::order> r(m.descriptor(), m.data());
+        for (const auto& x : r) {
+          buf.push_back(x);
+          if (buf.size() == buf.capacity()) {
+            os.write(reinterpret_cast<const char*>(buf.data()),
+                     buf.size() * sizeof(T));
+            buf.clear();
+          }
+        }
+        os.write(reinterpret_cast<const char*>(buf.data()),
+                 buf.size() * sizeof(T));
+        return bool(os);
+      }
+
+  } // namespace matrix_impl
+
+
+  // Write matrix
+  //
+  // Write the matrix m to os in the matrix format. The stream should be
+  // opened in binary mode.
+  template <typename M>
+    bool
+    write_matrix(std::ostream& os, const M& m)
+    {
+      using T = Value_type<M>;
+      const auto s = m.descriptor();
+      return matrix_impl::write_header(os, matrix_impl::element_kind<T>(),
+                                       sizeof(T), M::order, s.extents)
+          && matrix_impl::write_elements(os, m);
+    }
+
+
+  // Write npy
+  //
+  // Write the matrix m to os in the NumPy array format. The stream should be
+  // opened in binary mode.
+  template <typename M>
+    bool
+    write_npy(std::ostream& os, const M& m)
+    {
+      using T = Value_type<M>;
+      const auto s = m.descriptor();
+      return matrix_impl::write_npy_header(os, matrix_impl::element_kind<T>(),
+                                           sizeof(T), M::order, s.extents)
+          && matrix_impl::write_elements(os, m);
+    }
+
+
+  // Read matrix
+  //
+  // Read a matrix in either the matrix or npy format from is into m. Returns
+  // false if the input is malformed or does not describe an N-dimensional
+  // matrix of T.
+  template <typename T, std::size_t N>
+    bool
+    read_matrix(std::istream& is, matrix<T, N>& m)
+    {
+      matrix_impl::file_header h;
+      if (!matrix_impl::read_header(is, h)
+          || !matrix_impl::header_matches<T, N>(h))
+        return false;
+
+      const matrix_slice<N> s = matrix_impl::header_slice<N>(h);
+      matrix<T, N> tmp(matrix_slice<N>(0, s.extents));
+      is.read(reinterpret_cast<char*>(tmp.data()), s.size * sizeof(T));
+      if (std::size_t(is.gcount()) != s.size * sizeof(T))
+        return false;
+
+      // Column-major elements were read into the buffer in storage order.
+      // Copy them through a view to make them row-major.
+      if (h.column_major && N > 1) {
+        matrix_ref<const T, N> r(s, tmp.data());
+        m = matrix<T, N>(r);
+      } else {
+        m = std::move(tmp);
+      }
+      return true;
+    }
+
+
+  // Save and load
+  //
+  // Write the matrix m to the file at path in the matrix or npy format, or
+  // read either format from the file at path into m.
+  template <typename M>
+    bool
+    save_matrix(const std::string& path, const M& m)
+    {
+      std::ofstream os(path, std::ios::binary);
+      return os && write_matrix(os, m) && os.flush();
+    }
+
+  template <typename M>
+    bool
+    save_npy(const std::string& path, const M& m)
+    {
+      std::ofstream os(path, std::ios::binary);
+      return os && write_npy(os, m) && os.flush();
+    }
+
+  template <typename T, std::size_t N>
+    bool
+    load_matrix(const std::string& path, matrix<T, N>& m)
+    {
+      std::ifstream is(path, std::ios::binary);
+      return is && read_matrix(is, m);
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                              Mapped Files
+  //
+  // A mapped file is a read-only memory mapping of an entire file. Mapped
+  // files are movable but not copyable. The mapping is released when the
+  // object is destroyed.
+  class mapped_file
+  {
+  public:
+    mapped_file() : ptr(nullptr), len(0) { }
+    ~mapped_file() { close(); }
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    mapped_file(mapped_file&& x) : ptr(x.ptr), len(x.len)
+    {
+      x.ptr = nullptr;
+      x.len = 0;
+    }
+
+    mapped_file& operator=(mapped_file&& x)
+    {
+      if (this != &x) {
+        close();
+        ptr = x.ptr;
+        len = x.len;
+        x.ptr = nullptr;
+        x.len = 0;
+      }
+      return *this;
+    }
+
+    // Map the file at path, releasing any current mapping. Returns false if
+    // the file cannot be opened or mapped.
+    bool open(const std::string& path);
+
+    // Release the mapping.
+    void close();
+
+    bool is_open() const { return ptr != nullptr; }
+
+    const char* data() const { return static_cast<const char*>(ptr); }
+    std::size_t size() const { return len; }
+
+  private:
+    void* ptr;
+    std::size_t len;
+  };
+
+
+  // ------------------------------------------------------------------------ //
+  //                              Mapped Matrix
+  //
+  // A mapped matrix maps a file in the matrix or npy format and provides a
+  // constant reference to its elements. Opening a mapped matrix reads only
+  // the header; the elements are paged in by the operating system as they
+  // are accessed. Column-major npy files are described by a column-major
+  // slice rather than being copied.
+  //
+  // The references returned by a mapped matrix are valid until it is closed
+  // or destroyed.
+  template <typename T, std::size_t N>
+    class mapped_matrix
+    {
+    public:
+      mapped_matrix() : desc(), elems(nullptr) { }
+
+      // Map the file at path. Returns false if the file cannot be mapped,
+      // is malformed, is truncated, or does not describe an N-dimensional
+      // matrix of T.
+      bool open(const std::string& path)
+      {
+        close();
+        if (!file.open(path))
+          return false;
+
+        matrix_impl::file_header h;
+        std::size_t n = matrix_impl::header_length(file.data(), file.size());
+        if (n == 0 || n > file.size()
+            || !matrix_impl::parse_header(file.data(), n, h)
+            || !matrix_impl::header_matches<T, N>(h)
+            || h.offset % alignof(T) != 0) {
+          file.close();
+          return false;
+        }
+
+        matrix_slice<N> s = matrix_impl::header_slice<N>(h);
+        if (s.size > (file.size() - h.offset) / sizeof(T)) {
+          file.close();
+          return false;
+        }
+        desc = s;
+        elems = reinterpret_cast<const T*>(file.data() + h.offset);
+        return true;
+      }
+
+      void close()
+      {
+        file.close();
+        elems = nullptr;
+      }
+
+      bool is_open() const { return elems != nullptr; }
+
+      // Returns a reference to the mapped elements.
+      matrix_ref<const T, N> ref() const { return {desc, elems}; }
+      operator matrix_ref<const T, N>() const { return ref(); }
+
+      const matrix_slice<N>& descriptor() const { return desc; }
+      std::size_t extent(std::size_t n) const { return desc.extents[n]; }
+      std::size_t size() const { return desc.size; }
+
+    private:
+      mapped_file file;
+      matrix_slice<N> desc;
+      const T* elems;
+    };
+
+
+  // ------------------------------------------------------------------------ //
+  //                            Text Matrix I/O
+  //
+  // A text matrix has one row per line. The elements of a row are separated
+  // by commas, whitespace, or both, so both CSV and whitespace-delimited
+  // files can be read. Blank lines and lines beginning with '#' are
+  // ignored. Every row must have the same number of elements.
+  //
+  // Large inputs are split into chunks at line boundaries, and the chunks
+  // are parsed concurrently. Numbers are converted with the strto* family of
+  // functions, which use the C locale's decimal point.
+
+  namespace matrix_impl
+  {
+    // The minimum number of characters parsed by each thread.
+    constexpr std::size_t parse_grain = 1 << 20;
+
+    // Parse a number beginning at p, storing the value in x and the end of
+    // the number in e. Returns false if p does not begin a number or the
+    // number is not representable as a T.
+    inline bool
+    parse_number(const char* p, const char*& e, float& x)
+    {
+      char* q;
+      errno = 0;
+      x = std::strtof(p, &q);
+      e = q;
+      return e != p && errno != ERANGE;
+    }
+
+    inline bool
+    parse_number(const char* p, const char*& e, double& x)
+    {
+      char* q;
+      errno = 0;
+      x = std::strtod(p, &q);
+      e = q;
+      return e != p && errno != ERANGE;
+    }
+
+    inline bool
+    parse_number(const char* p, const char*& e, long double& x)
+    {
+      char* q;
+      errno = 0;
+      x = std::strtold(p, &q);
+      e = q;
+      return e != p && errno != ERANGE;
+    }
+
+    template <typename T>
+      Requires<std::is_integral<T>::value && std::is_signed<T>::value, bool>
+      parse_number(const char* p, const char*& e, T& x)
+      {
+        char* q;
+        errno = 0;
+        long long v = std::strtoll(p, &q, 10);
+        e = q;
+        if (e == p || errno == ERANGE)
+          return false;
+        if (v < std::numeric_limits<T>::min() || v > std::numeric_limits<T>::max())
+          return false;
+        x = T(v);
+        return true;
+      }
+
+    template <typename T>
+      Requires<std::is_integral<T>::value && !std::is_signed<T>::value, bool>
+      parse_number(const char* p, const char*& e, T& x)
+      {
+        // strtoull accepts (and negates) a leading minus sign.
+        if (*p == '-')
+          return false;
+        char* q;
+        errno = 0;
+        unsigned long long v = std::strtoull(p, &q, 10);
+        e = q;
+        if (e == p || errno == ERANGE || v > std::numeric_limits<T>::max())
+          return false;
+        x = T(v);
+        return true;
+      }
+
+    inline const char*
+    skip_blanks(const char* p, const char* last)
+    {
+      while (p != last && (*p == ' ' || *p == '\t' || *p == '\r'))
+        ++p;
+      return p;
+    }
+
+
+    // The elements and shape of the rows parsed from one chunk of text.
+    template <typename T>
+      struct text_rows
+      {
+        text_rows() : rows(0), cols(0), ok(true) { }
+
+        std::vector<T> elems;
+        std::size_t rows;
+        std::size_t cols;
+        bool ok;
+      };
+
+    // Parse the lines in [first, last), appending their elements to r. The
+    // character at last must not be part of a number (e.g., a newline or the
+    // terminating null character of a string).
+    template <typename T>
+      void
+      parse_rows(const char* first, const char* last, text_rows<T>& r)
+      {
+        while (first != last) {
+          const char* eol = static_cast<const char*>(
+            std::memchr(first, '\n', last - first));
+          if (!eol)
+            eol = last;
+
+          const char* p = skip_blanks(first, eol);
+          first = eol == last ? last : eol + 1;
+          if (p == eol || *p == '#')
+            continue;
+
+          std::size_t n = 0;
+          while (true) {
+            T x;
+            const char* e;
+            if (!parse_number(p, e, x) || e > eol) {
+              r.ok = false;
+              return;
+            }
+            r.elems.push_back(x);
+            ++n;
+
+            // A number is followed by the end of the line, or by a comma
+            // and/or whitespace and then another number.
+            p = skip_blanks(e, eol);
+            if (p == eol)
+              break;
+            if (*p == ',') {
+              p = skip_blanks(p + 1, eol);
+              if (p == eol) {
+                r.ok = false;
+                return;
+              }
+            } else if (p == e) {
+              r.ok = false;
+              return;
+            }
+          }
+
+          if (r.rows != 0 && n != r.cols) {
+            r.ok = false;
+            return;
+          }
+          r.cols = n;
+          ++r.rows;
+        }
+      }
+
+  } // namespace matrix_impl
+
+
+  // Parse text
+  //
+  // Parse the text matrix in text into m. Returns false if the text is
+  // malformed, in which case m is not modified.
+  template <typename T>
+    bool
+    parse_text(const std::string& text, matrix<T, 2>& m)
+    {
+      const char* const first = text.data();
+      const std::size_t n = text.size();
+
+      // Choose the chunk boundaries: each chunk after the first starts at the
+      // beginning of a line.
+      std::size_t chunks = std::max(std::min(matrix_impl::concurrency(),
+                                             n / matrix_impl::parse_grain),
+                                    std::size_t(1));
+      std::vector<std::size_t> bounds(chunks + 1, n);
+      bounds[0] = 0;
+      for (std::size_t c = 1; c < chunks; ++c) {
+        std::size_t b = std::max(c * (n / chunks), bounds[c - 1]);
+        while (b != n && text[b - 1] != '\n')
+          ++b;
+        bounds[c] = b;
+      }
+
+      std::vector<matrix_impl::text_rows<T>> parts(chunks);
+      matrix_impl::parallel_for(chunks, 1, [&](std::size_t lo, std::size_t hi) {
+        for (std::size_t c = lo; c != hi; ++c)
+          matrix_impl::parse_rows(first + bounds[c], first + bounds[c + 1], parts[c]);
+      });
+
+      std::size_t rows = 0;
+      std::size_t cols = 0;
+      for (const auto& r : parts) {
+        if (!r.ok)
+          return false;
+        if (r.rows == 0)
+          continue;
+        if (rows != 0 && r.cols != cols)
+          return false;
+        rows += r.rows;
+        cols = r.cols;
+      }
+
+      matrix<T, 2> result(rows, cols);
+      T* out = result.data();
+      for (const auto& r : parts)
+        out = std::copy(r.elems.begin(), r.elems.end(), out);
+      m = std::move(result);
+      return true;
+    }
+
+
+  // Read text
+  //
+  // Read the remainder of is as a text matrix into m, or the text matrix in
+  // the file at path.
+  template <typename T>
+    bool
+    read_text(std::istream& is, matrix<T, 2>& m)
+    {
+      std::string text {std::istreambuf_iterator<char>(is),
+                        std::istreambuf_iterator<char>()};
+      return !is.bad() && parse_text(text, m);
+    }
+
+  template <typename T>
+    bool
+    load_text(const std::string& path, matrix<T, 2>& m)
+    {
+      std::ifstream is(path, std::ios::binary);
+      if (!is || !is.seekg(0, std::ios::end))
+        return false;
+      std::string text(std::size_t(is.tellg()), '\0');
+      is.seekg(0);
+      if (!is.read(&text[0], text.size()))
+        return false;
+      return parse_text(text, m);
+    }
+
+} // namespace origin
+
+#endif
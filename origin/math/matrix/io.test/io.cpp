@@ -0,0 +1,241 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+
+#include <origin/math/matrix/io.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Tests for binary matrix I/O.
+
+void test_matrix_format()
+{
+  matrix<double, 2> m {
+    {1, 2, 3},
+    {4, 5, 6}
+  };
+
+  stringstream ss;
+  assert(write_matrix(ss, m));
+  assert(ss.str().size() == 64 + 6 * sizeof(double));
+
+  matrix<double, 2> r;
+  assert(read_matrix(ss, r));
+  assert(r == m);
+
+  // Non-contiguous views are written in row-major order.
+  stringstream st;
+  assert(write_matrix(st, transpose(m)));
+  assert(read_matrix(st, r));
+  assert(same_extents(r, transpose(m)));
+  assert(r == transpose(m));
+
+  // The element type and order must match.
+  stringstream s1(ss.str());
+  matrix<float, 2> f;
+  assert(!read_matrix(s1, f));
+  stringstream s2(ss.str());
+  matrix<double, 3> c;
+  assert(!read_matrix(s2, c));
+
+  // Truncated input fails.
+  stringstream s3(ss.str().substr(0, 80));
+  assert(!read_matrix(s3, r));
+}
+
+void test_npy_format()
+{
+  matrix<int, 1> v {1, 2, 3, 4, 5};
+  stringstream ss;
+  assert(write_npy(ss, v));
+
+  string s = ss.str();
+  assert(s.compare(0, 6, "\x93NUMPY") == 0);
+  assert((s.size() - 5 * sizeof(int)) % 64 == 0);
+  assert(s.find("{'descr': '<i4', 'fortran_order': False, 'shape': (5,), }")
+         != string::npos);
+
+  matrix<int, 1> r;
+  assert(read_matrix(ss, r));
+  assert(r == v);
+}
+
+// Build an npy file by hand, storing the matrix in column-major order.
+string fortran_npy()
+{
+  string dict = "{'descr': '<f8', 'fortran_order': True, 'shape': (2, 3), }";
+  dict.resize(128 - 10 - 1, ' ');
+  dict += '\n';
+  string s = "\x93NUMPY";
+  s += char(1);
+  s += char(0);
+  s += char(dict.size() & 0xff);
+  s += char(dict.size() >> 8);
+  s += dict;
+  double elems[] {1, 4, 2, 5, 3, 6};
+  s.append(reinterpret_cast<const char*>(elems), sizeof(elems));
+  return s;
+}
+
+void test_fortran_order()
+{
+  matrix<double, 2> m {
+    {1, 2, 3},
+    {4, 5, 6}
+  };
+  stringstream ss(fortran_npy());
+  matrix<double, 2> r;
+  assert(read_matrix(ss, r));
+  assert(r == m);
+  assert(r.descriptor().strides[1] == 1);
+}
+
+void test_column_major()
+{
+  matrix<double, 2> m {
+    {1, 2, 3},
+    {4, 5, 6}
+  };
+  matrix<double, 2> c(m, matrix_layout::column_major);
+
+  // Column-major matrices are written in row-major order in both formats.
+  stringstream s1;
+  assert(write_matrix(s1, c));
+  matrix<double, 2> r;
+  assert(read_matrix(s1, r));
+  assert(r == m);
+
+  stringstream s2;
+  assert(write_npy(s2, c));
+  assert(s2.str().find("'fortran_order': False") != string::npos);
+  assert(read_matrix(s2, r));
+  assert(r == m);
+}
+
+void test_mapped()
+{
+  matrix<float, 3> m(4, 5, 6);
+  iota(m.begin(), m.end(), 0.0f);
+
+  const char* path = "origin.math.matrix.io.test.mat";
+  const char* npy = "origin.math.matrix.io.test.npy";
+  const char* fnpy = "origin.math.matrix.io.test.f.npy";
+  assert(save_matrix(path, m));
+  assert(save_npy(npy, m));
+
+  matrix<float, 3> r;
+  assert(load_matrix(path, r));
+  assert(r == m);
+  assert(load_matrix(npy, r));
+  assert(r == m);
+
+  {
+    mapped_matrix<float, 3> x;
+    assert(x.open(path));
+    matrix_ref<const float, 3> a = x;
+    assert(same_extents(a, m));
+    assert(a == m);
+    assert(sum(a) == sum(m));
+
+    mapped_matrix<float, 3> y;
+    assert(y.open(npy));
+    assert(y.ref() == m);
+
+    // A mapped file cannot be viewed with a different element type.
+    mapped_matrix<int, 3> z;
+    assert(!z.open(path));
+    assert(!z.is_open());
+  }
+
+  // Column-major files are mapped as column-major views.
+  {
+    ofstream os(fnpy, ios::binary);
+    string s = fortran_npy();
+    os.write(s.data(), s.size());
+  }
+  {
+    mapped_matrix<double, 2> x;
+    assert(x.open(fnpy));
+    assert(x.descriptor().strides[0] == 1);
+    matrix<double, 2> expect {
+      {1, 2, 3},
+      {4, 5, 6}
+    };
+    assert(x.ref() == expect);
+  }
+
+  mapped_matrix<float, 3> missing;
+  assert(!missing.open("origin.math.matrix.io.test.missing"));
+
+  remove(path);
+  remove(npy);
+  remove(fnpy);
+}
+
+// Returns a matrix format header of 2 x 2^32 x 2^32 doubles, whose size
+// overflows.
+string overflowing_header()
+{
+  string s(64, '\0');
+  s.replace(0, 4, "OMAT");
+  s[4] = 1;
+  s[5] = 'f';
+  s[6] = 8;
+  s[7] = 2;
+  s[8 + 4] = 1;        // 2^32 in little-endian order
+  s[16 + 4] = 1;
+  return s;
+}
+
+void test_malformed()
+{
+  matrix<double, 2> r;
+  stringstream s1(overflowing_header());
+  assert(!read_matrix(s1, r));
+
+  // The npy shape is checked the same way, and so are its digits.
+  for (string shape : {"(4294967296, 4294967296)", "(99999999999999999999999, 1)"}) {
+    string dict = "{'descr': '<f8', 'fortran_order': False, 'shape': " + shape + ", }";
+    dict.resize(128 - 10 - 1, ' ');
+    dict += '\n';
+    string s = "\x93NUMPY";
+    s += char(1);
+    s += char(0);
+    s += char(dict.size() & 0xff);
+    s += char(dict.size() >> 8);
+    s += dict;
+    stringstream ss(s);
+    assert(!read_matrix(ss, r));
+  }
+
+  const char* path = "origin.math.matrix.io.test.bad";
+  {
+    ofstream os(path, ios::binary);
+    string s = overflowing_header();
+    os.write(s.data(), s.size());
+  }
+  matrix<double, 2> m;
+  assert(!load_matrix(path, m));
+  mapped_matrix<double, 2> x;
+  assert(!x.open(path));
+  assert(!x.is_open());
+  remove(path);
+}
+
+int main()
+{
+  test_matrix_format();
+  test_npy_format();
+  test_fortran_order();
+  test_column_major();
+  test_mapped();
+  test_malformed();
+}
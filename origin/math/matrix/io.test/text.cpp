@@ -0,0 +1,115 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <iostream>
+#include <sstream>
+
+#include <origin/math/matrix/io.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Tests for text matrix I/O.
+
+void test_parse()
+{
+  matrix<double, 2> expect {
+    {1, 2.5, -3},
+    {4e2, 5, 6}
+  };
+
+  matrix<double, 2> m;
+  assert(parse_text("1,2.5,-3\n4e2,5,6\n", m));
+  assert(m == expect);
+
+  // Whitespace separated, with blank lines, comments, and no final newline.
+  assert(parse_text("# comment\n  1 2.5\t-3\r\n\n4e2   5 6", m));
+  assert(m == expect);
+
+  // Mixed separators.
+  assert(parse_text("1, 2.5 , -3\n4e2 ,5, 6\n", m));
+  assert(m == expect);
+
+  matrix<int, 2> i;
+  assert(parse_text("1 2\n3 4\n", i));
+  assert(i.rows() == 2 && i.cols() == 2 && i(1, 0) == 3);
+
+  assert(parse_text("", m));
+  assert(m.size() == 0);
+}
+
+void test_errors()
+{
+  matrix<int, 2> m {
+    {1, 2}
+  };
+  assert(!parse_text("1 2\n3\n", m));       // Ragged rows
+  assert(!parse_text("1 2\n3 x\n", m));     // Not a number
+  assert(!parse_text("1 2,\n3 4\n", m));    // Trailing comma
+  assert(!parse_text("1,,2\n", m));         // Empty field
+  assert(!parse_text("1 2.5\n", m));        // Not an integer
+  assert(!parse_text("1 99999999999\n", m)); // Out of range
+
+  matrix<unsigned, 2> u;
+  assert(!parse_text("1 -2\n", u));
+
+  // The target is not modified on failure.
+  assert(m.rows() == 1 && m(0, 1) == 2);
+}
+
+// Large inputs are parsed in parallel chunks.
+void test_large()
+{
+  const size_t rows = 300000;
+  string text;
+  for (size_t r = 0; r < rows; ++r) {
+    text += to_string(r);
+    text += ',';
+    text += to_string(r % 7);
+    text += ",0.25\n";
+  }
+
+  matrix<double, 2> m;
+  assert(parse_text(text, m));
+  assert(m.rows() == rows && m.cols() == 3);
+  for (size_t r = 0; r < rows; ++r)
+    assert(m(r, 0) == r && m(r, 1) == r % 7 && m(r, 2) == 0.25);
+
+  stringstream ss(text);
+  matrix<double, 2> n;
+  assert(read_text(ss, n));
+  assert(n == m);
+}
+
+// Printed matrices can be parsed.
+void test_round_trip()
+{
+  matrix<int, 2> m {
+    {1, -2, 3},
+    {4, 5, -6}
+  };
+  stringstream ss;
+  ss << pretty(m);
+  string s = ss.str();
+  for (char& c : s)
+    if (c == '[' || c == ']')
+      c = ' ';
+  for (size_t p = s.find(",\n"); p != string::npos; p = s.find(",\n"))
+    s.erase(p, 1);
+
+  matrix<int, 2> r;
+  assert(parse_text(s, r));
+  assert(r == m);
+}
+
+int main()
+{
+  test_parse();
+  test_errors();
+  test_large();
+  test_round_trip();
+}
@@ -10,9 +10,23 @@
 
 
 #include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <exception>
+#include <ostream>
+#include <limits>
+#include <locale>
+#include <memory>
+#include <new>
 #include <numeric>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 #include <origin/type/concepts.hpp>
 #include <origin/type/typestr.hpp>
@@ -23,8 +37,9 @@ namespace origin
   // Declarations
   struct slice;
   template <std::size_t N> class matrix_slice;
-  template <typename T, std::size_t N> class matrix;
+  template <typename T, std::size_t N, typename A = std::allocator<T>> class matrix;
   template <typename T, std::size_t N> class matrix_ref;
+  template <typename T, std::size_t R, std::size_t C> class static_matrix;
 
 
 // Type traits implementations
@@ -62,13 +77,29 @@ namespace origin
 #include "matrix.impl/slice.hpp"
 #include "matrix.impl/iterator.hpp"
 #include "matrix.impl/support.hpp"
+#include "matrix.impl/parallel.hpp"
+#include "matrix.impl/pool.hpp"
+#include "matrix.impl/precision.hpp"
+#include "matrix.impl/kernel.hpp"
+#include "matrix.impl/format.hpp"
 
 // Matrix classes
 #include "matrix.impl/matrix.hpp"
 #include "matrix.impl/matrix_ref.hpp"
+#include "matrix.impl/static_matrix.hpp"
+#include "matrix.impl/view.hpp"
+#include "matrix.impl/cursor.hpp"
 
 // Arithmetic and linear operations
 #include "matrix.impl/operations.hpp"
+#include "matrix.impl/reduce.hpp"
+#include "matrix.impl/random.hpp"
+#include "matrix.impl/batch.hpp"
+#include "matrix.impl/lu.hpp"
+#include "matrix.impl/packed.hpp"
+#include "matrix.impl/spectral.hpp"
+#include "matrix.impl/contract.hpp"
+#include "matrix.impl/stencil.hpp"
 
 
 } // namespace origin
@@ -0,0 +1,190 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+
+// -------------------------------------------------------------------------- //
+// Batched operations                                            [matrix.batch]
+//
+// A batch is a 3D matrix whose leading extent enumerates a sequence of
+// same-shaped 2D matrices. For example, a matrix<double, 3> with extents
+// (b, m, n) holds b matrices of m rows and n columns.
+//
+// The batched operations apply a 2D operation to every matrix in a batch.
+// The matrices in a batch are processed in parallel, and the inner kernels
+// are specialized for the very small matrices that are typically batched.
+
+
+namespace matrix_impl
+{
+  // Returns a block describing the kth matrix in the 3D slice s of the
+  // elements pointed to by p.
+  template <typename T>
+    inline block<T>
+    batch_block(T* p, const matrix_slice<3>& s, std::size_t k)
+    {
+      return {p + s.start + k * s.strides[0], s.strides[1], s.strides[2]};
+    }
+
+  // Returns the number of matrices in a batch that should be assigned to each
+  // thread, given the approximate cost of each operation. Batches are only
+  // split when each thread is given a meaningful amount of work.
+  inline std::size_t
+  batch_grain(std::size_t cost)
+  {
+    constexpr std::size_t min_work = 1 << 15;
+    return std::max(min_work / std::max(cost, std::size_t(1)), std::size_t(1));
+  }
+
+} // namespace matrix_impl
+
+
+// Batch for each
+//
+// Call f(m[k]) for each matrix m[k] in the batch m. Calls to f for different
+// matrices may be evaluated concurrently.
+template <typename M, typename F>
+  void
+  batch_for_each(M& m, F f)
+  {
+    static_assert(M::order == 3, "");
+    const std::size_t cost = m.extent(1) * m.extent(2);
+    matrix_impl::parallel_for(m.extent(0), matrix_impl::batch_grain(cost),
+      [&](std::size_t first, std::size_t last) {
+        for (std::size_t k = first; k != last; ++k)
+          f(m[k]);
+      });
+  }
+
+
+// Batch transform
+//
+// Assign op(a(k, i, j), b(k, i, j)) to out(k, i, j) for every element in the
+// batches a, b and out, which must have the same extents.
+template <typename M1, typename M2, typename M3, typename Op>
+  void
+  batch_transform(const M1& a, const M2& b, M3& out, Op op)
+  {
+    static_assert(M1::order == 3, "");
+    static_assert(M2::order == 3, "");
+    static_assert(M3::order == 3, "");
+    assert(same_extents(a, b));
+    assert(same_extents(a, out));
+
+    const std::size_t m = a.extent(1);
+    const std::size_t n = a.extent(2);
+    matrix_impl::parallel_for(a.extent(0), matrix_impl::batch_grain(m * n),
+      [&](std::size_t first, std::size_t last) {
+        for (std::size_t k = first; k != last; ++k) {
+          auto x = matrix_impl::batch_block(a.data(), a.descriptor(), k);
+          auto y = matrix_impl::batch_block(b.data(), b.descriptor(), k);
+          auto z = matrix_impl::batch_block(out.data(), out.descriptor(), k);
+          for (std::size_t i = 0; i != m; ++i)
+            for (std::size_t j = 0; j != n; ++j)
+              z(i, j) = op(x(i, j), y(i, j));
+        }
+      });
+  }
+
+
+// Batch product
+//
+// Accumulate the matrix product a[k] * b[k] into out[k] for each matrix in
+// the batches. If a has extents (b, m, p), then b must have extents (b, p, n)
+// and out must have extents (b, m, n).
+//
+// Products with an inner extent of at most 4 are computed by a completely
+// unrolled kernel.
+template <typename M1, typename M2, typename M3>
+  void
+  batch_product(const M1& a, const M2& b, M3& out)
+  {
+    static_assert(M1::order == 3, "");
+    static_assert(M2::order == 3, "");
+    static_assert(M3::order == 3, "");
+    assert(a.extent(0) == b.extent(0) && a.extent(0) == out.extent(0));
+    assert(a.extent(2) == b.extent(1));
+    assert(a.extent(1) == out.extent(1));
+    assert(b.extent(2) == out.extent(2));
+
+    const std::size_t m = a.extent(1);
+    const std::size_t n = b.extent(2);
+    const std::size_t p = a.extent(2);
+    matrix_impl::parallel_for(a.extent(0), matrix_impl::batch_grain(m * n * p),
+      [&](std::size_t first, std::size_t last) {
+        for (std::size_t k = first; k != last; ++k)
+          matrix_impl::small_or_product(m, n, p,
+            matrix_impl::batch_block(a.data(), a.descriptor(), k),
+            matrix_impl::batch_block(b.data(), b.descriptor(), k),
+            matrix_impl::batch_block(out.data(), out.descriptor(), k));
+      });
+  }
+
+// Returns the batch of products a[k] * b[k].
+template <typename T>
+  inline matrix<T, 3>
+  batch_product(const matrix<T, 3>& a, const matrix<T, 3>& b)
+  {
+    matrix<T, 3> result(a.extent(0), a.extent(1), b.extent(2));
+    batch_product(a, b, result);
+    return result;
+  }
+
+
+// Batch solve
+//
+// Solve the linear systems a[k] x[k] = b[k] for each matrix in the batch a,
+// overwriting b[k] with x[k]. The batch a has extents (b, n, n). The
+// right-hand sides are either a 2D matrix with extents (b, n), giving one
+// vector per system, or a 3D matrix with extents (b, n, r), giving r
+// vectors per system. The matrices in a are not modified.
+//
+// Returns false if any a[k] is singular. The corresponding b[k] are left
+// in an unspecified state.
+template <typename M1, typename M2>
+  bool
+  batch_solve(const M1& a, M2& b)
+  {
+    static_assert(M1::order == 3, "");
+    static_assert(M2::order == 2 || M2::order == 3, "");
+    using T = Value_type<M1>;
+
+    const std::size_t n = a.extent(1);
+    const std::size_t r = M2::order == 3 ? b.extent(M2::order - 1) : 1;
+    assert(a.extent(2) == n);
+    assert(b.extent(0) == a.extent(0) && b.extent(1) == n);
+
+    const auto& bd = b.descriptor();
+    std::atomic<bool> ok(true);
+    matrix_impl::parallel_for(a.extent(0), matrix_impl::batch_grain(n * n * n),
+      [&](std::size_t first, std::size_t last) {
+        // Each thread factors into its own workspace, which is reused for
+        // every system in its chunk.
+        std::vector<T> lu(n * n);
+        std::vector<std::size_t> piv(n);
+        matrix_impl::block<T> f {lu.data(), n, 1};
+        for (std::size_t k = first; k != last; ++k) {
+          auto x = matrix_impl::batch_block(a.data(), a.descriptor(), k);
+          for (std::size_t i = 0; i != n; ++i)
+            for (std::size_t j = 0; j != n; ++j)
+              f(i, j) = x(i, j);
+          if (!matrix_impl::lu_factor(n, f, piv.data())) {
+            ok = false;
+            continue;
+          }
+          std::size_t cs = M2::order == 3 ? bd.strides[M2::order - 1] : 0;
+          matrix_impl::block<Value_type<M2>> y {
+            b.data() + bd.start + k * bd.strides[0], bd.strides[1], cs
+          };
+          matrix_impl::lu_solve(n, r, f, piv.data(), y);
+        }
+      });
+    return ok;
+  }
@@ -0,0 +1,356 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+
+// -------------------------------------------------------------------------- //
+// Tensor contraction                                         [matrix.contract]
+//
+// A contraction of two N-dimensional matrices is described by an einsum
+// specification that labels the dimensions of each operand and of the
+// result with letters. For example, the matrix product is written
+//
+//    einsum("ik,kj->ij", a, b, c);
+//
+// Every label of the result must label a dimension of an operand. A label
+// that appears in both operands and in the result is a batch dimension, and
+// a label that appears in both operands but not in the result is summed
+// over. For example, "bik,bkj->bij" is a batched matrix product and
+// "ijk,jkl->il" contracts two dimensions at once. Labels may not be repeated
+// within an operand, and every label of an operand must appear in the other
+// operand or in the result.
+//
+// The contraction is computed as a sequence of matrix products: the labels
+// are grouped into the rows, columns and inner dimension of a product, and
+// the operands are viewed as 2D blocks over those groups. When the
+// dimensions of a group are not adjacent in memory, the operand is first
+// packed into a contiguous matrix. Large products use the cache-blocked
+// kernel (see matrix_impl::blocked_product).
+
+
+namespace matrix_impl
+{
+  constexpr bool
+  is_label(char c)
+  {
+    return ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z');
+  }
+
+  // Returns the number of labels at the front of s.
+  constexpr std::size_t
+  count_labels(const char* s)
+  {
+    return is_label(*s) ? 1 + count_labels(s + 1) : 0;
+  }
+
+  // Returns true if c is one of the first n characters of s.
+  constexpr bool
+  has_label(const char* s, std::size_t n, char c)
+  {
+    return n != 0 && (*s == c || has_label(s + 1, n - 1, c));
+  }
+
+  // Returns true if the n labels at s are distinct.
+  constexpr bool
+  distinct_labels(const char* s, std::size_t n)
+  {
+    return n == 0 || (!has_label(s + 1, n - 1, *s) && distinct_labels(s + 1, n - 1));
+  }
+
+  // Returns true if each of the n labels at s is one of the first m labels
+  // of t or the first k labels of u.
+  constexpr bool
+  labels_found(const char* s, std::size_t n,
+               const char* t, std::size_t m,
+               const char* u, std::size_t k)
+  {
+    return n == 0
+        || ((has_label(t, m, *s) || has_label(u, k, *s))
+            && labels_found(s + 1, n - 1, t, m, u, k));
+  }
+
+  // Check the labels of the operands a and b and of the result r.
+  constexpr bool
+  einsum_check(const char* a, std::size_t na,
+               const char* b, std::size_t nb,
+               const char* r, std::size_t nr)
+  {
+    return distinct_labels(a, na) && distinct_labels(b, nb)
+        && distinct_labels(r, nr)
+        && labels_found(r, nr, a, na, b, nb)
+        && labels_found(a, na, b, nb, r, nr)
+        && labels_found(b, nb, a, na, r, nr);
+  }
+
+
+  // One labeled dimension of a contraction. The extent is the same in each
+  // operand that has the dimension; its stride in operands that do not is 0.
+  struct contraction_dim
+  {
+    char label;
+    std::size_t extent;
+    std::size_t stride[3];
+    std::size_t pos[3];
+    bool used[3];
+  };
+
+  // The dimensions of a contraction of the operands a and b into c, grouped
+  // into the dimensions of a sequence of matrix products. Operand k (0 for
+  // a, 1 for b and 2 for c) is viewed as a sequence of 2D blocks:
+  //
+  //    a: batch x (rows x inner)
+  //    b: batch x (inner x cols)
+  //    c: batch x (rows x cols)
+  //
+  // The rows, columns and batch dimensions are ordered as in c, and the
+  // inner dimensions as in a, so that the groups of each operand are
+  // adjacent in memory when they are adjacent in the operand.
+  class contraction
+  {
+    using group = std::vector<std::size_t>;
+
+  public:
+    template <std::size_t N1, std::size_t N2, std::size_t N3>
+      contraction(const char* spec,
+                  const matrix_slice<N1>& a,
+                  const matrix_slice<N2>& b,
+                  const matrix_slice<N3>& c)
+      {
+        add(spec, a, 0);
+        add(spec + N1 + 1, b, 1);
+        add(spec + N1 + N2 + 3, c, 2);
+        start[0] = a.start;
+        start[1] = b.start;
+        start[2] = c.start;
+
+        for (std::size_t d = 0; d != dims.size(); ++d) {
+          const bool* u = dims[d].used;
+          if (u[0] && u[1])
+            (u[2] ? batch : inner).push_back(d);
+          else
+            (u[0] ? rows : cols).push_back(d);
+        }
+        by_result(rows);
+        by_result(cols);
+        by_result(batch);
+      }
+
+    // Accumulate the contraction of a and b into c.
+    template <typename T, typename U, typename V>
+      void
+      run(const T* a, const U* b, V* c) const
+      {
+        const std::size_t m = extent(rows);
+        const std::size_t n = extent(cols);
+        const std::size_t p = extent(inner);
+
+        // Try to view each operand as a strided block. Otherwise, compute
+        // the offsets of its rows and columns for packing.
+        block<const T> ab {nullptr, 0, 0};
+        block<const U> bb {nullptr, 0, 0};
+        block<V> cb {nullptr, 0, 0};
+        const bool fa = fuse(rows, 0, ab.rs) && fuse(inner, 0, ab.cs);
+        const bool fb = fuse(inner, 1, bb.rs) && fuse(cols, 1, bb.cs);
+        const bool fc = fuse(rows, 2, cb.rs) && fuse(cols, 2, cb.cs);
+        matrix<T, 2> pa;
+        matrix<U, 2> pb;
+        matrix<V, 2> pc;
+        group ar, ac, br, bc, cr, cc;
+        if (!fa) {
+          pa = matrix<T, 2>(m, p);
+          ar = offsets(rows, 0);
+          ac = offsets(inner, 0);
+        }
+        if (!fb) {
+          pb = matrix<U, 2>(p, n);
+          br = offsets(inner, 1);
+          bc = offsets(cols, 1);
+        }
+        if (!fc) {
+          pc = matrix<V, 2>(m, n);
+          cr = offsets(rows, 2);
+          cc = offsets(cols, 2);
+        }
+
+        const group ba = offsets(batch, 0);
+        const group bb_ = offsets(batch, 1);
+        const group bc_ = offsets(batch, 2);
+        for (std::size_t q = 0; q != ba.size(); ++q) {
+          const T* aq = a + start[0] + ba[q];
+          const U* bq = b + start[1] + bb_[q];
+          V* cq = c + start[2] + bc_[q];
+
+          if (fa) {
+            ab.ptr = aq;
+          } else {
+            pack(aq, ar, ac, pa);
+            ab = {pa.data(), p, 1};
+          }
+          if (fb) {
+            bb.ptr = bq;
+          } else {
+            pack(bq, br, bc, pb);
+            bb = {pb.data(), n, 1};
+          }
+          if (fc) {
+            cb.ptr = cq;
+            blocked_or_product(m, n, p, ab, bb, cb);
+          } else {
+            pc = V(0);
+            blocked_or_product(m, n, p, ab, bb, block<V>{pc.data(), n, 1});
+            for (std::size_t i = 0; i != m; ++i)
+              for (std::size_t j = 0; j != n; ++j)
+                cq[cr[i] + cc[j]] += pc(i, j);
+          }
+        }
+      }
+
+  private:
+    // Add the dimensions of the kth operand, whose labels are at s.
+    template <std::size_t N>
+      void
+      add(const char* s, const matrix_slice<N>& x, int k)
+      {
+        for (std::size_t r = 0; r != N; ++r) {
+          std::size_t d = 0;
+          while (d != dims.size() && dims[d].label != s[r])
+            ++d;
+          if (d == dims.size())
+            dims.push_back({s[r], x.extents[r], {0, 0, 0}, {0, 0, 0}, {false, false, false}});
+          assert(dims[d].extent == x.extents[r]);
+          dims[d].stride[k] = x.strides[r];
+          dims[d].pos[k] = r;
+          dims[d].used[k] = true;
+        }
+      }
+
+    // Order the dimensions in g as they appear in the result.
+    void
+    by_result(group& g) const
+    {
+      std::sort(g.begin(), g.end(), [&](std::size_t i, std::size_t j) {
+        return dims[i].pos[2] < dims[j].pos[2];
+      });
+    }
+
+    std::size_t
+    extent(const group& g) const
+    {
+      std::size_t n = 1;
+      for (std::size_t d : g)
+        n *= dims[d].extent;
+      return n;
+    }
+
+    // Returns true if the dimensions in g can be traversed by a single
+    // stride in the kth operand, and sets s to that stride. This is the case
+    // when each dimension steps over the whole of the next one.
+    bool
+    fuse(const group& g, int k, std::size_t& s) const
+    {
+      s = 1;
+      bool first = true;
+      for (std::size_t i = g.size(); i-- != 0; ) {
+        const contraction_dim& d = dims[g[i]];
+        if (d.extent == 1)
+          continue;
+        if (first)
+          s = d.stride[k];
+        else if (d.stride[k] != s * extent_after(g, i))
+          return false;
+        first = false;
+      }
+      return true;
+    }
+
+    // Returns the product of the extents of the dimensions of g after the
+    // ith.
+    std::size_t
+    extent_after(const group& g, std::size_t i) const
+    {
+      std::size_t n = 1;
+      for (std::size_t j = i + 1; j != g.size(); ++j)
+        n *= dims[g[j]].extent;
+      return n;
+    }
+
+    // Returns the offsets of the elements of the kth operand indexed by the
+    // dimensions in g, in row-major order.
+    group
+    offsets(const group& g, int k) const
+    {
+      group off(1, 0);
+      for (std::size_t d : g) {
+        group next;
+        next.reserve(off.size() * dims[d].extent);
+        for (std::size_t o : off)
+          for (std::size_t i = 0; i != dims[d].extent; ++i)
+            next.push_back(o + i * dims[d].stride[k]);
+        off.swap(next);
+      }
+      return off;
+    }
+
+    // Copy the elements of x at the given row and column offsets into p.
+    template <typename T>
+      static void
+      pack(const T* x, const group& r, const group& c, matrix<T, 2>& p)
+      {
+        T* out = p.data();
+        for (std::size_t o : r)
+          for (std::size_t j = 0; j != c.size(); ++j)
+            *out++ = x[o + c[j]];
+      }
+
+    std::vector<contraction_dim> dims;
+    group rows, cols, inner, batch;
+    std::size_t start[3];
+  };
+
+} // namespace matrix_impl
+
+
+// Returns true if spec is a valid einsum specification for operands of
+// order n1 and n2 and a result of order n3. This can be evaluated at compile
+// time to check a specification:
+//
+//    static_assert(einsum_valid("bik,bkj->bij", 3, 3, 3), "");
+constexpr bool
+einsum_valid(const char* spec, std::size_t n1, std::size_t n2, std::size_t n3)
+{
+  return matrix_impl::count_labels(spec) == n1 && spec[n1] == ','
+      && matrix_impl::count_labels(spec + n1 + 1) == n2
+      && spec[n1 + n2 + 1] == '-' && spec[n1 + n2 + 2] == '>'
+      && matrix_impl::count_labels(spec + n1 + n2 + 3) == n3
+      && spec[n1 + n2 + n3 + 3] == '\0'
+      && matrix_impl::einsum_check(spec, n1, spec + n1 + 1, n2,
+                                   spec + n1 + n2 + 3, n3);
+}
+
+
+// Einsum
+//
+// Accumulate the contraction of a and b described by spec into out. See
+// [matrix.contract] for the form of the specification. The extents of
+// dimensions with the same label must be equal.
+//
+// For example, given 3D matrices a (b x m x p) and b (b x p x n), and a 2D
+// matrix c (m x n):
+//
+//    einsum("bik,bkj->bij", a, b, out);   // out[k] += a[k] * b[k]
+//    einsum("kij,kjl->il", a, b, c);      // c += sum of a[k] * b[k]
+template <typename M1, typename M2, typename M3>
+  void
+  einsum(const char* spec, const M1& a, const M2& b, M3& out)
+  {
+    assert(einsum_valid(spec, M1::order, M2::order, M3::order));
+    matrix_impl::contraction c(spec, a.descriptor(), b.descriptor(), out.descriptor());
+    c.run(a.data(), b.data(), out.data());
+  }
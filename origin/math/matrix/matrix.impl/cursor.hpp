@@ -0,0 +1,126 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+
+// -------------------------------------------------------------------------- //
+//                                Cursors
+//
+// A cursor refers to an element of a matrix and can be moved along any of
+// its dimensions. It holds a pointer to the element and the strides of the
+// matrix, so accessing a neighboring element or stepping to the next one is
+// a single multiply-add, unlike indexing a matrix, which computes the
+// offset of the element from all of its indexes (and checks them).
+//
+// Cursors are intended for hot loops:
+//
+//    auto c = cursor(m);               // Refers to m(0, 0)
+//    for (std::size_t i = 0; i != m.rows(); ++i, c.move(0)) {
+//      auto r = c.line(1);             // Refers to m(i, 0), along the row
+//      for (std::size_t j = 0; j != m.cols(); ++j)
+//        r[j] += 1;
+//    }
+//
+// A cursor does not check that it refers to an element of its matrix, and it
+// is invalidated by any operation that invalidates pointers into the matrix.
+template <typename T, std::size_t N>
+  class matrix_cursor
+  {
+  public:
+    // Create a cursor that refers to the element at p in a matrix with the
+    // given strides.
+    matrix_cursor(T* p, const std::size_t* s)
+      : ptr(p)
+    {
+      std::copy_n(s, N, strides);
+    }
+
+    // Create a cursor that refers to the first element of the matrix with
+    // elements p and the descriptor s.
+    matrix_cursor(T* p, const matrix_slice<N>& s)
+      : matrix_cursor(p + s.start, s.strides)
+    { }
+
+    // Returns the referenced element.
+    T& operator*() const { return *ptr; }
+
+    // Returns a pointer to the referenced element.
+    T* get() const { return ptr; }
+
+    // Returns the stride of the dth dimension.
+    std::size_t stride(std::size_t d) const { return strides[d]; }
+
+    // Returns the element at the given offsets (which may be negative) from
+    // the referenced element.
+    template <typename... Offsets>
+      T& operator()(Offsets... offs) const
+      {
+        static_assert(sizeof...(Offsets) == N, "");
+        return ptr[offset(offs...)];
+      }
+
+    // Returns the element n elements from the referenced element along the
+    // last dimension. For a 1D cursor, this is the usual subscript.
+    T& operator[](std::ptrdiff_t n) const
+    {
+      return ptr[n * std::ptrdiff_t(strides[N - 1])];
+    }
+
+    // Move the cursor n elements along the dth dimension.
+    matrix_cursor& move(std::size_t d, std::ptrdiff_t n = 1)
+    {
+      ptr += n * std::ptrdiff_t(strides[d]);
+      return *this;
+    }
+
+    // Returns a 1D cursor that refers to the same element and moves along
+    // the dth dimension.
+    matrix_cursor<T, 1> line(std::size_t d) const
+    {
+      return {ptr, strides + d};
+    }
+
+  private:
+    template <typename... Offsets>
+      std::ptrdiff_t offset(Offsets... offs) const
+      {
+        const std::ptrdiff_t o[] {std::ptrdiff_t(offs)...};
+        std::ptrdiff_t k = 0;
+        for (std::size_t d = 0; d != N; ++d)
+          k += o[d] * std::ptrdiff_t(strides[d]);
+        return k;
+      }
+
+    T* ptr;
+    std::size_t strides[N];
+  };
+
+
+// Returns a cursor that refers to the first element of m.
+template <typename T, std::size_t N, typename A>
+  inline matrix_cursor<T, N>
+  cursor(matrix<T, N, A>& m)
+  {
+    return {m.data(), m.descriptor()};
+  }
+
+template <typename T, std::size_t N, typename A>
+  inline matrix_cursor<const T, N>
+  cursor(const matrix<T, N, A>& m)
+  {
+    return {m.data(), m.descriptor()};
+  }
+
+template <typename T, std::size_t N>
+  inline matrix_cursor<T, N>
+  cursor(matrix_ref<T, N> m)
+  {
+    return {m.data(), m.descriptor()};
+  }
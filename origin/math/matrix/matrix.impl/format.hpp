@@ -0,0 +1,248 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+namespace matrix_impl
+{
+  // ------------------------------------------------------------------------ //
+  //                            Text Formatting
+  //
+  // The matrix printers format elements into a local buffer and write the
+  // buffer to the stream in large blocks, rather than inserting each element
+  // and punctuation character separately.
+  //
+  // Buffered formatting is used only when it produces exactly the same text
+  // as the stream would: the stream must be a narrow character stream in the
+  // classic locale with its default format flags and no field width, and the
+  // elements must be integers (other than characters), bools or floating
+  // point values. Floating point values are formatted like printf's %g with
+  // the stream's precision, as the stream itself does.
+
+
+  // Returns true if elements of type T can be formatted by a text_writer.
+  template <typename T>
+    constexpr bool
+    Formattable()
+    {
+      return std::is_arithmetic<T>::value
+          && !std::is_same<T, char>::value
+          && !std::is_same<T, signed char>::value
+          && !std::is_same<T, unsigned char>::value
+          && !std::is_same<T, wchar_t>::value
+          && !std::is_same<T, char16_t>::value
+          && !std::is_same<T, char32_t>::value;
+    }
+
+  // Returns true if os formats values exactly as a text_writer does.
+  template <typename Tr>
+    inline bool
+    default_format(const std::basic_ostream<char, Tr>& os)
+    {
+      return os.flags() == (std::ios_base::dec | std::ios_base::skipws)
+          && os.width() == 0
+          && os.precision() < 48
+          && os.getloc() == std::locale::classic();
+    }
+
+
+  // A text writer accumulates formatted text in a fixed buffer, which is
+  // written to the underlying stream when it is full and when the writer is
+  // destroyed.
+  template <typename Tr>
+    class text_writer
+    {
+    public:
+      explicit text_writer(std::basic_ostream<char, Tr>& os)
+        : os(os), prec(int(os.precision())), n(0)
+      { }
+
+      ~text_writer() { flush(); }
+
+      text_writer(const text_writer&) = delete;
+      text_writer& operator=(const text_writer&) = delete;
+
+      void put(char c)
+      {
+        reserve(1);
+        buf[n++] = c;
+      }
+
+      void put(char c, std::size_t k)
+      {
+        for (std::size_t i = 0; i != k; ++i)
+          put(c);
+      }
+
+      // Format the value x.
+      void value(bool x) { put(x ? '1' : '0'); }
+
+      template <typename T>
+        Requires<std::is_integral<T>::value && std::is_signed<T>::value>
+        value(T x)
+        {
+          reserve(max_digits);
+          unsigned long long u = x;
+          if (x < 0) {
+            buf[n++] = '-';
+            u = 0ull - u;
+          }
+          digits(u);
+        }
+
+      template <typename T>
+        Requires<std::is_integral<T>::value && !std::is_signed<T>::value>
+        value(T x)
+        {
+          reserve(max_digits);
+          digits(x);
+        }
+
+      void value(float x) { value(double(x)); }
+
+      void value(double x)
+      {
+        reserve(max_digits);
+        n += std::snprintf(buf + n, max_digits, "%.*g", prec, x);
+      }
+
+      void value(long double x)
+      {
+        reserve(max_digits);
+        n += std::snprintf(buf + n, max_digits, "%.*Lg", prec, x);
+      }
+
+      void flush()
+      {
+        if (n) {
+          os.write(buf, n);
+          n = 0;
+        }
+      }
+
+    private:
+      // The longest formatted value. A %g conversion produces at most
+      // precision significant digits plus a sign, point and exponent.
+      static constexpr std::size_t max_digits = 64;
+      static constexpr std::size_t capacity = 1 << 14;
+
+      void reserve(std::size_t k)
+      {
+        if (n + k > capacity)
+          flush();
+      }
+
+      void digits(unsigned long long u)
+      {
+        char tmp[24];
+        char* p = tmp + sizeof(tmp);
+        do {
+          *--p = char('0' + u % 10);
+          u /= 10;
+        } while (u);
+        const std::size_t k = tmp + sizeof(tmp) - p;
+        std::memcpy(buf + n, p, k);
+        n += k;
+      }
+
+      std::basic_ostream<char, Tr>& os;
+      int prec;
+      std::size_t n;
+      char buf[capacity];
+    };
+
+
+  // Write the elements of the slice s of p in the nested bracket notation
+  // used by operator<<, e.g. [[1,2],[3,4]]. The dimension d is being written
+  // and off is the offset of the current submatrix.
+  template <typename W, std::size_t N, typename T>
+    void
+    format_nested(W& w, const matrix_slice<N>& s, const T* p,
+                  std::size_t d, std::size_t off)
+    {
+      w.put('[');
+      const std::size_t n = s.extents[d];
+      for (std::size_t i = 0; i != n; ++i) {
+        const std::size_t x = off + i * s.strides[d];
+        if (d + 1 == N)
+          w.value(p[x]);
+        else
+          format_nested(w, s, p, d + 1, x);
+        if (i + 1 != n)
+          w.put(',');
+      }
+      w.put(']');
+    }
+
+  // Write the elements of the slice s of p in the indented notation used by
+  // pretty(). Each submatrix starts on a new line, indented by its depth.
+  template <typename W, std::size_t N, typename T>
+    void
+    format_pretty(W& w, const matrix_slice<N>& s, const T* p,
+                  std::size_t d, std::size_t off, std::size_t depth)
+    {
+      w.put(' ', depth);
+      if (d + 1 == N) {
+        format_nested(w, s, p, d, off);
+        return;
+      }
+      w.put('[');
+      w.put('\n');
+      const std::size_t n = s.extents[d];
+      for (std::size_t i = 0; i != n; ++i) {
+        format_pretty(w, s, p, d + 1, off + i * s.strides[d], depth + 1);
+        if (i + 1 != n)
+          w.put(',');
+        w.put('\n');
+      }
+      w.put(']');
+    }
+
+
+  // Write m to os in the nested or pretty notation using a text_writer,
+  // returning true. If os is not a narrow stream with the default format, or
+  // the elements of m cannot be formatted, nothing is written and false is
+  // returned.
+  template <typename Tr, typename M>
+    Requires<Formattable<Value_type<M>>(), bool>
+    print_nested(std::basic_ostream<char, Tr>& os, const M& m)
+    {
+      if (!default_format(os))
+        return false;
+      text_writer<Tr> w(os);
+      format_nested(w, m.descriptor(), m.data(), 0, m.descriptor().start);
+      return true;
+    }
+
+  template <typename C, typename Tr, typename M>
+    inline bool
+    print_nested(std::basic_ostream<C, Tr>&, const M&)
+    {
+      return false;
+    }
+
+  template <typename Tr, typename M>
+    Requires<Formattable<Value_type<M>>(), bool>
+    print_pretty(std::basic_ostream<char, Tr>& os, const M& m, std::size_t depth)
+    {
+      if (!default_format(os))
+        return false;
+      text_writer<Tr> w(os);
+      format_pretty(w, m.descriptor(), m.data(), 0, m.descriptor().start, depth);
+      return true;
+    }
+
+  template <typename C, typename Tr, typename M>
+    inline bool
+    print_pretty(std::basic_ostream<C, Tr>&, const M&, std::size_t)
+    {
+      return false;
+    }
+
+} // namespace matrix_impl
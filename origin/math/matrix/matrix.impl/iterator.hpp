@@ -32,6 +32,9 @@ template <typename T, std::size_t N>
     // Returns the iterators describing slice.
     const matrix_slice<N>& descriptor() const { return desc; }
 
+    // Returns the multidimensional index of the referenced element.
+    const std::size_t* index() const { return indexes; }
+
     // Readable
     T& operator*() const { return *ptr; }
     T* operator->() const { return ptr; }
@@ -119,12 +122,17 @@ template <typename T, std::size_t N>
 //
 // For efficiency, we assume the first requirement. It is undefined behavior
 // to compare slice iterators from different slices.
+//
+// Note that iterators are compared by index and not by address. When the
+// strides do not describe a row-major ordering (e.g., a transposed view), an
+// element in the middle of the sequence may have the same address as the
+// past-the-end position.
 template <typename T, std::size_t N>
   inline bool
   operator==(const slice_iterator<T, N>& a, const slice_iterator<T, N>& b)
   {
     assert(a.descriptor() == b.descriptor());
-    return &*a == &*b;
+    return std::equal(a.index(), a.index() + N, b.index());
   }
 
 template <typename T, std::size_t N>
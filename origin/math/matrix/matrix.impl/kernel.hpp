@@ -0,0 +1,1069 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+namespace matrix_impl
+{
+  // ------------------------------------------------------------------------ //
+  //                              Kernels
+  //
+  // The kernels in this file operate on memory described by a pointer and a
+  // slice, or by a 2D block (a pointer to the first element, a row stride and
+  // a column stride). They are the building blocks of the arithmetic and
+  // linear algebra operations on matrices and are independent of any
+  // particular matrix class.
+
+
+  // A strided 2D block of elements. The (i, j)th element is located at
+  // ptr[i * rs + j * cs].
+  template <typename T>
+    struct block
+    {
+      T& operator()(std::size_t i, std::size_t j) const
+      {
+        return ptr[i * rs + j * cs];
+      }
+
+      T* ptr;
+      std::size_t rs;
+      std::size_t cs;
+    };
+
+  // Returns a block describing the 2D slice s of the elements pointed to by p.
+  template <typename T>
+    inline block<T>
+    make_block(T* p, const matrix_slice<2>& s)
+    {
+      return {p + s.start, s.strides[0], s.strides[1]};
+    }
+
+  // Returns the transpose of the block b.
+  template <typename T>
+    inline block<T>
+    transposed(block<T> b)
+    {
+      return {b.ptr, b.cs, b.rs};
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                          Elementwise Traversal
+  //
+  // Call f on corresponding elements of two or three slices with the same
+  // extents. The slices may have arbitrary strides, including the zero strides
+  // of broadcast slices. The outer dimensions are enumerated like an odometer
+  // and the innermost dimension is a simple strided loop.
+  //
+  // The first slice determines the traversal order. If it is column-major,
+  // the dimensions of all slices are reversed so that the innermost loop
+  // runs along its contiguous columns. The order in which f is called is
+  // therefore unspecified.
+
+  template <std::size_t N, typename T, typename U, typename F>
+    void
+    elementwise(const matrix_slice<N>& a, T* pa, 
+                const matrix_slice<N>& b, U* pb, 
+                F f)
+    {
+      if (a.size == 0)
+        return;
+      if (layout(a) == matrix_layout::column_major) {
+        elementwise(reverse_axes(a), pa, reverse_axes(b), pb, f);
+        return;
+      }
+      const std::size_t n = a.extents[N - 1];
+      const std::size_t sa = a.strides[N - 1];
+      const std::size_t sb = b.strides[N - 1];
+      std::size_t idx[N] {};
+      T* x = pa + a.start;
+      U* y = pb + b.start;
+      for (std::size_t o = a.size / n; o != 0; --o) {
+        if (sa == 1 && sb == 1)
+          for (std::size_t j = 0; j != n; ++j)
+            f(x[j], y[j]);
+        else
+          for (std::size_t j = 0; j != n; ++j)
+            f(x[j * sa], y[j * sb]);
+
+        for (std::size_t d = N - 1; d-- != 0; ) {
+          x += a.strides[d];
+          y += b.strides[d];
+          if (++idx[d] != a.extents[d])
+            break;
+          x -= a.strides[d] * a.extents[d];
+          y -= b.strides[d] * b.extents[d];
+          idx[d] = 0;
+        }
+      }
+    }
+
+  template <std::size_t N, typename T, typename U, typename V, typename F>
+    void
+    elementwise(const matrix_slice<N>& a, T* pa, 
+                const matrix_slice<N>& b, U* pb, 
+                const matrix_slice<N>& c, V* pc,
+                F f)
+    {
+      if (a.size == 0)
+        return;
+      if (layout(a) == matrix_layout::column_major) {
+        elementwise(reverse_axes(a), pa, reverse_axes(b), pb, reverse_axes(c), pc, f);
+        return;
+      }
+      const std::size_t n = a.extents[N - 1];
+      const std::size_t sa = a.strides[N - 1];
+      const std::size_t sb = b.strides[N - 1];
+      const std::size_t sc = c.strides[N - 1];
+      std::size_t idx[N] {};
+      T* x = pa + a.start;
+      U* y = pb + b.start;
+      V* z = pc + c.start;
+      for (std::size_t o = a.size / n; o != 0; --o) {
+        if (sa == 1 && sb == 1 && sc == 1)
+          for (std::size_t j = 0; j != n; ++j)
+            f(x[j], y[j], z[j]);
+        else
+          for (std::size_t j = 0; j != n; ++j)
+            f(x[j * sa], y[j * sb], z[j * sc]);
+
+        for (std::size_t d = N - 1; d-- != 0; ) {
+          x += a.strides[d];
+          y += b.strides[d];
+          z += c.strides[d];
+          if (++idx[d] != a.extents[d])
+            break;
+          x -= a.strides[d] * a.extents[d];
+          y -= b.strides[d] * b.extents[d];
+          z -= c.strides[d] * c.extents[d];
+          idx[d] = 0;
+        }
+      }
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                            Vector Kernels
+  //
+  // Kernels on strided vectors of n elements. Each has a fast path for
+  // contiguous operands, which the compiler can vectorize.
+
+  // Returns the dot product of the vectors x and y. The products are
+  // accumulated into four independent partial sums so that successive
+  // additions do not wait on one another.
+  template <typename T, typename U>
+    Common_type<T, U>
+    dot(std::size_t n, const T* x, std::size_t xs, const U* y, std::size_t ys)
+    {
+      using V = Common_type<T, U>;
+      V s[4] {};
+      std::size_t i = 0;
+      if (xs == 1 && ys == 1) {
+        for (; i + 4 <= n; i += 4)
+          unroll<0, 4>::apply([&](std::size_t k) { s[k] += x[i + k] * y[i + k]; });
+      } else {
+        for (; i + 4 <= n; i += 4)
+          unroll<0, 4>::apply([&](std::size_t k) {
+            s[k] += x[(i + k) * xs] * y[(i + k) * ys];
+          });
+      }
+      for (; i != n; ++i)
+        s[0] += x[i * xs] * y[i * ys];
+      return (s[0] + s[1]) + (s[2] + s[3]);
+    }
+
+  // Compute y = a * x + y.
+  template <typename T, typename U, typename V>
+    void
+    axpy(std::size_t n, const T& a, const U* x, std::size_t xs, V* y, std::size_t ys)
+    {
+      if (xs == 1 && ys == 1) {
+        for (std::size_t i = 0; i != n; ++i)
+          y[i] += a * x[i];
+      } else {
+        for (std::size_t i = 0; i != n; ++i)
+          y[i * ys] += a * x[i * xs];
+      }
+    }
+
+  // Compute x = a * x. When a is 0, x is set to 0, even if it contains
+  // infinities or NaNs.
+  template <typename T, typename U>
+    void
+    scal(std::size_t n, const T& a, U* x, std::size_t xs)
+    {
+      if (a == T(0)) {
+        for (std::size_t i = 0; i != n; ++i)
+          x[i * xs] = U(0);
+      } else if (a != T(1)) {
+        for (std::size_t i = 0; i != n; ++i)
+          x[i * xs] *= a;
+      }
+    }
+
+
+  // Returns the number of rows of an m x n matrix-vector operation that
+  // should be assigned to each thread.
+  inline std::size_t
+  vector_grain(std::size_t n)
+  {
+    constexpr std::size_t min_work = 1 << 15;
+    return std::max(min_work / std::max(n, std::size_t(1)), std::size_t(1));
+  }
+
+
+  // ------------------------------------------------------------------------ //
+  //                        Matrix-Vector Product
+  //
+  // Compute y = alpha * a * x + beta * y, where a is an m x n block, x is a
+  // vector of n elements with stride xs, and y is a vector of m elements
+  // with stride ys.
+  //
+  // When the rows of a are contiguous (or neither dimension is), each
+  // element of y is a dot product of a row of a with x. When the columns of
+  // a are contiguous (e.g., a transposed matrix), the columns of a are
+  // instead scaled and added into y. In both cases, the rows of a and y are
+  // partitioned into blocks that are computed concurrently.
+  template <typename S, typename T, typename U, typename V>
+    void
+    gemv(std::size_t m, std::size_t n, const S& alpha, block<T> a,
+         const U* x, std::size_t xs, const S& beta, V* y, std::size_t ys)
+    {
+      const std::size_t grain = vector_grain(n);
+      if (a.rs == 1 && a.cs != 1) {
+        parallel_for(m, grain, [&](std::size_t first, std::size_t last) {
+          V* yb = y + first * ys;
+          scal(last - first, beta, yb, ys);
+          for (std::size_t j = 0; j != n; ++j)
+            axpy(last - first, alpha * x[j * xs], &a(first, j), 1, yb, ys);
+        });
+      } else {
+        parallel_for(m, grain, [&](std::size_t first, std::size_t last) {
+          for (std::size_t i = first; i != last; ++i) {
+            V& yi = y[i * ys];
+            const V r = alpha * dot(n, &a(i, 0), a.cs, x, xs);
+            yi = beta == S(0) ? r : beta * yi + r;
+          }
+        });
+      }
+    }
+
+  // Compute a = alpha * x * y^T + a, where a is an m x n block, x is a
+  // vector of m elements and y is a vector of n elements. Blocks of rows of
+  // a are updated concurrently.
+  template <typename S, typename T, typename U, typename V>
+    void
+    ger(std::size_t m, std::size_t n, const S& alpha,
+        const T* x, std::size_t xs, const U* y, std::size_t ys, block<V> a)
+    {
+      const std::size_t grain = vector_grain(n);
+      if (a.rs == 1 && a.cs != 1) {
+        parallel_for(m, grain, [&](std::size_t first, std::size_t last) {
+          for (std::size_t j = 0; j != n; ++j)
+            axpy(last - first, alpha * y[j * ys], x + first * xs, xs, &a(first, j), 1);
+        });
+      } else {
+        parallel_for(m, grain, [&](std::size_t first, std::size_t last) {
+          for (std::size_t i = first; i != last; ++i)
+            axpy(n, alpha * x[i * xs], y, ys, &a(i, 0), a.cs);
+        });
+      }
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                            Matrix Product
+  //
+  // Accumulate the product of the m x p block a and the p x n block b into
+  // the m x n block c.
+  //
+  // When the columns of b are contiguous (but not its rows), the kernel runs
+  // in i-j-k order so that the innermost loop is a dot product over
+  // contiguous memory in both a and b. Otherwise, the kernel runs in i-k-j
+  // order so that the innermost loop streams along rows of b and c.
+  template <typename T, typename U, typename V>
+    void
+    product(std::size_t m, std::size_t n, std::size_t p,
+            block<T> a, block<U> b, block<V> c)
+    {
+      if (b.rs == 1 && b.cs != 1) {
+        for (std::size_t i = 0; i != m; ++i) {
+          const T* ai = &a(i, 0);
+          for (std::size_t j = 0; j != n; ++j) {
+            const U* bj = &b(0, j);
+            V s = V();
+            for (std::size_t k = 0; k != p; ++k)
+              s += ai[k * a.cs] * bj[k];
+            c(i, j) += s;
+          }
+        }
+      } else {
+        for (std::size_t i = 0; i != m; ++i) {
+          V* ci = &c(i, 0);
+          for (std::size_t k = 0; k != p; ++k) {
+            const T aik = a(i, k);
+            const U* bk = &b(k, 0);
+            for (std::size_t j = 0; j != n; ++j)
+              ci[j * c.cs] += aik * bk[j * b.cs];
+          }
+        }
+      }
+    }
+
+  // Accumulate the product of the m x P block a and the P x n block b into c,
+  // where the inner extent P is a (small) constant. The inner dot products
+  // are completely unrolled.
+  template <std::size_t P, typename T, typename U, typename V>
+    void
+    small_product(std::size_t m, std::size_t n, block<T> a, block<U> b, block<V> c)
+    {
+      for (std::size_t i = 0; i != m; ++i) {
+        for (std::size_t j = 0; j != n; ++j) {
+          V s = c(i, j);
+          unroll<0, P>::apply([&](std::size_t k) { s += a(i, k) * b(k, j); });
+          c(i, j) = s;
+        }
+      }
+    }
+
+  // Accumulate the product of a and b into c, selecting an unrolled kernel
+  // when the inner extent is at most 4.
+  template <typename T, typename U, typename V>
+    void
+    small_or_product(std::size_t m, std::size_t n, std::size_t p,
+                     block<T> a, block<U> b, block<V> c)
+    {
+      switch (p) {
+      case 1: small_product<1>(m, n, a, b, c); break;
+      case 2: small_product<2>(m, n, a, b, c); break;
+      case 3: small_product<3>(m, n, a, b, c); break;
+      case 4: small_product<4>(m, n, a, b, c); break;
+      default: product(m, n, p, a, b, c); break;
+      }
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                       Strassen-Winograd Product
+  //
+  // Accumulate the product of the m x p block a and the p x n block b into
+  // the m x n block c using the Winograd variant of Strassen's algorithm.
+  // The operands are partitioned into 2 x 2 blocks of half their extents,
+  // and the product is formed from seven half-size products rather than
+  // eight:
+  //
+  //    S1 = A21 + A22    T1 = B12 - B11    P1 = A11 B11    P5 = S1 T1
+  //    S2 = S1 - A11     T2 = B22 - T1     P2 = A12 B21    P6 = S2 T2
+  //    S3 = A11 - A21    T3 = B22 - B12    P3 = S4 B22     P7 = S3 T3
+  //    S4 = A12 - S2     T4 = T2 - B21     P4 = A22 T4
+  //
+  //    C11 += P1 + P2              C12 += P1 + P6 + P5 + P3
+  //    C21 += P1 + P6 + P7 - P4    C22 += P1 + P6 + P7 + P5
+  //
+  // The half-size products are computed recursively until one of the
+  // extents is no greater than the crossover, below which the classical
+  // kernel is faster. When an extent is odd, the last row, column or inner
+  // index is excluded from the recursion and its contribution is added by
+  // the classical kernel.
+  //
+  // The S, T and P operands of each level are stored in a workspace that is
+  // allocated once for the whole product; see strassen_workspace.
+
+  // Returns the block of b whose first element is b(i, j).
+  template <typename T>
+    inline block<T>
+    subblock(block<T> b, std::size_t i, std::size_t j)
+    {
+      return {&b(i, j), b.rs, b.cs};
+    }
+
+  // Assign out(i, j) = f(x(i, j), y(i, j)) for each element of the m x n
+  // block out.
+  template <typename T, typename U, typename V, typename F>
+    void
+    combine(std::size_t m, std::size_t n, block<T> x, block<U> y, block<V> out, F f)
+    {
+      for (std::size_t i = 0; i != m; ++i)
+        for (std::size_t j = 0; j != n; ++j)
+          out(i, j) = f(x(i, j), y(i, j));
+    }
+
+  // Compute c = c + x for the m x n blocks x and c.
+  template <typename T, typename V>
+    void
+    accumulate(std::size_t m, std::size_t n, block<T> x, block<V> c)
+    {
+      combine(m, n, c, x, c, [](const V& a, const T& b) { return a + b; });
+    }
+
+  // Set the elements of the m x n block c to 0.
+  template <typename V>
+    void
+    zero(std::size_t m, std::size_t n, block<V> c)
+    {
+      for (std::size_t i = 0; i != m; ++i)
+        for (std::size_t j = 0; j != n; ++j)
+          c(i, j) = V(0);
+    }
+
+  // Returns the number of elements of workspace needed by the Strassen-
+  // Winograd product of an m x p block and a p x n block with the given
+  // crossover. Each level of the recursion needs space for one half-size
+  // operand of each shape, so the total is about a third of the size of
+  // the operands and result.
+  inline std::size_t
+  strassen_workspace(std::size_t m, std::size_t n, std::size_t p,
+                     std::size_t crossover)
+  {
+    std::size_t k = 0;
+    while (std::min(m, std::min(n, p)) > crossover) {
+      m /= 2;
+      n /= 2;
+      p /= 2;
+      k += m * p + p * n + m * n;
+    }
+    return k;
+  }
+
+  template <typename T, typename U, typename V>
+    void
+    strassen(std::size_t m, std::size_t n, std::size_t p,
+             block<T> a, block<U> b, block<V> c,
+             std::size_t crossover, V* ws)
+    {
+      if (std::min(m, std::min(n, p)) <= crossover) {
+        product(m, n, p, a, b, c);
+        return;
+      }
+
+      const std::size_t mh = m / 2;
+      const std::size_t nh = n / 2;
+      const std::size_t ph = p / 2;
+      const block<T> a11 = a, a12 = subblock(a, 0, ph);
+      const block<T> a21 = subblock(a, mh, 0), a22 = subblock(a, mh, ph);
+      const block<U> b11 = b, b12 = subblock(b, 0, nh);
+      const block<U> b21 = subblock(b, ph, 0), b22 = subblock(b, ph, nh);
+      const block<V> c11 = c, c12 = subblock(c, 0, nh);
+      const block<V> c21 = subblock(c, mh, 0), c22 = subblock(c, mh, nh);
+
+      // The S, T and P operands of this level. Deeper levels use the
+      // remainder of the workspace.
+      const block<V> s {ws, ph, 1};
+      const block<V> t {ws + mh * ph, nh, 1};
+      const block<V> q {ws + mh * ph + ph * nh, nh, 1};
+      V* rest = ws + mh * ph + ph * nh + mh * nh;
+
+      auto plus = [](const V& x, const V& y) { return x + y; };
+      auto minus = [](const V& x, const V& y) { return x - y; };
+
+      // P1 and P2.
+      strassen(mh, nh, ph, a12, b21, c11, crossover, rest);
+      zero(mh, nh, q);
+      strassen(mh, nh, ph, a11, b11, q, crossover, rest);
+      accumulate(mh, nh, q, c11);
+      accumulate(mh, nh, q, c12);
+      accumulate(mh, nh, q, c21);
+      accumulate(mh, nh, q, c22);
+
+      // P5 = S1 T1.
+      combine(mh, ph, a21, a22, s, plus);
+      combine(ph, nh, b12, b11, t, minus);
+      zero(mh, nh, q);
+      strassen(mh, nh, ph, s, t, q, crossover, rest);
+      accumulate(mh, nh, q, c12);
+      accumulate(mh, nh, q, c22);
+
+      // P6 = S2 T2.
+      combine(mh, ph, s, a11, s, minus);
+      combine(ph, nh, b22, t, t, minus);
+      zero(mh, nh, q);
+      strassen(mh, nh, ph, s, t, q, crossover, rest);
+      accumulate(mh, nh, q, c12);
+      accumulate(mh, nh, q, c21);
+      accumulate(mh, nh, q, c22);
+
+      // P3 = S4 B22 and -P4 = A22 (-T4).
+      combine(mh, ph, a12, s, s, minus);
+      strassen(mh, nh, ph, s, b22, c12, crossover, rest);
+      combine(ph, nh, b21, t, t, minus);
+      strassen(mh, nh, ph, a22, t, c21, crossover, rest);
+
+      // P7 = S3 T3.
+      combine(mh, ph, a11, a21, s, minus);
+      combine(ph, nh, b22, b12, t, minus);
+      zero(mh, nh, q);
+      strassen(mh, nh, ph, s, t, q, crossover, rest);
+      accumulate(mh, nh, q, c21);
+      accumulate(mh, nh, q, c22);
+
+      // Add the contributions of the rows, columns and inner index that
+      // were excluded from the partition.
+      const std::size_t m2 = 2 * mh;
+      const std::size_t n2 = 2 * nh;
+      const std::size_t p2 = 2 * ph;
+      if (p2 != p)
+        product(m2, n2, 1, subblock(a, 0, p2), subblock(b, p2, 0), c);
+      if (n2 != n)
+        product(m, 1, p, a, subblock(b, 0, n2), subblock(c, 0, n2));
+      if (m2 != m)
+        product(1, n2, p, subblock(a, m2, 0), b, subblock(c, m2, 0));
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                           Widening Product
+  //
+  // Products of reduced precision operands (e.g., bfloat16 or 8-bit
+  // integers) are accumulated in their accumulator type (float or a 32-bit
+  // integer). The operands are stored and read in their narrow type, and
+  // widened only as they are used.
+
+  // Returns true if the products of T and U values are accumulated in a
+  // wider type than their common type.
+  template <typename T, typename U>
+    constexpr bool
+    Widening()
+    {
+      return !std::is_same<Common_type<Accumulator_type<T>, Accumulator_type<U>>,
+                           Common_type<Remove_const<T>, Remove_const<U>>>::value;
+    }
+
+// With GCC, the row and tile kernels are inlined into the AVX2 variant
+// selected by sequence_impl::simd_run (see sequence/algorithm.impl/simd.hpp).
+#if defined(__GNUC__)
+#  define ORIGIN_MATRIX_SIMD_INLINE __attribute__((always_inline))
+#else
+#  define ORIGIN_MATRIX_SIMD_INLINE
+#endif
+
+  // Computes one row of a widening product: acc[j] is the sum over k of
+  // a[k * as] * bp[k * n + j], for j in [0, n).
+  //
+  // The columns are taken in blocks of fixed width whose sums are kept in a
+  // local array. The loop over a block has a constant trip count and does
+  // not alias acc, so the compiler vectorizes it without run time checks.
+  template <typename A>
+    struct widening_row
+    {
+      static constexpr std::size_t width = 32;
+
+      template <typename T>
+        ORIGIN_MATRIX_SIMD_INLINE void
+        operator()(const T* a, std::size_t as, std::size_t p,
+                   const A* bp, std::size_t n, A* acc) const
+        {
+          std::size_t j0 = 0;
+          for (; j0 + width <= n; j0 += width) {
+            A s[width] = {};
+            for (std::size_t k = 0; k != p; ++k) {
+              const A x = A(a[k * as]);
+              const A* bk = bp + k * n + j0;
+              for (std::size_t j = 0; j != width; ++j)
+                s[j] += x * bk[j];
+            }
+            std::copy(s, s + width, acc + j0);
+          }
+          for (; j0 != n; ++j0) {
+            A s = A(0);
+            for (std::size_t k = 0; k != p; ++k)
+              s += A(a[k * as]) * bp[k * n + j0];
+            acc[j0] = s;
+          }
+        }
+    };
+
+  // Accumulate the product of the m x p block a and the p x n block b into
+  // the m x n block c, computing each element in the accumulator type.
+  //
+  // The columns of b are processed in panels whose widened elements fit in
+  // cache. The panel is stored contiguously, and each row of c is computed
+  // by the row kernel, which uses AVX2 when the processor supports it.
+  // Blocks of rows of c are computed concurrently.
+  template <typename T, typename U, typename V>
+    void
+    widening_product(std::size_t m, std::size_t n, std::size_t p,
+                     block<T> a, block<U> b, block<V> c)
+    {
+      using A = Common_type<Accumulator_type<T>, Accumulator_type<U>>;
+      constexpr std::size_t panel = 1 << 16;
+      const std::size_t w = std::min(n, std::max(panel / std::max(p, std::size_t(1)),
+                                                 std::size_t(16)));
+      std::vector<A> bp(p * w);
+      for (std::size_t j0 = 0; j0 < n; j0 += w) {
+        const std::size_t nw = std::min(w, n - j0);
+        for (std::size_t k = 0; k != p; ++k)
+          for (std::size_t j = 0; j != nw; ++j)
+            bp[k * nw + j] = A(b(k, j0 + j));
+
+        parallel_for(m, vector_grain(p * nw), [&](std::size_t first, std::size_t last) {
+          const A* pb = bp.data();
+          std::vector<A> acc(nw);
+          for (std::size_t i = first; i != last; ++i) {
+            const T* ai = a.ptr + i * a.rs;
+            sequence_impl::simd_run(widening_row<A>(), ai, a.cs, p, pb, nw, acc.data());
+            for (std::size_t j = 0; j != nw; ++j)
+              c(i, j0 + j) = V(c(i, j0 + j) + acc[j]);
+          }
+        });
+      }
+    }
+
+  // Accumulate the product of a and b into c, using the widening kernel when
+  // the operands have reduced precision.
+  template <typename T, typename U, typename V>
+    inline Requires<!Widening<T, U>()>
+    select_product(std::size_t m, std::size_t n, std::size_t p,
+                   block<T> a, block<U> b, block<V> c)
+    {
+      product(m, n, p, a, b, c);
+    }
+
+  template <typename T, typename U, typename V>
+    inline Requires<Widening<T, U>()>
+    select_product(std::size_t m, std::size_t n, std::size_t p,
+                   block<T> a, block<U> b, block<V> c)
+    {
+      widening_product(m, n, p, a, b, c);
+    }
+
+  // Accumulate the product of the m x p block a and the p x n block b into
+  // the m x n block c. When the columns of c are contiguous (but not its
+  // rows), the transposed product c^T += b^T a^T is computed instead, so
+  // that the kernels write along the contiguous columns of c.
+  template <typename T, typename U, typename V>
+    inline void
+    general_product(std::size_t m, std::size_t n, std::size_t p,
+                    block<T> a, block<U> b, block<V> c)
+    {
+      if (c.rs == 1 && c.cs != 1)
+        select_product(n, m, p, transposed(b), transposed(a), transposed(c));
+      else
+        select_product(m, n, p, a, b, c);
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                            Blocked Product
+  //
+  // Large products are computed in blocks whose operands fit in cache. The
+  // inner dimension is split into runs of depth elements and the columns of
+  // b into panels. For each run and panel, the elements of b are packed
+  // into strips of a fixed width, and blocks of rows of a into strips of a
+  // fixed height, so that the tile kernel reads both operands contiguously
+  // whatever their strides. The strips are padded with zeros to their full
+  // size. Blocks of rows of c are computed concurrently.
+
+  // Computes a packed block of a product: adds the product of the m x p
+  // rows of a, packed in strips of height rows, and the p x n columns of b,
+  // packed in strips of width cols, into the m x n block c.
+  //
+  // Each tile of rows x cols elements of c is accumulated in a local array.
+  // Its loops have constant trip counts and do not alias c, so the compiler
+  // vectorizes them without run time checks.
+  template <typename V>
+    struct product_tile
+    {
+      static constexpr std::size_t rows = 6;
+      static constexpr std::size_t cols = 8;
+
+      template <typename T, typename U>
+        ORIGIN_MATRIX_SIMD_INLINE void
+        operator()(std::size_t m, std::size_t n, std::size_t p,
+                   const T* pa, const U* pb, V* c, std::size_t rs, std::size_t cs) const
+        {
+          for (std::size_t i0 = 0; i0 < m; i0 += rows) {
+            const T* ai = pa + i0 * p;
+            const std::size_t mr = m - i0 < rows ? m - i0 : rows;
+            for (std::size_t j0 = 0; j0 < n; j0 += cols) {
+              const U* bj = pb + j0 * p;
+              V s[rows][cols] = {};
+              for (std::size_t k = 0; k != p; ++k) {
+                const T* ak = ai + k * rows;
+                const U* bk = bj + k * cols;
+                for (std::size_t i = 0; i != rows; ++i)
+                  for (std::size_t j = 0; j != cols; ++j)
+                    s[i][j] += ak[i] * bk[j];
+              }
+              const std::size_t nr = n - j0 < cols ? n - j0 : cols;
+              for (std::size_t i = 0; i != mr; ++i)
+                for (std::size_t j = 0; j != nr; ++j)
+                  c[(i0 + i) * rs + (j0 + j) * cs] += s[i][j];
+            }
+          }
+        }
+    };
+
+#undef ORIGIN_MATRIX_SIMD_INLINE
+
+  // Copy the m x n block x into p in strips of w rows. Each strip is stored
+  // column by column, with the w elements of a column together. The rows of
+  // the last strip past m are zero. The columns of b are packed as the rows
+  // of its transpose.
+  template <typename T, typename U>
+    void
+    pack_strips(std::size_t m, std::size_t n, std::size_t w, block<T> x, U* p)
+    {
+      for (std::size_t i0 = 0; i0 < m; i0 += w) {
+        const std::size_t h = std::min(w, m - i0);
+        for (std::size_t k = 0; k != n; ++k) {
+          for (std::size_t i = 0; i != h; ++i)
+            p[i] = x(i0 + i, k);
+          std::fill(p + h, p + w, U(0));
+          p += w;
+        }
+      }
+    }
+
+  // Returns the number of elements of the strips of w lines holding m lines.
+  inline std::size_t
+  strip_size(std::size_t m, std::size_t w)
+  {
+    return (m + w - 1) / w * w;
+  }
+
+  // Accumulate the product of the m x p block a and the p x n block b into
+  // the m x n block c using the blocked kernel. The element types must not
+  // be widened.
+  template <typename T, typename U, typename V>
+    void
+    blocked_product(std::size_t m, std::size_t n, std::size_t p,
+                    block<T> a, block<U> b, block<V> c)
+    {
+      using A = Remove_const<T>;
+      using B = Remove_const<U>;
+      using K = product_tile<V>;
+      constexpr std::size_t depth = 256;
+      constexpr std::size_t panel = 1024;
+      constexpr std::size_t height = 96;
+
+      std::vector<B> pb(strip_size(std::min(n, panel), K::cols) * std::min(p, depth));
+      for (std::size_t j0 = 0; j0 < n; j0 += panel) {
+        const std::size_t nw = std::min(panel, n - j0);
+        for (std::size_t k0 = 0; k0 < p; k0 += depth) {
+          const std::size_t kw = std::min(depth, p - k0);
+          pack_strips(nw, kw, K::cols, transposed(subblock(b, k0, j0)), pb.data());
+
+          const std::size_t blocks = (m + height - 1) / height;
+          parallel_for(blocks, 1, [&](std::size_t first, std::size_t last) {
+            std::vector<A> pa(strip_size(height, K::rows) * kw);
+            for (std::size_t q = first; q != last; ++q) {
+              const std::size_t i0 = q * height;
+              const std::size_t mw = std::min(height, m - i0);
+              pack_strips(mw, kw, K::rows, subblock(a, i0, k0), pa.data());
+              V* ci = c.ptr + i0 * c.rs + j0 * c.cs;
+              sequence_impl::simd_run(K(), mw, nw, kw, pa.data(), pb.data(), ci, c.rs, c.cs);
+            }
+          });
+        }
+      }
+    }
+
+  // Accumulate the product of a and b into c as general_product does, using
+  // the blocked kernel when the product is large and not widened.
+  template <typename T, typename U, typename V>
+    inline Requires<Widening<T, U>()>
+    blocked_or_product(std::size_t m, std::size_t n, std::size_t p,
+                       block<T> a, block<U> b, block<V> c)
+    {
+      general_product(m, n, p, a, b, c);
+    }
+
+  template <typename T, typename U, typename V>
+    inline Requires<!Widening<T, U>()>
+    blocked_or_product(std::size_t m, std::size_t n, std::size_t p,
+                       block<T> a, block<U> b, block<V> c)
+    {
+      constexpr std::size_t min_work = 1 << 18;
+      if (m * n * p < min_work)
+        general_product(m, n, p, a, b, c);
+      else if (c.rs == 1 && c.cs != 1)
+        blocked_product(n, m, p, transposed(b), transposed(a), transposed(c));
+      else
+        blocked_product(m, n, p, a, b, c);
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                            Permutations
+  //
+  // The rows or columns of a block are exchanged and permuted a line at a
+  // time, where a line is a row or column of the block. When a line is
+  // contiguous, it is moved with std::copy_n and std::swap_ranges over
+  // pointers, which compile to memmove and vectorized loops.
+  //
+  // A permutation perm of n lines is given as a sequence of n distinct
+  // indexes; permuting by perm moves the original line perm[i] to
+  // position i.
+
+  // Copy the n elements at x, separated by stride xs, to the elements at y,
+  // separated by stride ys.
+  template <typename T>
+    inline void
+    copy_line(std::size_t n, const T* x, std::size_t xs, T* y, std::size_t ys)
+    {
+      if (xs == 1 && ys == 1)
+        std::copy_n(x, n, y);
+      else
+        for (std::size_t k = 0; k != n; ++k)
+          y[k * ys] = x[k * xs];
+    }
+
+  // Exchange the n elements at x with the n elements at y. The elements of
+  // both lines are separated by stride s.
+  template <typename T>
+    inline void
+    swap_lines(std::size_t n, T* x, T* y, std::size_t s)
+    {
+      if (s == 1)
+        std::swap_ranges(x, x + n, y);
+      else
+        for (std::size_t k = 0; k != n; ++k)
+          std::swap(x[k * s], y[k * s]);
+    }
+
+  // Returns true if the n indexes in perm are a permutation of [0, n).
+  inline bool
+  valid_permutation(std::size_t n, const std::size_t* perm)
+  {
+    std::vector<bool> seen(n);
+    for (std::size_t i = 0; i != n; ++i) {
+      if (perm[i] >= n || seen[perm[i]])
+        return false;
+      seen[perm[i]] = true;
+    }
+    return true;
+  }
+
+  // Permute the rows of the m x n block a by perm.
+  //
+  // When the elements of each row are closer together than the rows
+  // themselves (e.g., a row-major block), the rows are moved in place by
+  // following the cycles of the permutation: the first row of a cycle is
+  // saved in a buffer, and each other row is moved once into the place
+  // of its predecessor. Otherwise, each column of a is gathered into a
+  // buffer and copied back, so that memory is still traversed along the
+  // contiguous columns.
+  template <typename T>
+    void
+    permute_rows(std::size_t m, std::size_t n, block<T> a, const std::size_t* perm)
+    {
+      assert(valid_permutation(m, perm));
+      if (a.cs <= a.rs) {
+        std::vector<T> t(n);
+        std::vector<bool> done(m);
+        for (std::size_t s = 0; s != m; ++s) {
+          if (done[s] || perm[s] == s)
+            continue;
+          copy_line(n, &a(s, 0), a.cs, t.data(), 1);
+          std::size_t i = s;
+          for (std::size_t j = perm[i]; j != s; i = j, j = perm[j]) {
+            copy_line(n, &a(j, 0), a.cs, &a(i, 0), a.cs);
+            done[i] = true;
+          }
+          copy_line(n, t.data(), 1, &a(i, 0), a.cs);
+          done[i] = true;
+        }
+      } else {
+        std::vector<T> t(m);
+        for (std::size_t j = 0; j != n; ++j) {
+          T* c = &a(0, j);
+          for (std::size_t i = 0; i != m; ++i)
+            t[i] = c[perm[i] * a.rs];
+          copy_line(m, t.data(), 1, c, a.rs);
+        }
+      }
+    }
+
+  // Permute the columns of the m x n block a by perm.
+  template <typename T>
+    inline void
+    permute_cols(std::size_t m, std::size_t n, block<T> a, const std::size_t* perm)
+    {
+      permute_rows(n, m, transposed(a), perm);
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                          LU Factorization
+  //
+  // Factor the n x n block a in place as P A = L U using Gaussian elimination
+  // with partial pivoting. L is unit lower triangular and is stored below
+  // the diagonal; U is stored on and above the diagonal. The row exchanged
+  // with row i is recorded in piv[i].
+  //
+  // Returns false if a is singular, in which case the contents of a and piv
+  // are unspecified.
+  template <typename T>
+    bool
+    lu_factor(std::size_t n, block<T> a, std::size_t* piv)
+    {
+      using std::abs;
+      for (std::size_t j = 0; j != n; ++j) {
+        std::size_t p = j;
+        for (std::size_t i = j + 1; i != n; ++i)
+          if (abs(a(i, j)) > abs(a(p, j)))
+            p = i;
+        piv[j] = p;
+        if (a(p, j) == T(0))
+          return false;
+        if (p != j)
+          swap_lines(n, &a(j, 0), &a(p, 0), a.cs);
+
+        const T d = a(j, j);
+        for (std::size_t i = j + 1; i != n; ++i) {
+          const T f = a(i, j) /= d;
+          for (std::size_t k = j + 1; k != n; ++k)
+            a(i, k) -= f * a(j, k);
+        }
+      }
+      return true;
+    }
+
+  // Solve A X = B given the factorization of A computed by lu_factor. The
+  // n x r block b is overwritten by the solution X.
+  template <typename T, typename U>
+    void
+    lu_solve(std::size_t n, std::size_t r, block<T> lu, const std::size_t* piv,
+             block<U> b)
+    {
+      // Apply the row exchanges.
+      for (std::size_t i = 0; i != n; ++i)
+        if (piv[i] != i)
+          swap_lines(r, &b(i, 0), &b(piv[i], 0), b.cs);
+
+      // Forward substitution with L.
+      for (std::size_t i = 1; i < n; ++i)
+        for (std::size_t j = 0; j != i; ++j)
+          for (std::size_t k = 0; k != r; ++k)
+            b(i, k) -= lu(i, j) * b(j, k);
+
+      // Back substitution with U.
+      for (std::size_t i = n; i-- != 0; ) {
+        for (std::size_t j = i + 1; j < n; ++j)
+          for (std::size_t k = 0; k != r; ++k)
+            b(i, k) -= lu(i, j) * b(j, k);
+        for (std::size_t k = 0; k != r; ++k)
+          b(i, k) /= lu(i, i);
+      }
+    }
+
+  // Solve A^T x = b given the factorization of A computed by lu_factor. The
+  // n elements of b are overwritten by the solution x. Since A^T = U^T L^T P,
+  // this solves with U^T and L^T and then undoes the row exchanges.
+  template <typename T, typename U>
+    void
+    lu_solve_transposed(std::size_t n, block<T> lu, const std::size_t* piv, U* b)
+    {
+      // Forward substitution with U^T.
+      for (std::size_t i = 0; i != n; ++i) {
+        for (std::size_t j = 0; j != i; ++j)
+          b[i] -= lu(j, i) * b[j];
+        b[i] /= lu(i, i);
+      }
+
+      // Back substitution with L^T.
+      for (std::size_t i = n; i-- != 0; )
+        for (std::size_t j = i + 1; j < n; ++j)
+          b[i] -= lu(j, i) * b[j];
+
+      // Undo the row exchanges in reverse order.
+      for (std::size_t i = n; i-- != 0; )
+        if (piv[i] != i)
+          std::swap(b[i], b[piv[i]]);
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                        Blocked LU Factorization
+  //
+  // The blocked factorization computes the same factors as lu_factor, but
+  // performs most of its arithmetic in matrix products. The columns are
+  // processed in panels of lu_panel columns. For each panel:
+  //
+  //    1. Factor the panel (the columns of the panel on and below the
+  //       diagonal) with partial pivoting, exchanging whole rows.
+  //    2. Solve L11 U12 = A12 for the rows of U to the right of the panel.
+  //    3. Update the trailing matrix A22 -= L21 U12.
+  //
+  // Step 3 accounts for nearly all of the work and is computed by the
+  // product kernels. Without blocking, each column updates the entire
+  // trailing matrix, which is streamed through the cache n times.
+  constexpr std::size_t lu_panel = 64;
+
+  // Returns the number of elements of workspace needed by the blocked LU
+  // factorization of an n x n block. The workspace holds the negated L21
+  // factor of a panel.
+  inline std::size_t
+  lu_workspace(std::size_t n)
+  {
+    return n > lu_panel ? (n - lu_panel) * lu_panel : 0;
+  }
+
+  // Factor the n x n block a in place as P A = L U. The factors and the row
+  // exchanges are stored as by lu_factor. The workspace ws must hold at
+  // least lu_workspace(n) elements.
+  //
+  // Returns false if a is singular, in which case the contents of a and piv
+  // are unspecified.
+  template <typename T>
+    bool
+    blocked_lu_factor(std::size_t n, block<T> a, std::size_t* piv, T* ws)
+    {
+      using std::abs;
+      if (n <= lu_panel)
+        return lu_factor(n, a, piv);
+
+      for (std::size_t j0 = 0; j0 < n; j0 += lu_panel) {
+        const std::size_t j1 = std::min(j0 + lu_panel, n);
+
+        // Factor the panel.
+        for (std::size_t j = j0; j != j1; ++j) {
+          std::size_t p = j;
+          for (std::size_t i = j + 1; i != n; ++i)
+            if (abs(a(i, j)) > abs(a(p, j)))
+              p = i;
+          piv[j] = p;
+          if (a(p, j) == T(0))
+            return false;
+          if (p != j)
+            swap_lines(n, &a(j, 0), &a(p, 0), a.cs);
+
+          const T d = a(j, j);
+          for (std::size_t i = j + 1; i != n; ++i) {
+            const T f = a(i, j) /= d;
+            for (std::size_t k = j + 1; k != j1; ++k)
+              a(i, k) -= f * a(j, k);
+          }
+        }
+        if (j1 == n)
+          break;
+
+        // Compute U12 by forward substitution with the unit lower
+        // triangular L11.
+        for (std::size_t i = j0 + 1; i != j1; ++i)
+          for (std::size_t j = j0; j != i; ++j) {
+            const T f = a(i, j);
+            for (std::size_t k = j1; k != n; ++k)
+              a(i, k) -= f * a(j, k);
+          }
+
+        // Update the trailing matrix. The product kernels accumulate, so
+        // the update adds (-L21) U12.
+        const std::size_t m = n - j1;
+        const std::size_t w = j1 - j0;
+        for (std::size_t i = 0; i != m; ++i)
+          for (std::size_t j = 0; j != w; ++j)
+            ws[i * w + j] = -a(j1 + i, j0 + j);
+        general_product(m, m, w, block<T>{ws, w, 1}, subblock(a, j0, j1),
+                        subblock(a, j1, j1));
+      }
+      return true;
+    }
+
+} // namespace matrix_impl
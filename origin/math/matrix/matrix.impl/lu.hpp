@@ -0,0 +1,409 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+
+// -------------------------------------------------------------------------- //
+//                    Inverse, Determinant and Condition
+//
+// The inverse, determinant and condition number of a square matrix are
+// computed from its LU factorization with partial pivoting. Matrices of
+// order 4 or less use the closed forms of static_matrix instead.
+//
+// An lu_factorization object retains the factors and the workspace of the
+// blocked factorization, so factoring a sequence of matrices of the same
+// size with one object does not allocate:
+//
+//    lu_factorization<double> lu;
+//    for (const matrix<double, 2>& a : systems) {
+//      if (!lu.factor(a))
+//        continue;                         // a is singular
+//      lu.solve(b);
+//      ...
+//    }
+
+
+// LU factorization
+//
+// The factorization P A = L U of a square matrix A, where P is a
+// permutation, L is unit lower triangular and U is upper triangular.
+template <typename T>
+  class lu_factorization
+  {
+  public:
+    lu_factorization()
+      : ok(false), norm(0)
+    { }
+
+    // Factor the square matrix a, replacing any previous factorization.
+    // Returns false if a is singular.
+    template <typename M>
+      bool factor(const M& a);
+
+    // Returns the order of the factored matrix.
+    std::size_t size() const { return piv.size(); }
+
+    // Returns true if the factored matrix is singular.
+    bool singular() const { return !ok; }
+
+    // Returns the determinant of the factored matrix.
+    T determinant() const;
+
+    // Returns the logarithm of the absolute value of the determinant of the
+    // factored matrix, and sets sign to the sign of the determinant (-1, 0
+    // or 1). This does not overflow when the determinant is not
+    // representable. If the matrix is singular, sign is 0 and the result is
+    // negative infinity.
+    T log_determinant(int& sign) const;
+
+    // Overwrite the vector or the columns of the matrix b with the solution
+    // x of A x = b. The factored matrix must not be singular.
+    template <typename M>
+      void solve(M& b) const;
+
+    // Store the inverse of the factored matrix in x. The factored matrix
+    // must not be singular.
+    void inverse(matrix<T, 2>& x) const;
+
+    // Returns an estimate of the condition number of the factored matrix in
+    // the 1-norm, or infinity if the matrix is singular. See
+    // condition_estimate.
+    T condition_estimate() const;
+
+  private:
+    matrix_impl::block<const T> factors() const { return {lu.data(), size(), 1}; }
+
+    // Returns the 1-norm of x.
+    static T norm1(const std::vector<T>& x);
+
+    matrix<T, 2> lu;
+    std::vector<std::size_t> piv;
+    std::vector<T> work;
+    std::vector<T> sums;            // The column sums of the norm
+    bool ok;
+    T norm;                         // The 1-norm of the factored matrix
+  };
+
+
+template <typename T>
+  template <typename M>
+    bool
+    lu_factorization<T>::factor(const M& a)
+    {
+      static_assert(M::order == 2, "");
+      using std::abs;
+      const std::size_t n = a.rows();
+      assert(a.cols() == n);
+
+      // Reuse the storage of the previous factorization when possible.
+      if (lu.rows() != n)
+        lu = matrix<T, 2>(n, n);
+      piv.resize(n);
+      work.resize(matrix_impl::lu_workspace(n));
+
+      norm = T(0);
+      sums.assign(n, T(0));
+      for (std::size_t i = 0; i != n; ++i)
+        for (std::size_t j = 0; j != n; ++j) {
+          lu(i, j) = a(i, j);
+          sums[j] += abs(lu(i, j));
+        }
+      for (std::size_t j = 0; j != n; ++j)
+        norm = std::max(norm, sums[j]);
+
+      matrix_impl::block<T> f {lu.data(), n, 1};
+      ok = matrix_impl::blocked_lu_factor(n, f, piv.data(), work.data());
+      return ok;
+    }
+
+template <typename T>
+  T
+  lu_factorization<T>::determinant() const
+  {
+    if (!ok)
+      return T(0);
+    T d = T(1);
+    for (std::size_t i = 0; i != size(); ++i)
+      d *= piv[i] == i ? lu(i, i) : -lu(i, i);
+    return d;
+  }
+
+template <typename T>
+  T
+  lu_factorization<T>::log_determinant(int& sign) const
+  {
+    using std::abs;
+    using std::log;
+    if (!ok) {
+      sign = 0;
+      return -std::numeric_limits<T>::infinity();
+    }
+    sign = 1;
+    T s = T(0);
+    for (std::size_t i = 0; i != size(); ++i) {
+      const T u = lu(i, i);
+      if ((u < T(0)) != (piv[i] != i))
+        sign = -sign;
+      s += log(abs(u));
+    }
+    return s;
+  }
+
+template <typename T>
+  template <typename M>
+    void
+    lu_factorization<T>::solve(M& b) const
+    {
+      static_assert(M::order == 1 || M::order == 2, "");
+      assert(ok);
+      assert(b.extent(0) == size());
+      const auto& d = b.descriptor();
+      const std::size_t r = M::order == 2 ? d.extents[M::order - 1] : 1;
+      const std::size_t cs = M::order == 2 ? d.strides[M::order - 1] : 0;
+      matrix_impl::block<Value_type<M>> y {b.data() + d.start, d.strides[0], cs};
+      matrix_impl::lu_solve(size(), r, factors(), piv.data(), y);
+    }
+
+// The inverse is the solution of A X = I.
+template <typename T>
+  void
+  lu_factorization<T>::inverse(matrix<T, 2>& x) const
+  {
+    assert(ok);
+    const std::size_t n = size();
+    if (x.rows() != n || x.cols() != n)
+      x = matrix<T, 2>(n, n);
+    x = T(0);
+    for (std::size_t i = 0; i != n; ++i)
+      x(i, i) = T(1);
+    solve(x);
+  }
+
+// The estimate of the 1-norm of the inverse is computed by Hager's method
+// as refined by Higham (LAPACK's xLACON), which needs only a few solves
+// with A and A^T. It is exact for most matrices and is rarely smaller than
+// the true norm by more than a factor of 3.
+template <typename T>
+  T
+  lu_factorization<T>::condition_estimate() const
+  {
+    using std::abs;
+    if (!ok)
+      return std::numeric_limits<T>::infinity();
+    const std::size_t n = size();
+    if (n == 0)
+      return T(0);
+    const matrix_impl::block<const T> f = factors();
+
+    // Maximize |A^-1 x| over the vertices of the unit ball, starting from
+    // the vector of equal weights. The subgradient z = A^-T sign(A^-1 x)
+    // selects the next vertex.
+    std::vector<T> x(n, T(1) / T(n));
+    std::vector<T> y(n);
+    T est = T(0);
+    std::size_t last = n;
+    for (int iter = 0; iter != 5; ++iter) {
+      y = x;
+      matrix_impl::lu_solve(n, 1, f, piv.data(), matrix_impl::block<T>{y.data(), 1, 0});
+      const T ny = norm1(y);
+      if (iter != 0 && ny <= est)
+        break;
+      est = ny;
+
+      for (T& v : y)
+        v = v < T(0) ? T(-1) : T(1);
+      matrix_impl::lu_solve_transposed(n, f, piv.data(), y.data());
+      std::size_t j = 0;
+      for (std::size_t i = 1; i != n; ++i)
+        if (abs(y[i]) > abs(y[j]))
+          j = i;
+      T zx = T(0);
+      for (std::size_t i = 0; i != n; ++i)
+        zx += y[i] * x[i];
+      if (iter != 0 && (j == last || abs(y[j]) <= zx))
+        break;
+      std::fill(x.begin(), x.end(), T(0));
+      x[j] = T(1);
+      last = j;
+    }
+
+    // Guard against a poor estimate with an alternating vector of
+    // increasing weights.
+    for (std::size_t i = 0; i != n; ++i) {
+      const T w = T(1) + T(i) / T(std::max<std::size_t>(n - 1, 1));
+      x[i] = i % 2 ? -w : w;
+    }
+    matrix_impl::lu_solve(n, 1, f, piv.data(), matrix_impl::block<T>{x.data(), 1, 0});
+    est = std::max(est, T(2) * norm1(x) / T(3 * n));
+
+    return norm * est;
+  }
+
+template <typename T>
+  T
+  lu_factorization<T>::norm1(const std::vector<T>& x)
+  {
+    using std::abs;
+    T s = T(0);
+    for (const T& v : x)
+      s += abs(v);
+    return s;
+  }
+
+
+namespace matrix_impl
+{
+  // Store the static matrix s in the matrix x.
+  template <typename T, std::size_t N>
+    void
+    assign_static(const static_matrix<T, N, N>& s, matrix<T, 2>& x)
+    {
+      if (x.rows() != N || x.cols() != N)
+        x = matrix<T, 2>(N, N);
+      for (std::size_t i = 0; i != N; ++i)
+        for (std::size_t j = 0; j != N; ++j)
+          x(i, j) = s(i, j);
+    }
+
+  // Returns the 1-norm (the maximum absolute column sum) of s.
+  template <typename T, std::size_t N>
+    T
+    static_norm1(const static_matrix<T, N, N>& s)
+    {
+      using std::abs;
+      T r = T(0);
+      for (std::size_t j = 0; j != N; ++j) {
+        T c = T(0);
+        for (std::size_t i = 0; i != N; ++i)
+          c += abs(s(i, j));
+        r = std::max(r, c);
+      }
+      return r;
+    }
+
+  // The closed forms for an N x N matrix a, where N is at most 4.
+  template <std::size_t N, typename M>
+    inline Value_type<M>
+    small_determinant(const M& a)
+    {
+      return determinant(static_matrix<Value_type<M>, N, N>(a));
+    }
+
+  template <std::size_t N, typename M, typename T>
+    bool
+    small_inverse(const M& a, matrix<T, 2>& x)
+    {
+      const static_matrix<T, N, N> s(a);
+      if (determinant(s) == T(0))
+        return false;
+      assign_static(inverse(s), x);
+      return true;
+    }
+
+  // The condition number of a small matrix is computed exactly.
+  template <std::size_t N, typename M>
+    Value_type<M>
+    small_condition(const M& a)
+    {
+      using T = Value_type<M>;
+      const static_matrix<T, N, N> s(a);
+      if (determinant(s) == T(0))
+        return std::numeric_limits<T>::infinity();
+      return static_norm1(s) * static_norm1(inverse(s));
+    }
+
+} // namespace matrix_impl
+
+
+// Inverse
+//
+// Compute the inverse of the square matrix a and store it in x. Returns
+// false if a is singular, in which case x is unspecified.
+template <typename M, typename T>
+  bool
+  inverse(const M& a, matrix<T, 2>& x)
+  {
+    static_assert(M::order == 2, "");
+    assert(a.rows() == a.cols());
+    switch (a.rows()) {
+    case 1: return matrix_impl::small_inverse<1>(a, x);
+    case 2: return matrix_impl::small_inverse<2>(a, x);
+    case 3: return matrix_impl::small_inverse<3>(a, x);
+    case 4: return matrix_impl::small_inverse<4>(a, x);
+    }
+    lu_factorization<T> lu;
+    if (!lu.factor(a))
+      return false;
+    lu.inverse(x);
+    return true;
+  }
+
+
+// Determinant
+//
+// Returns the determinant of the square matrix a. The determinant of a
+// large matrix easily overflows or underflows; see log_determinant.
+template <typename M, typename = Requires<M::order == 2>>
+  Value_type<M>
+  determinant(const M& a)
+  {
+    assert(a.rows() == a.cols());
+    switch (a.rows()) {
+    case 0: return Value_type<M>(1);
+    case 1: return matrix_impl::small_determinant<1>(a);
+    case 2: return matrix_impl::small_determinant<2>(a);
+    case 3: return matrix_impl::small_determinant<3>(a);
+    case 4: return matrix_impl::small_determinant<4>(a);
+    }
+    lu_factorization<Value_type<M>> lu;
+    lu.factor(a);
+    return lu.determinant();
+  }
+
+
+// Log determinant
+//
+// Returns the logarithm of the absolute value of the determinant of the
+// square matrix a, and sets sign to the sign of the determinant (-1, 0 or
+// 1). If a is singular, the result is negative infinity.
+template <typename M>
+  Value_type<M>
+  log_determinant(const M& a, int& sign)
+  {
+    static_assert(M::order == 2, "");
+    lu_factorization<Value_type<M>> lu;
+    lu.factor(a);
+    return lu.log_determinant(sign);
+  }
+
+
+// Condition estimate
+//
+// Returns an estimate of the condition number ||a|| ||a^-1|| of the square
+// matrix a in the 1-norm, or infinity if a is singular. The norm of the
+// inverse is estimated from the LU factorization without computing the
+// inverse, so the cost is dominated by the factorization. For matrices of
+// order 4 or less, the condition number is computed exactly.
+template <typename M>
+  Value_type<M>
+  condition_estimate(const M& a)
+  {
+    static_assert(M::order == 2, "");
+    assert(a.rows() == a.cols());
+    switch (a.rows()) {
+    case 1: return matrix_impl::small_condition<1>(a);
+    case 2: return matrix_impl::small_condition<2>(a);
+    case 3: return matrix_impl::small_condition<3>(a);
+    case 4: return matrix_impl::small_condition<4>(a);
+    }
+    lu_factorization<Value_type<M>> lu;
+    lu.factor(a);
+    return lu.condition_estimate();
+  }
@@ -28,15 +28,18 @@
 // Template Parameters:
 //    T -- The eleemnt type stored by the matrix
 //    N -- The matrix order (number of extents).
-template <typename T, std::size_t N>
+//    A -- The allocator of the elements. See pool_allocator for an
+//         allocator that recycles large buffers.
+template <typename T, std::size_t N, typename A>
   class matrix
   {
   public:
     static constexpr std::size_t order = N;
 
     using value_type     = T;
-    using iterator       = typename std::vector<T>::iterator;
-    using const_iterator = typename std::vector<T>::const_iterator;
+    using allocator_type = A;
+    using iterator       = typename std::vector<T, A>::iterator;
+    using const_iterator = typename std::vector<T, A>::const_iterator;
 
 
     // Default construction
@@ -61,9 +64,14 @@ template <typename T, std::size_t N>
     // the copy.
     //
     // The order of the two matrices must be the same, and the value type of
-    // M must be convertible to this matrix's value type.
+    // M must be convertible to this matrix's value type. The resulting
+    // matrix is row-major, regardless of the layout of x.
     template <typename M, typename = Requires<Matrix<M>()>>
       matrix(const M& x);
+
+    // Initialize this matrix by copying the matrix x into the layout, l.
+    template <typename M, typename = Requires<Matrix<M>()>>
+      matrix(const M& x, matrix_layout l);
     
     template <typename M, typename = Requires<Matrix<M>()>>
       matrix& operator=(const M& x);
@@ -89,10 +97,23 @@ template <typename T, std::size_t N>
     // TODO: Create overloads that allow the specification of a default
     // value as the last argument and one that allows the specification of
     // a default value and an allocator as the last pairs of arguments.
-    template <typename... Dims>
+    template <typename... Dims, 
+              typename = Requires<matrix_impl::Index_sequence<Dims...>()>>
       explicit
       matrix(Dims... dims);
 
+    // Layout initialization
+    //
+    // Initialize the matrix with the given dimensions, storing its elements
+    // in the layout, l. All elements are default initialized. For example:
+    //
+    //    matrix<double, 2> m(matrix_layout::column_major, 3, 4);
+    //
+    // creates a 3 x 4 matrix whose columns are contiguous.
+    template <typename... Dims>
+      explicit
+      matrix(matrix_layout l, Dims... dims);
+
 
     // Value initialization
     //
@@ -125,6 +146,9 @@ template <typename T, std::size_t N>
     // Returns the total number of elements contained in the matrix.
     std::size_t size() const { return desc.size; }
 
+    // Returns the layout of the elements in memory.
+    matrix_layout layout() const { return origin::layout(desc); }
+
 
     // Subscripting
     //
@@ -201,7 +225,8 @@ template <typename T, std::size_t N>
     // Iterators
     //
     // The begin() and end() functions return iterators over the underlying
-    // data in the matrix. It is not structured.
+    // data in the matrix. It is not structured: the elements are visited in
+    // memory order, which is column order for a column-major matrix.
     //
     // TODO: Write iterators over rows and columns.
     iterator begin() { return elems.begin(); }
@@ -217,6 +242,15 @@ template <typename T, std::size_t N>
     void swap_rows(std::size_t m, std::size_t n);
     void clear();
 
+    // Row and column permutation
+    //
+    // Exchange two columns of a 2D matrix, or reorder its rows or columns
+    // so that row (or column) i is the original row perm[i]. The sequence
+    // perm must be a permutation of the row (or column) indexes.
+    void swap_cols(std::size_t m, std::size_t n);
+    void permute_rows(const std::vector<std::size_t>& perm);
+    void permute_cols(const std::vector<std::size_t>& perm);
+
   private:
     void make_slice(matrix_slice<N>&, std::size_t);
     void make_slice(matrix_slice<N>&, std::size_t, std::size_t);
@@ -224,47 +258,66 @@ template <typename T, std::size_t N>
 
   private:
     matrix_slice<N> desc; // Describing slice
-    std::vector<T> elems; // Underlying elements
+    std::vector<T, A> elems; // Underlying elements
   };
 
 
-template <typename T, std::size_t N>
+// The elements of x are copied by index rather than in iteration order, so
+// that matrices with different layouts are copied correctly.
+template <typename T, std::size_t N, typename A>
   template <typename M, typename X>
   inline
-  matrix<T, N>::matrix(const M& x)
-    : desc(x.descriptor()), elems(x.begin(), x.end())
+  matrix<T, N, A>::matrix(const M& x)
+    : matrix(x, matrix_layout::row_major)
+  { }
+
+template <typename T, std::size_t N, typename A>
+  template <typename M, typename X>
+  inline
+  matrix<T, N, A>::matrix(const M& x, matrix_layout l)
+    : desc(0, x.descriptor().extents, l), elems(desc.size)
   {
     static_assert(Convertible<Value_type<M>, T>(), "");
+    using U = Value_type<M>;
+    matrix_impl::elementwise(desc, data(), x.descriptor(), x.data(),
+                             [](T& t, const U& u) { t = u; });
   }
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   template <typename M, typename X>
-  inline matrix<T, N>&
-  matrix<T, N>::operator=(const M& x)
+  inline matrix<T, N, A>&
+  matrix<T, N, A>::operator=(const M& x)
   {
-    desc = x.descriptor();
-    elems.assign(x.begin(), x.end());
+    matrix tmp(x);
+    swap(tmp);
     return*this;
   }
 
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   inline
-  matrix<T, N>::matrix(const matrix_slice<N>& slice)
+  matrix<T, N, A>::matrix(const matrix_slice<N>& slice)
     : desc(0, slice.extents), elems(desc.size)
   { }
 
 
-template <typename T, std::size_t N>
-  template <typename... Dims>
+template <typename T, std::size_t N, typename A>
+  template <typename... Dims, typename X>
     inline
-    matrix<T, N>::matrix(Dims... dims)
+    matrix<T, N, A>::matrix(Dims... dims)
       : desc(0, {std::size_t(dims)...}), elems(desc.size)
     { }
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
+  template <typename... Dims>
+    inline
+    matrix<T, N, A>::matrix(matrix_layout l, Dims... dims)
+      : desc(0, {std::size_t(dims)...}, l), elems(desc.size)
+    { }
+
+template <typename T, std::size_t N, typename A>
   inline
-  matrix<T, N>::matrix(matrix_initializer<T, N> init)
+  matrix<T, N, A>::matrix(matrix_initializer<T, N> init)
     : desc(0, matrix_impl::derive_extents<N>(init))
   {
     // matrix_impl::derive_extents(desc.extents, init);
@@ -273,9 +326,9 @@ template <typename T, std::size_t N>
     assert(elems.size() == desc.size);
   }
 
-template <typename T, std::size_t N>
-  inline matrix<T, N>&
-  matrix<T, N>::operator=(matrix_initializer<T, N> init)
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>&
+  matrix<T, N, A>::operator=(matrix_initializer<T, N> init)
   {
     matrix tmp(init);
     swap(tmp);
@@ -285,37 +338,37 @@ template <typename T, std::size_t N>
 
 // Subscripting
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   template <typename... Args>
     inline Requires<matrix_impl::Index_sequence<Args...>(), T&>
-    matrix<T, N>::operator()(Args... args)
+    matrix<T, N, A>::operator()(Args... args)
     {
       assert(matrix_impl::check_bounds(desc, args...));
       return *(data() + desc(args...));
     }
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   template <typename... Args>
     inline Requires<matrix_impl::Index_sequence<Args...>(), const T&>
-    matrix<T, N>::operator()(Args... args) const
+    matrix<T, N, A>::operator()(Args... args) const
     {
       assert(matrix_impl::check_bounds(desc, args...));
       return *(data() + desc(args...));
     }
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   template <typename... Args>
     inline Requires<matrix_impl::Slice_sequence<Args...>(), matrix_ref<T, N>>
-    matrix<T, N>::operator()(const Args&... args)
+    matrix<T, N, A>::operator()(const Args&... args)
     {
       matrix_slice<N> d {desc, args...};
       return {d, data()};
     }
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   template <typename... Args>
     inline Requires<matrix_impl::Slice_sequence<Args...>(), matrix_ref<const T, N>>
-    matrix<T, N>::operator()(const Args&... args) const
+    matrix<T, N, A>::operator()(const Args&... args) const
     {
       matrix_slice<N> d {desc, args...};
       return {d, data()};
@@ -323,18 +376,18 @@ template <typename T, std::size_t N>
 
 // Row
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   inline matrix_ref<T, N-1>
-  matrix<T, N>::row(std::size_t n)
+  matrix<T, N, A>::row(std::size_t n)
   {
     assert(n < rows());
     matrix_slice<N-1> row(desc, size_constant<0>(), n);
     return {row, data()};
   }
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   inline matrix_ref<const T, N-1>
-  matrix<T, N>::row(std::size_t n) const
+  matrix<T, N, A>::row(std::size_t n) const
   {
     assert(n < rows());
     matrix_slice<N-1> row(desc, size_constant<0>(), n);
@@ -343,18 +396,18 @@ template <typename T, std::size_t N>
 
 // Column
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   inline matrix_ref<T, N-1>
-  matrix<T, N>::col(std::size_t n)
+  matrix<T, N, A>::col(std::size_t n)
   {
     assert(n < cols());
     matrix_slice<N-1> col(desc, size_constant<1>(), n);
     return {col, data()};
   }
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   inline matrix_ref<const T, N-1>
-  matrix<T, N>::col(std::size_t n) const
+  matrix<T, N, A>::col(std::size_t n) const
   {
     assert(n < cols());
     matrix_slice<N-1> col(desc, size_constant<1>(), n);
@@ -363,120 +416,154 @@ template <typename T, std::size_t N>
 
 
 // Scalar applicateion
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   template <typename F>
-    inline matrix<T, N>&
-    matrix<T, N>::apply(F f)
+    inline matrix<T, N, A>&
+    matrix<T, N, A>::apply(F f)
     {
       for (auto& x : elems)
         f(x);
       return *this;
     }
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   template <typename M, typename F>
-    inline matrix<T, N>&
-    matrix<T, N>::apply(const M& m, F f)
+    inline matrix<T, N, A>&
+    matrix<T, N, A>::apply(const M& m, F f)
     {
-      assert(same_extents(desc, m.descriptor()));
-      auto i = begin();
-      auto j = m.begin();
-      while (i != end()) {
-        f(*i, *j);
-        ++i;
-        ++j;
-      }
+      matrix_slice<N> b = matrix_impl::broadcast_slice<N>(m.descriptor(), desc.extents);
+      matrix_impl::elementwise(desc, data(), b, m.data(), f);
       return *this;
     }
 
 // Scalar assignment
-template <typename T, std::size_t N>
-  inline matrix<T, N>& 
-  matrix<T, N>::operator=(const T& x) 
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>& 
+  matrix<T, N, A>::operator=(const T& x) 
   { 
-    return apply([&](T& x) { x = x; });
+    return apply([&](T& y) { y = x; });
   }
 
 // Scalar addition
-template <typename T, std::size_t N>
-  inline matrix<T, N>& 
-  matrix<T, N>::operator+=(const T& x) 
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>& 
+  matrix<T, N, A>::operator+=(const T& x) 
   { 
     return apply([&](T& y) { y += x; });
   }
 
 // Scalar subtraction      
-template <typename T, std::size_t N>
-  inline matrix<T, N>& 
-  matrix<T, N>::operator-=(const T& x) 
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>& 
+  matrix<T, N, A>::operator-=(const T& x) 
   {
     return apply([&](T& y) { y -= x; });
   }
 
 // Scalar multiplication
-template <typename T, std::size_t N>
-  inline matrix<T, N>& 
-  matrix<T, N>::operator*=(const T& x) 
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>& 
+  matrix<T, N, A>::operator*=(const T& x) 
   { 
     return apply([&](T& y) { y *= x; });
   }
 
 // Scalar division
-template <typename T, std::size_t N>
-  inline matrix<T, N>& 
-  matrix<T, N>::operator/=(const T& x) 
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>& 
+  matrix<T, N, A>::operator/=(const T& x) 
   { 
     return apply([&](T& y) { y /= x; });
   }
 
 // Scalar remainder    
-template <typename T, std::size_t N>
-  inline matrix<T, N>& 
-  matrix<T, N>::operator%=(const T& x) 
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>& 
+  matrix<T, N, A>::operator%=(const T& x) 
   { 
     return apply([&](T& y) { y %= x; });
   }
 
-// NOTE: Matrix addition and subtraction require the arguments to have the
-// same order, dimensions, and size. It must be the case that if two matrices
-// have the same dimensions, then they have the same size.
+// NOTE: Matrix addition and subtraction require the extents of the argument
+// to be broadcastable to the extents of this matrix. A matrix of lower order,
+// or with an extent of 1 in some dimension, is repeated across the missing
+// dimensions. For example, adding a 1D matrix of n elements to an m x n
+// matrix adds the vector to each row.
 
 // Matrix addition
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   template <typename M>
-    inline matrix<T, N>&
-    matrix<T, N>::operator+=(const M& m)
+    inline matrix<T, N, A>&
+    matrix<T, N, A>::operator+=(const M& m)
     {
       using U = Value_type<M>;
       return apply(m, [&](T& t, const U& u) { t += u; });
     }
 
 // Matrix subtraction
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   template <typename M>
-    inline matrix<T, N>&
-    matrix<T, N>::operator-=(const M& m)
+    inline matrix<T, N, A>&
+    matrix<T, N, A>::operator-=(const M& m)
     {
       using U = Value_type<M>;
       return apply(m, [&](T& t, const U& u) { t -= u; });
     }
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   inline void
-  matrix<T, N>::swap(matrix& x)
+  matrix<T, N, A>::swap(matrix& x)
   {
     using std::swap;
     swap(desc, x.desc);
     elems.swap(x.elems);
   }
 
-template <typename T, std::size_t N>
+// When the 0th dimension is outermost, each row is a contiguous range of
+// elements, and the rows are exchanged directly.
+template <typename T, std::size_t N, typename A>
+  inline void
+  matrix<T, N, A>::swap_rows(std::size_t m, std::size_t n)
+  {
+    assert(m < rows() && n < rows());
+    const std::size_t s = desc.strides[0];
+    if (s * rows() == size()) {
+      matrix_impl::swap_lines(s, data() + m * s, data() + n * s, 1);
+    } else {
+      auto a = (*this)[m];
+      auto b = (*this)[n];
+      std::swap_ranges(a.begin(), a.end(), b.begin());
+    }
+  }
+
+template <typename T, std::size_t N, typename A>
+  inline void
+  matrix<T, N, A>::swap_cols(std::size_t m, std::size_t n)
+  {
+    static_assert(N == 2, "");
+    assert(m < cols() && n < cols());
+    auto b = matrix_impl::make_block(data(), desc);
+    matrix_impl::swap_lines(rows(), &b(0, m), &b(0, n), b.rs);
+  }
+
+template <typename T, std::size_t N, typename A>
+  inline void
+  matrix<T, N, A>::permute_rows(const std::vector<std::size_t>& perm)
+  {
+    static_assert(N == 2, "");
+    assert(perm.size() == rows());
+    matrix_impl::permute_rows(rows(), cols(), matrix_impl::make_block(data(), desc),
+                              perm.data());
+  }
+
+template <typename T, std::size_t N, typename A>
   inline void
-  matrix<T, N>::swap_rows(std::size_t m, std::size_t n)
+  matrix<T, N, A>::permute_cols(const std::vector<std::size_t>& perm)
   {
-    auto a = (*this)[m];
-    auto b = (*this)[n];
-    std::swap_ranges(a.begin(), a.end(), b.begin());
+    static_assert(N == 2, "");
+    assert(perm.size() == cols());
+    matrix_impl::permute_cols(rows(), cols(), matrix_impl::make_block(data(), desc),
+                              perm.data());
   }
 
 
@@ -486,8 +573,8 @@ template <typename T, std::size_t N>
 // The type matrix<T, 0> is not really a matrix. It stores a single scalar
 // of type T and can only be converted to a reference to that type.
 
-template <typename T>
-  class matrix<T, 0>
+template <typename T, typename A>
+  class matrix<T, 0, A>
   {
   public:
     matrix() = default;
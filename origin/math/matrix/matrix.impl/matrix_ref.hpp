@@ -58,11 +58,15 @@ template <typename T, std::size_t N>
     // is a recipe for leaking memory.
     //
     // Assigning from a sub-matrix copies the values from x.
-    matrix_ref(matrix<value_type, N>& x);
-    matrix_ref(const matrix<value_type, N>& x);
-    matrix_ref(matrix<value_type, N>&&) = delete;
+    template <typename A>
+      matrix_ref(matrix<value_type, N, A>& x);
+    template <typename A>
+      matrix_ref(const matrix<value_type, N, A>& x);
+    template <typename A>
+      matrix_ref(matrix<value_type, N, A>&&) = delete;
 
-    matrix_ref& operator=(const matrix<value_type, N>& x);
+    template <typename A>
+      matrix_ref& operator=(const matrix<value_type, N, A>& x);
 
 
     // Submatrix conversion
@@ -182,6 +186,12 @@ template <typename T, std::size_t N>
     void swap(matrix_ref& x);
     void swap_rows(std::size_t m, std::size_t n);
 
+    // Row and column permutation. See the corresponding operations of
+    // matrix.
+    void swap_cols(std::size_t m, std::size_t n);
+    void permute_rows(const std::vector<std::size_t>& perm);
+    void permute_cols(const std::vector<std::size_t>& perm);
+
   private:
     matrix_slice<N> desc; // Descirbes the matrix_ref
     T* ptr;                // Points to the first element of a matrix
@@ -224,20 +234,23 @@ template <typename T, std::size_t N>
 
 
 template <typename T, std::size_t N>
+  template <typename A>
   inline
-  matrix_ref<T, N>::matrix_ref(matrix<value_type, N>& x)
+  matrix_ref<T, N>::matrix_ref(matrix<value_type, N, A>& x)
     : desc(x.descriptor()), ptr(x.data())
   { }
 
 template <typename T, std::size_t N>
+  template <typename A>
   inline
-  matrix_ref<T, N>::matrix_ref(const matrix<value_type, N>& x)
+  matrix_ref<T, N>::matrix_ref(const matrix<value_type, N, A>& x)
     : desc(x.descriptor()), ptr(x.data())
   { }
 
 template <typename T, std::size_t N>
+  template <typename A>
   inline matrix_ref<T, N>&
-  matrix_ref<T, N>::operator=(const matrix<value_type, N>& x)
+  matrix_ref<T, N>::operator=(const matrix<value_type, N, A>& x)
   {
       // FIXME: Is this right? Should we just assign values or resize the
       // vector based o what x is?
@@ -312,7 +325,7 @@ template <typename T, std::size_t N>
   {
     assert(n < extent(0));
     matrix_slice<N-1> row(desc, size_constant<0>(), n);
-    return {ptr, row};
+    return {row, ptr};
   }
 
 template <typename T, std::size_t N>
@@ -331,7 +344,7 @@ template <typename T, std::size_t N>
   {
     assert(n < extent(1));
     matrix_slice<N-1> col(desc, size_constant<1>(), n);
-    return {ptr, col};
+    return {col, ptr};
   }
 
 template <typename T, std::size_t N>
@@ -340,7 +353,7 @@ template <typename T, std::size_t N>
   {
     assert(n < extent(1));
     matrix_slice<N-1> col(desc, size_constant<1>(), n);
-    return {ptr, col};
+    return {col, ptr};
   }
 
 
@@ -360,14 +373,8 @@ template <typename T, std::size_t N>
     inline matrix_ref<T, N>&
     matrix_ref<T, N>::apply(const M& m, F f)
     {
-      assert(same_extents(desc, m.descriptor()));
-      auto i = begin();
-      auto j = m.begin();
-      while (i != end()) {
-        f(*i, *j);
-        ++i;
-        ++j;
-      }
+      matrix_slice<N> b = matrix_impl::broadcast_slice<N>(m.descriptor(), desc.extents);
+      matrix_impl::elementwise(desc, ptr, b, m.data(), f);
       return *this;
     }
 
@@ -457,9 +464,48 @@ template <typename T, std::size_t N>
     inline void
     matrix_ref<T, N>::swap_rows(std::size_t m, std::size_t n)
     {
-      auto a = (*this)[m];
-      auto b = (*this)[n];
-      std::swap_ranges(a.begin(). a.end(), b.begin());
+      assert(m < rows() && n < rows());
+      if (N == 2) {
+        const std::size_t s = desc.strides[N - 1];
+        matrix_impl::swap_lines(cols(), ptr + desc.start + m * desc.strides[0],
+                                ptr + desc.start + n * desc.strides[0], s);
+      } else {
+        auto a = (*this)[m];
+        auto b = (*this)[n];
+        std::swap_ranges(a.begin(), a.end(), b.begin());
+      }
+    }
+
+  // Swap columns
+  template <typename T, std::size_t N>
+    inline void
+    matrix_ref<T, N>::swap_cols(std::size_t m, std::size_t n)
+    {
+      static_assert(N == 2, "");
+      assert(m < cols() && n < cols());
+      auto b = matrix_impl::make_block(ptr, desc);
+      matrix_impl::swap_lines(rows(), &b(0, m), &b(0, n), b.rs);
+    }
+
+  // Permute rows and columns
+  template <typename T, std::size_t N>
+    inline void
+    matrix_ref<T, N>::permute_rows(const std::vector<std::size_t>& perm)
+    {
+      static_assert(N == 2, "");
+      assert(perm.size() == rows());
+      matrix_impl::permute_rows(rows(), cols(), matrix_impl::make_block(ptr, desc),
+                                perm.data());
+    }
+
+  template <typename T, std::size_t N>
+    inline void
+    matrix_ref<T, N>::permute_cols(const std::vector<std::size_t>& perm)
+    {
+      static_assert(N == 2, "");
+      assert(perm.size() == cols());
+      matrix_impl::permute_cols(rows(), cols(), matrix_impl::make_block(ptr, desc),
+                                perm.data());
     }
 
 
@@ -43,15 +43,21 @@ template <typename M>
 // ------------------------------------------------------------------------ //
 //                          Equality Comparable
 //
-// Two matrices compare equal when they have the same elements. Comparing
-// matrices described by different slices is undefined behavior.
+// Two matrices compare equal when they have the same elements at the same
+// indexes, regardless of their layout. Comparing matrices with different
+// extents is undefined behavior.
 
 template <typename M1, typename M2>
   inline Requires<Matrix<M1>() && Matrix<M2>(), bool> 
   operator==(const M1& a, const M2& b)
   { 
     assert(same_extents(a, b));
-    return std::equal(a.begin(), a.end(), b.begin());
+    using T = Value_type<M1>;
+    using U = Value_type<M2>;
+    bool eq = true;
+    matrix_impl::elementwise(a.descriptor(), a.data(), b.descriptor(), b.data(),
+                             [&eq](const T& x, const U& y) { eq = eq && x == y; });
+    return eq;
   }
 
 template <typename M1, typename M2>
@@ -87,13 +93,14 @@ template <typename M1, typename M2>
 // Adding two matrices with the same shape adds corresponding elements in
 // each operatand.
 
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator+(const matrix<T, N>& a, const matrix<T, N>& b)
+template <typename T, std::size_t N, typename A, typename B>
+  inline matrix<T, N, A>
+  operator+(const matrix<T, N, A>& a, const matrix<T, N, B>& b)
   {
     assert(same_extents(a, b));
-    matrix<T, N> result = a;
-    return result += b;
+    matrix<T, N, A> result = a;
+    result += b;
+    return result;
   }
 
 template <typename T, std::size_t N>
@@ -102,25 +109,28 @@ template <typename T, std::size_t N>
   {
     assert(same_extents(a, b));
     matrix<T, N> result = a;
-    return result += b;
+    result += b;
+    return result;
   }
 
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator+(const matrix<T, N>& a, const matrix_ref<T, N>& b)
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>
+  operator+(const matrix<T, N, A>& a, const matrix_ref<T, N>& b)
   {
     assert(same_extents(a, b));
-    matrix<T, N> result = a;
-    return result += b;
+    matrix<T, N, A> result = a;
+    result += b;
+    return result;
   }
 
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator+(const matrix_ref<T, N>& a, const matrix<T, N>& b)
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>
+  operator+(const matrix_ref<T, N>& a, const matrix<T, N, A>& b)
   {
     assert(same_extents(a, b));
-    matrix<T, N> result = a;
-    return result += b;
+    matrix<T, N, A> result = a;
+    result += b;
+    return result;
   }
 
 
@@ -129,13 +139,14 @@ template <typename T, std::size_t N>
 //
 // Subtracting one matrix from another with the same shape subtracts
 // corresponding elements in each operatand.
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator-(const matrix<T, N>& a, const matrix<T, N>& b)
+template <typename T, std::size_t N, typename A, typename B>
+  inline matrix<T, N, A>
+  operator-(const matrix<T, N, A>& a, const matrix<T, N, B>& b)
   {
     assert(same_extents(a, b));
-    matrix<T, N> result = a;
-    return a -= b;
+    matrix<T, N, A> result = a;
+    result -= b;
+    return result;
   }
 
 template <typename T, std::size_t N>
@@ -144,26 +155,29 @@ template <typename T, std::size_t N>
   {
     assert(same_extents(a, b));
     matrix<T, N> result = a;
-    return result -= b;
+    result -= b;
+    return result;
   }
 
 // Cross-type subtraction
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator-(const matrix<T, N>& a, const matrix_ref<T, N>& b)
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>
+  operator-(const matrix<T, N, A>& a, const matrix_ref<T, N>& b)
   {
     assert(same_extents(a, b));
-    matrix<T, N> result = a;
-    return result -= b;
+    matrix<T, N, A> result = a;
+    result -= b;
+    return result;
   }
 
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator-(const matrix_ref<T, N>& a, const matrix<T, N>& b)
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>
+  operator-(const matrix_ref<T, N>& a, const matrix<T, N, A>& b)
   {
     assert(same_extents(a, b));
-    matrix<T, N> result = a;
-    return result -= b;
+    matrix<T, N, A> result = a;
+    result -= b;
+    return result;
   }
 
 
@@ -176,20 +190,22 @@ template <typename T, std::size_t N>
 //
 //    a + n
 //    n + a
-template <typename T, std::size_t N>
-  inline matrix<T, N> 
-  operator+(const matrix<T, N>& x, const T& n)
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A> 
+  operator+(const matrix<T, N, A>& x, const T& n)
   {
-    matrix<T, N> result = x;
-    return result += n;
+    matrix<T, N, A> result = x;
+    result += n;
+    return result;
   }
 
-template <typename T, std::size_t N>
-  inline matrix<T, N> 
-  operator+(const T& n, const matrix<T, N>& x)
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A> 
+  operator+(const T& n, const matrix<T, N, A>& x)
   {
-    matrix<T, N> result = x;
-    return result += n;
+    matrix<T, N, A> result = x;
+    result += n;
+    return result;
   }
 
 template <typename T, std::size_t N>
@@ -197,7 +213,8 @@ template <typename T, std::size_t N>
   operator+(const matrix_ref<T, N>& x, const T& n)
   {
     matrix<T, N> result = x;
-    return result += n;
+    result += n;
+    return result;
   }
 
 template <typename T, std::size_t N>
@@ -205,7 +222,8 @@ template <typename T, std::size_t N>
   operator+(const T& n, const matrix_ref<T, N>& x)
   {
     matrix<T, N> result = x;
-    return result += n;
+    result += n;
+    return result;
   }
 
 
@@ -218,12 +236,13 @@ template <typename T, std::size_t N>
 //    a - n <=> a + -n;
 //
 // It is not possible to subtract a matrix from a scalar.
-template <typename T, std::size_t N>
-  inline matrix<T, N> 
-  operator-(const matrix<T, N>& x, const T& n)
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A> 
+  operator-(const matrix<T, N, A>& x, const T& n)
   {
-    matrix<T, N> result = x;
-    return result += n;
+    matrix<T, N, A> result = x;
+    result -= n;
+    return result;
   }
 
 template <typename T, std::size_t N>
@@ -231,7 +250,8 @@ template <typename T, std::size_t N>
   operator-(const matrix_ref<T, N>& x, const T& n)
   {
     matrix<T, N> result = x;
-    return result -= n;
+    result -= n;
+    return result;
   }
 
 
@@ -245,20 +265,22 @@ template <typename T, std::size_t N>
 //    a * n
 //    n * a
 //
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator*(const matrix<T, N>& x, const T& n)
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>
+  operator*(const matrix<T, N, A>& x, const T& n)
   {
-    matrix<T, N> result = x;
-    return result *= n;
+    matrix<T, N, A> result = x;
+    result *= n;
+    return result;
   }
 
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator*(const T& n, const matrix<T, N>& x)
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>
+  operator*(const T& n, const matrix<T, N, A>& x)
   {
-    matrix<T, N> result = x;
-    return result *= n;
+    matrix<T, N, A> result = x;
+    result *= n;
+    return result;
   }
 
 template <typename T, std::size_t N>
@@ -266,7 +288,8 @@ template <typename T, std::size_t N>
   operator*(const matrix_ref<T, N>& x, const T& n)
   {
     matrix<T, N> result = x;
-    return result *= n;
+    result *= n;
+    return result;
   }
 
 template <typename T, std::size_t N>
@@ -274,7 +297,8 @@ template <typename T, std::size_t N>
   operator*(const T& n, const matrix_ref<T, N>& x)
   {
     matrix<T, N> result = x;
-    return result *= n;
+    result *= n;
+    return result;
   }
 
 
@@ -287,12 +311,13 @@ template <typename T, std::size_t N>
 //    a / n <=> a * 1/n
 //
 // It is not possible to divide a scalar by a matrix.
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator/(const matrix<T, N>& a, const T& n)
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>
+  operator/(const matrix<T, N, A>& a, const T& n)
   {
-    matrix<T, N> result = a;
-    return result /= n;
+    matrix<T, N, A> result = a;
+    result /= n;
+    return result;
   }
 
 template <typename T, std::size_t N>
@@ -300,7 +325,8 @@ template <typename T, std::size_t N>
   operator/(const matrix_ref<T, N>& x, const T& n)
   {
     matrix<T, N> result = x;
-    return result /= n;
+    result /= n;
+    return result;
   }
 
 
@@ -312,12 +338,13 @@ template <typename T, std::size_t N>
 // given scalar value.
 //
 // This operation is only available when T is an Integer type.
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator%(const matrix<T, N>& a, const T& n)
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>
+  operator%(const matrix<T, N, A>& a, const T& n)
   {
-    matrix<T, N> result = a;
-    return result %= n;
+    matrix<T, N, A> result = a;
+    result %= n;
+    return result;
   }
 
 template <typename T, std::size_t N>
@@ -325,7 +352,8 @@ template <typename T, std::size_t N>
   operator%(const matrix_ref<T, N>& x, const T& n)
   {
     matrix<T, N> result = x;
-    return result %= n;
+    result %= n;
+    return result;
   }
 
 
@@ -344,11 +372,11 @@ template <typename M1, typename M2, typename M3>
 // Two 2D matrices a (m x p) and b (p x n) can be multiplied, resulting in a
 // matrix c (m x n). Note that the "inner" dimension of the operands must
 // be the same.
-template <typename T>
-  inline matrix<T, 2>
-  operator*(const matrix<T, 2>& a, const matrix<T, 2>& b) 
+template <typename T, typename A, typename B>
+  inline matrix<T, 2, A>
+  operator*(const matrix<T, 2, A>& a, const matrix<T, 2, B>& b) 
   {
-    matrix<T, 2> result (a.rows(), b.cols());
+    matrix<T, 2, A> result (a.rows(), b.cols());
     matrix_product(a, b, result);
     return result;
   }
@@ -357,26 +385,26 @@ template <typename T>
   inline matrix<T, 2>
   operator*(const matrix_ref<T, 2>& a, const matrix_ref<T, 2>& b) 
   {
-    matrix<T, 2> result (a.dims());
+    matrix<T, 2> result (a.rows(), b.cols());
     matrix_product(a, b, result);
     return result;
   }
 
 // Cross product multiplication.
-template <typename T>
-  inline matrix<T, 2>
-  operator*(const matrix<T, 2>& a, const matrix_ref<T, 2>& b) 
+template <typename T, typename A>
+  inline matrix<T, 2, A>
+  operator*(const matrix<T, 2, A>& a, const matrix_ref<T, 2>& b) 
   {
-    matrix<T, 2> result (a.dims());
+    matrix<T, 2, A> result (a.rows(), b.cols());
     matrix_product(a, b, result);
     return result;
   }
 
-template <typename T>
-  inline matrix<T, 2>
-  operator*(const matrix_ref<T, 2>& a, const matrix<T, 2>& b) 
+template <typename T, typename A>
+  inline matrix<T, 2, A>
+  operator*(const matrix_ref<T, 2>& a, const matrix<T, 2, A>& b) 
   {
-    matrix<T, 2> result (a.dims());
+    matrix<T, 2, A> result (a.rows(), b.cols());
     matrix_product(a, b, result);
     return result;
   }
@@ -386,10 +414,17 @@ template <typename T>
 //////////////////////////////////////////////////////////////////////////////
 // Matrix Product
 //
-// The usual meaning of the operation.
+// The usual meaning of the operation. The product of a and b is accumulated
+// into out.
 //
-// FIXME: This is not terribly efficient. Implement a more efficient algorithm
-// than this brute force version.
+// The loop order is chosen from the strides of the operands so that
+// transposed views are traversed along contiguous memory. See
+// matrix_impl::product for details.
+//
+// When the elements of a and b have reduced precision (bfloat16, half or
+// 8 and 16-bit integers), the products are accumulated in their
+// Accumulator_type, e.g., float or int32_t, and out should normally have
+// that element type. See matrix_impl::widening_product.
 //
 // FIXME: I'm not at all sure that this generalizes to n dimensions. It might
 // be the case that we want all M's to be 2 dimensions (as they are now!).
@@ -404,14 +439,118 @@ template <typename M1, typename M2, typename M3>
     assert(rows(a) == rows(out));
     assert(cols(b) == cols(out));
 
-    using Size = Size_type<M3>;
+    matrix_impl::general_product(rows(a), cols(b), cols(a),
+                                 matrix_impl::make_block(a.data(), a.descriptor()),
+                                 matrix_impl::make_block(b.data(), b.descriptor()),
+                                 matrix_impl::make_block(out.data(), out.descriptor()));
+  }
+
 
-    for (Size i = 0; i != rows(a); ++i) {
-      for (Size j = 0; j < cols(b); ++j) {
-        for (Size k = 0; k < rows(b); ++k)
-          out(i, j) += a(i, k) * b(k, j);
-      }
-    }
+// Selects the Strassen-Winograd algorithm for matrix_product. Products in
+// which every extent exceeds the crossover are computed from seven products
+// of half the size instead of eight, recursively; smaller products use the
+// classical kernel. See matrix_impl::strassen for details.
+//
+// The asymptotic savings only pay off for large matrices, and the result
+// is slightly less accurate than the classical product: the error bound
+// grows with the number of levels of recursion.
+struct strassen_mode
+{
+  explicit strassen_mode(std::size_t n = 128)
+    : crossover(n)
+  { }
+
+  std::size_t crossover;
+};
+
+// Accumulate the product of a and b into out using the Strassen-Winograd
+// algorithm. The workspace for the whole recursion, about a third of the
+// combined size of the operands and result, is allocated once.
+template <typename M1, typename M2, typename M3>
+  void
+  matrix_product(const M1& a, const M2& b, M3& out, strassen_mode mode)
+  {
+    static_assert(M1::order == 2, "");
+    static_assert(M2::order == 2, "");
+    static_assert(M3::order == 2, "");
+    assert(cols(a) == rows(b));
+    assert(rows(a) == rows(out));
+    assert(cols(b) == cols(out));
+    assert(mode.crossover != 0);
+
+    using T = Value_type<M3>;
+    std::vector<T> ws(matrix_impl::strassen_workspace(rows(a), cols(b), cols(a),
+                                                      mode.crossover));
+    matrix_impl::strassen(rows(a), cols(b), cols(a),
+                          matrix_impl::make_block(a.data(), a.descriptor()),
+                          matrix_impl::make_block(b.data(), b.descriptor()),
+                          matrix_impl::make_block(out.data(), out.descriptor()),
+                          mode.crossover, ws.data());
+  }
+
+
+//////////////////////////////////////////////////////////////////////////////
+// Matrix-Vector Product
+//
+// Compute y = alpha * a * x + beta * y, where a is a 2D matrix (m x n), x is
+// a vector (n), and y is a vector (m). To multiply by the transpose of a,
+// pass transpose(a); the kernel traverses the transposed view along its
+// contiguous columns. If beta is 0, y need not be initialized.
+//
+// Blocks of rows of the result are computed concurrently for large a.
+template <typename T, typename M1, typename M2, typename M3>
+  void
+  gemv(const T& alpha, const M1& a, const M2& x, const T& beta, M3& y)
+  {
+    static_assert(M1::order == 2, "");
+    static_assert(M2::order == 1, "");
+    static_assert(M3::order == 1, "");
+    assert(cols(a) == x.size());
+    assert(rows(a) == y.size());
+
+    const auto& xd = x.descriptor();
+    const auto& yd = y.descriptor();
+    matrix_impl::gemv(rows(a), cols(a), alpha,
+                      matrix_impl::make_block(a.data(), a.descriptor()),
+                      x.data() + xd.start, xd.strides[0], beta,
+                      y.data() + yd.start, yd.strides[0]);
+  }
+
+// Returns the product of the 2D matrix a and the vector x.
+template <typename M1, typename M2>
+  inline Requires<Matrix<M1>() && Matrix<M2>() && M1::order == 2 && M2::order == 1,
+                  matrix<Common_type<Value_type<M1>, Value_type<M2>>, 1>>
+  operator*(const M1& a, const M2& x)
+  {
+    using T = Common_type<Value_type<M1>, Value_type<M2>>;
+    matrix<T, 1> result(rows(a));
+    gemv(T(1), a, x, T(0), result);
+    return result;
+  }
+
+
+//////////////////////////////////////////////////////////////////////////////
+// Rank-1 Update
+//
+// Compute a = alpha * x * y^T + a, where x is a vector (m), y is a vector
+// (n), and a is a 2D matrix (m x n). Blocks of rows of a are updated
+// concurrently for large a.
+template <typename T, typename M1, typename M2, typename M3>
+  void
+  ger(const T& alpha, const M1& x, const M2& y, M3& a)
+  {
+    static_assert(M1::order == 1, "");
+    static_assert(M2::order == 1, "");
+    static_assert(M3::order == 2, "");
+    assert(rows(a) == x.size());
+    assert(cols(a) == y.size());
+
+    const auto& xd = x.descriptor();
+    const auto& yd = y.descriptor();
+    matrix_impl::ger(rows(a), cols(a), alpha,
+                     x.data() + xd.start, xd.strides[0],
+                     y.data() + yd.start, yd.strides[0],
+                     matrix_impl::make_block(a.data(), a.descriptor()));
   }
 
 
@@ -419,32 +558,85 @@ template <typename M1, typename M2, typename M3>
 // Hadamard Product
 //
 // The hadamard product can be easly generalized to N-dimensional matrices 
-// since the operation is performed elementwise. The operands only need the
-// same shape.
+// since the operation is performed elementwise. The operands must be
+// broadcastable to the extents of out (see broadcast_transform).
 template <typename M1, typename M2, typename M3>
   void
   hadamard_product(const M1& a, const M2& b, M3& out)
   {
-    assert(a.shape() == b.shape());
-    assert(a.shape() == out.shape());
-
-    using Mul = std::multiplies<Value_type<M1>>;
-    std::transform(a.begin(), a.end(), b.begin(), out.begin(), Mul{});
+    using T = Value_type<M3>;
+    broadcast_transform(a, b, out, [](const Value_type<M1>& x, 
+                                      const Value_type<M2>& y) -> T { 
+      return x * y; 
+    });
   }
 
 
+//////////////////////////////////////////////////////////////////////////////
+// Broadcast Transform
+//
+// Assign op(x, y) to each element of out, where x and y are the corresponding
+// elements of a and b broadcast to the extents of out. The operands may have
+// lower order than out or extents of 1; their elements are repeated across
+// the missing dimensions. For example, with a of extents (m, n) and b of
+// extent (n), b is combined with each row of a.
+//
+// The operation is evaluated in a single pass over out. The repeated operands
+// are never materialized.
+template <typename M1, typename M2, typename M3, typename Op>
+  void
+  broadcast_transform(const M1& a, const M2& b, M3& out, Op op)
+  {
+    constexpr std::size_t N = M3::order;
+    const matrix_slice<N>& d = out.descriptor();
+    matrix_slice<N> x = matrix_impl::broadcast_slice<N>(a.descriptor(), d.extents);
+    matrix_slice<N> y = matrix_impl::broadcast_slice<N>(b.descriptor(), d.extents);
+    using T = Value_type<M1>;
+    using U = Value_type<M2>;
+    using V = Value_type<M3>;
+    matrix_impl::elementwise(d, out.data(), x, a.data(), y, b.data(), 
+      [&op](V& z, const T& s, const U& t) { z = op(s, t); });
+  }
+
+// Returns the matrix of op(x, y) for the elements x and y of a and b broadcast
+// to a common extent. The order of the result is the larger of the orders of
+// a and b.
+template <typename M1, typename M2, typename Op>
+  matrix<Common_type<Value_type<M1>, Value_type<M2>>, 
+         (M1::order < M2::order ? M2::order : M1::order)>
+  broadcast_transform(const M1& a, const M2& b, Op op)
+  {
+    constexpr std::size_t N = M1::order < M2::order ? M2::order : M1::order;
+    using T = Common_type<Value_type<M1>, Value_type<M2>>;
+    std::array<std::size_t, N> exts;
+    bool ok = matrix_impl::broadcast_extents<N>(a.descriptor(), b.descriptor(), 
+                                                exts.data());
+    assert(ok);
+    (void)ok;
+    matrix<T, N> result(matrix_slice<N>(0, exts));
+    broadcast_transform(a, b, result, op);
+    return result;
+  }
+
 
 // -------------------------------------------------------------------------- //
 // Output
 //
 // Write the matrix to the the given output stream.
 //
+// When the stream uses its default format, the elements are formatted into
+// a buffer that is written in large blocks (see matrix.impl/format.hpp).
+// Otherwise each element is inserted into the stream.
+//
 // TODO: Write extensions that allow for pretty printing of matrices.
 
 template <typename C, typename T, typename M>
   inline Requires<Matrix<M>(), std::basic_ostream<C, T>&>
   operator<<(std::basic_ostream<C, T>& os, const M& m)
   {
+    if (matrix_impl::print_nested(os, m))
+      return os;
+
     os << '[';
     for (std::size_t i = 0; i < rows(m); ++i) {
       os << m[i];
@@ -481,6 +673,8 @@ template <typename C, typename T, typename M, std::size_t D>
   {
     const auto& m = p.matrix;
     const std::size_t n = m.rows();
+    if (matrix_impl::print_pretty(os, m, p.depth))
+      return os;
     
     // Indent
     for (std::size_t i = 0; i < p.depth; ++i)
@@ -503,6 +697,8 @@ template <typename C, typename T, typename M>
   {
     const auto& m = p.matrix;
     const std::size_t n = m.size();
+    if (matrix_impl::print_pretty(os, m, p.depth))
+      return os;
 
     // Indent
     for (std::size_t i = 0; i < p.depth; ++i)
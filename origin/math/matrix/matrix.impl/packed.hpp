@@ -0,0 +1,804 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+
+// -------------------------------------------------------------------------- //
+//                            Packed Matrices
+//
+// Packed matrices are square matrices that store only the elements that are
+// not implied by their structure:
+//
+//    symmetric_matrix   -- the lower triangle, n(n+1)/2 elements
+//    triangular_matrix  -- the lower or upper triangle, n(n+1)/2 elements
+//    banded_matrix      -- the kl subdiagonals, the diagonal and the ku
+//                          superdiagonals, n(kl+ku+1) elements
+//
+// The stored elements of each row are contiguous, so products and solves
+// are computed with the same dot and axpy kernels as dense matrices.
+//
+// Packed matrices have an order and extents and are indexed like a 2D
+// matrix, but they are not described by a slice: they have no descriptor(),
+// and cannot be viewed or sliced. Use dense() to convert a packed matrix
+// to a matrix<T, 2>. Elements of a triangular or banded matrix outside its
+// structure read as 0 through a const matrix and cannot be assigned.
+
+
+// Selects the lower or upper triangle of a triangular matrix.
+enum class matrix_triangle
+{
+  lower,
+  upper
+};
+
+
+namespace matrix_impl
+{
+  // Returns the offset of the element (i, j), j <= i, in a lower triangle
+  // packed by rows.
+  inline std::size_t
+  lower_offset(std::size_t i, std::size_t j)
+  {
+    return i * (i + 1) / 2 + j;
+  }
+
+  // Returns the offset of the element (i, j), i <= j, in the upper triangle
+  // of an n x n matrix packed by rows.
+  inline std::size_t
+  upper_offset(std::size_t n, std::size_t i, std::size_t j)
+  {
+    return i * n - i * (i - 1) / 2 + (j - i);
+  }
+} // namespace matrix_impl
+
+
+// -------------------------------------------------------------------------- //
+// Symmetric Matrix                                             [matrix.packed]
+//
+// A symmetric matrix of order n stores the elements of its lower triangle.
+// The elements (i, j) and (j, i) are the same object.
+template <typename T>
+  class symmetric_matrix
+  {
+  public:
+    static constexpr std::size_t order = 2;
+
+    using value_type = T;
+
+    symmetric_matrix()
+      : n(0)
+    { }
+
+    // Initialize an n x n symmetric matrix. All elements are default
+    // initialized.
+    explicit symmetric_matrix(std::size_t n)
+      : n(n), elems(n * (n + 1) / 2)
+    { }
+
+    // Initialize the matrix from the lower triangle of the square matrix x.
+    template <typename M, typename = Requires<Matrix<M>()>>
+      explicit symmetric_matrix(const M& x);
+
+    // Properties
+    std::size_t extent(std::size_t) const { return n; }
+    std::size_t rows() const { return n; }
+    std::size_t cols() const { return n; }
+    std::size_t size() const { return n * n; }
+
+    // Returns the number of stored elements.
+    std::size_t packed_size() const { return elems.size(); }
+
+    // Element access
+    T&       operator()(std::size_t i, std::size_t j)       { return elems[index(i, j)]; }
+    const T& operator()(std::size_t i, std::size_t j) const { return elems[index(i, j)]; }
+
+    // Returns a pointer to the packed elements.
+    T*       data()       { return elems.data(); }
+    const T* data() const { return elems.data(); }
+
+  private:
+    std::size_t index(std::size_t i, std::size_t j) const
+    {
+      assert(i < n && j < n);
+      return i < j ? matrix_impl::lower_offset(j, i) : matrix_impl::lower_offset(i, j);
+    }
+
+    std::size_t n;
+    std::vector<T> elems;
+  };
+
+template <typename T>
+  template <typename M, typename X>
+    symmetric_matrix<T>::symmetric_matrix(const M& x)
+      : symmetric_matrix(x.extent(0))
+    {
+      static_assert(M::order == 2, "");
+      assert(x.extent(0) == x.extent(1));
+      for (std::size_t i = 0; i != n; ++i)
+        for (std::size_t j = 0; j <= i; ++j)
+          (*this)(i, j) = x(i, j);
+    }
+
+
+// -------------------------------------------------------------------------- //
+// Triangular Matrix                                            [matrix.packed]
+//
+// A triangular matrix of order n stores the elements on and below (lower)
+// or on and above (upper) its diagonal.
+template <typename T>
+  class triangular_matrix
+  {
+  public:
+    static constexpr std::size_t order = 2;
+
+    using value_type = T;
+
+    triangular_matrix()
+      : n(0), tri(matrix_triangle::lower)
+    { }
+
+    // Initialize an n x n triangular matrix. All elements are default
+    // initialized.
+    explicit triangular_matrix(std::size_t n,
+                               matrix_triangle t = matrix_triangle::lower)
+      : n(n), tri(t), elems(n * (n + 1) / 2)
+    { }
+
+    // Initialize the matrix from the triangle t of the square matrix x.
+    template <typename M, typename = Requires<Matrix<M>()>>
+      triangular_matrix(const M& x, matrix_triangle t);
+
+    // Properties
+    std::size_t extent(std::size_t) const { return n; }
+    std::size_t rows() const { return n; }
+    std::size_t cols() const { return n; }
+    std::size_t size() const { return n * n; }
+
+    // Returns the stored triangle.
+    matrix_triangle triangle() const { return tri; }
+
+    // Returns the number of stored elements.
+    std::size_t packed_size() const { return elems.size(); }
+
+    // Returns true if the element (i, j) is stored.
+    bool stored(std::size_t i, std::size_t j) const
+    {
+      return tri == matrix_triangle::lower ? j <= i : i <= j;
+    }
+
+    // Element access
+    //
+    // Only stored elements can be accessed through a non-const matrix.
+    // Through a const matrix, elements outside the triangle read as 0.
+    T& operator()(std::size_t i, std::size_t j)
+    {
+      assert(stored(i, j));
+      return elems[index(i, j)];
+    }
+
+    T operator()(std::size_t i, std::size_t j) const
+    {
+      return stored(i, j) ? elems[index(i, j)] : T(0);
+    }
+
+    // Returns a pointer to the packed elements.
+    T*       data()       { return elems.data(); }
+    const T* data() const { return elems.data(); }
+
+  private:
+    std::size_t index(std::size_t i, std::size_t j) const
+    {
+      assert(i < n && j < n);
+      return tri == matrix_triangle::lower ? matrix_impl::lower_offset(i, j)
+                                           : matrix_impl::upper_offset(n, i, j);
+    }
+
+    std::size_t n;
+    matrix_triangle tri;
+    std::vector<T> elems;
+  };
+
+template <typename T>
+  template <typename M, typename X>
+    triangular_matrix<T>::triangular_matrix(const M& x, matrix_triangle t)
+      : triangular_matrix(x.extent(0), t)
+    {
+      static_assert(M::order == 2, "");
+      assert(x.extent(0) == x.extent(1));
+      for (std::size_t i = 0; i != n; ++i)
+        for (std::size_t j = 0; j != n; ++j)
+          if (stored(i, j))
+            (*this)(i, j) = x(i, j);
+    }
+
+
+// -------------------------------------------------------------------------- //
+// Banded Matrix                                                [matrix.packed]
+//
+// A banded matrix of order n stores the elements (i, j) with
+// i - kl <= j <= i + ku, where kl and ku are its lower and upper
+// bandwidths. Each row is stored in kl + ku + 1 consecutive elements; the
+// slots of the first and last rows that lie outside the matrix are unused.
+template <typename T>
+  class banded_matrix
+  {
+  public:
+    static constexpr std::size_t order = 2;
+
+    using value_type = T;
+
+    banded_matrix()
+      : n(0), kl(0), ku(0)
+    { }
+
+    // Initialize an n x n banded matrix with kl subdiagonals and ku
+    // superdiagonals. All elements are default initialized.
+    banded_matrix(std::size_t n, std::size_t kl, std::size_t ku)
+      : n(n), kl(kl), ku(ku), elems(n * (kl + ku + 1))
+    { }
+
+    // Initialize the matrix from the band of the square matrix x.
+    template <typename M, typename = Requires<Matrix<M>()>>
+      banded_matrix(const M& x, std::size_t kl, std::size_t ku);
+
+    // Properties
+    std::size_t extent(std::size_t) const { return n; }
+    std::size_t rows() const { return n; }
+    std::size_t cols() const { return n; }
+    std::size_t size() const { return n * n; }
+
+    // Returns the number of subdiagonals.
+    std::size_t lower_bandwidth() const { return kl; }
+
+    // Returns the number of superdiagonals.
+    std::size_t upper_bandwidth() const { return ku; }
+
+    // Returns the number of elements stored for each row.
+    std::size_t width() const { return kl + ku + 1; }
+
+    // Returns true if the element (i, j) is stored.
+    bool stored(std::size_t i, std::size_t j) const
+    {
+      return j + kl >= i && j <= i + ku;
+    }
+
+    // Element access
+    //
+    // Only stored elements can be accessed through a non-const matrix.
+    // Through a const matrix, elements outside the band read as 0.
+    T& operator()(std::size_t i, std::size_t j)
+    {
+      assert(stored(i, j));
+      return elems[index(i, j)];
+    }
+
+    T operator()(std::size_t i, std::size_t j) const
+    {
+      return stored(i, j) ? elems[index(i, j)] : T(0);
+    }
+
+    // Returns a pointer to the packed elements. The element (i, j) is
+    // located at offset i * width() + (j + kl - i).
+    T*       data()       { return elems.data(); }
+    const T* data() const { return elems.data(); }
+
+  private:
+    std::size_t index(std::size_t i, std::size_t j) const
+    {
+      assert(i < n && j < n);
+      return i * width() + (j + kl - i);
+    }
+
+    std::size_t n;
+    std::size_t kl;
+    std::size_t ku;
+    std::vector<T> elems;
+  };
+
+template <typename T>
+  template <typename M, typename X>
+    banded_matrix<T>::banded_matrix(const M& x, std::size_t kl, std::size_t ku)
+      : banded_matrix(x.extent(0), kl, ku)
+    {
+      static_assert(M::order == 2, "");
+      assert(x.extent(0) == x.extent(1));
+      for (std::size_t i = 0; i != n; ++i) {
+        const std::size_t lo = i > kl ? i - kl : 0;
+        const std::size_t hi = std::min(i + ku + 1, n);
+        for (std::size_t j = lo; j != hi; ++j)
+          (*this)(i, j) = x(i, j);
+      }
+    }
+
+
+// -------------------------------------------------------------------------- //
+//                          Packed Matrix Operations
+
+
+// Returns a dense copy of the 2D matrix a. This is primarily used to convert
+// packed matrices to matrix<T, 2>.
+template <typename M>
+  matrix<Value_type<M>, 2>
+  dense(const M& a)
+  {
+    static_assert(M::order == 2, "");
+    matrix<Value_type<M>, 2> r(a.extent(0), a.extent(1));
+    for (std::size_t i = 0; i != a.extent(0); ++i)
+      for (std::size_t j = 0; j != a.extent(1); ++j)
+        r(i, j) = a(i, j);
+    return r;
+  }
+
+
+// Equality comparison
+//
+// Two packed matrices of the same kind compare equal when they have the same
+// structure and the same stored elements.
+template <typename T>
+  inline bool
+  operator==(const symmetric_matrix<T>& a, const symmetric_matrix<T>& b)
+  {
+    return a.rows() == b.rows()
+        && std::equal(a.data(), a.data() + a.packed_size(), b.data());
+  }
+
+template <typename T>
+  inline bool
+  operator!=(const symmetric_matrix<T>& a, const symmetric_matrix<T>& b)
+  {
+    return !(a == b);
+  }
+
+template <typename T>
+  inline bool
+  operator==(const triangular_matrix<T>& a, const triangular_matrix<T>& b)
+  {
+    return a.rows() == b.rows() && a.triangle() == b.triangle()
+        && std::equal(a.data(), a.data() + a.packed_size(), b.data());
+  }
+
+template <typename T>
+  inline bool
+  operator!=(const triangular_matrix<T>& a, const triangular_matrix<T>& b)
+  {
+    return !(a == b);
+  }
+
+template <typename T>
+  inline bool
+  operator==(const banded_matrix<T>& a, const banded_matrix<T>& b)
+  {
+    if (a.rows() != b.rows()
+        || a.lower_bandwidth() != b.lower_bandwidth()
+        || a.upper_bandwidth() != b.upper_bandwidth())
+      return false;
+    for (std::size_t i = 0; i != a.rows(); ++i) {
+      const std::size_t lo = i > a.lower_bandwidth() ? i - a.lower_bandwidth() : 0;
+      const std::size_t hi = std::min(i + a.upper_bandwidth() + 1, a.rows());
+      for (std::size_t j = lo; j != hi; ++j)
+        if (!(a(i, j) == b(i, j)))
+          return false;
+    }
+    return true;
+  }
+
+template <typename T>
+  inline bool
+  operator!=(const banded_matrix<T>& a, const banded_matrix<T>& b)
+  {
+    return !(a == b);
+  }
+
+
+// Streaming
+//
+// Packed matrices are written as their dense equivalents.
+template <typename C, typename Tr, typename T>
+  inline std::basic_ostream<C, Tr>&
+  operator<<(std::basic_ostream<C, Tr>& os, const symmetric_matrix<T>& a)
+  {
+    return os << dense(a);
+  }
+
+template <typename C, typename Tr, typename T>
+  inline std::basic_ostream<C, Tr>&
+  operator<<(std::basic_ostream<C, Tr>& os, const triangular_matrix<T>& a)
+  {
+    return os << dense(a);
+  }
+
+template <typename C, typename Tr, typename T>
+  inline std::basic_ostream<C, Tr>&
+  operator<<(std::basic_ostream<C, Tr>& os, const banded_matrix<T>& a)
+  {
+    return os << dense(a);
+  }
+
+
+namespace matrix_impl
+{
+  // ------------------------------------------------------------------------ //
+  //                          Packed Kernels
+  //
+  // The kernels operate on the packed elements of an n x n matrix, a vector
+  // x with stride xs, and a vector y with stride ys, or an n x r block b of
+  // right-hand sides.
+
+  // Compute y = a x for the symmetric matrix a. Row i of the lower triangle
+  // contributes a dot product to y(i) and is added into y(0) .. y(i - 1),
+  // so each stored element is read once.
+  template <typename T, typename U, typename V>
+    void
+    symmetric_product(std::size_t n, const T* a,
+                      const U* x, std::size_t xs, V* y, std::size_t ys)
+    {
+      for (std::size_t i = 0; i != n; ++i)
+        y[i * ys] = V(0);
+      for (std::size_t i = 0; i != n; ++i) {
+        const T* r = a + lower_offset(i, 0);
+        y[i * ys] += dot(i, r, 1, x, xs) + r[i] * x[i * xs];
+        axpy(i, x[i * xs], r, 1, y, ys);
+      }
+    }
+
+  // Compute y = a x for the triangular matrix a.
+  template <typename T, typename U, typename V>
+    void
+    triangular_product(std::size_t n, matrix_triangle t, const T* a,
+                       const U* x, std::size_t xs, V* y, std::size_t ys)
+    {
+      if (t == matrix_triangle::lower) {
+        for (std::size_t i = 0; i != n; ++i)
+          y[i * ys] = dot(i + 1, a + lower_offset(i, 0), 1, x, xs);
+      } else {
+        for (std::size_t i = 0; i != n; ++i)
+          y[i * ys] = dot(n - i, a + upper_offset(n, i, i), 1, x + i * xs, xs);
+      }
+    }
+
+  // Compute y = a x for the banded matrix a with kl subdiagonals and ku
+  // superdiagonals.
+  template <typename T, typename U, typename V>
+    void
+    banded_product(std::size_t n, std::size_t kl, std::size_t ku, const T* a,
+                   const U* x, std::size_t xs, V* y, std::size_t ys)
+    {
+      const std::size_t w = kl + ku + 1;
+      for (std::size_t i = 0; i != n; ++i) {
+        const std::size_t lo = i > kl ? i - kl : 0;
+        const std::size_t hi = std::min(i + ku + 1, n);
+        y[i * ys] = dot(hi - lo, a + i * w + (lo + kl - i), 1, x + lo * xs, xs);
+      }
+    }
+
+
+  // Solve a x = b for the triangular matrix a, overwriting the n x r block b
+  // with x. Returns false if a is singular.
+  template <typename T, typename U>
+    bool
+    triangular_solve(std::size_t n, std::size_t r, matrix_triangle t,
+                     const T* a, block<U> b)
+    {
+      if (t == matrix_triangle::lower) {
+        for (std::size_t i = 0; i != n; ++i) {
+          const T* row = a + lower_offset(i, 0);
+          if (row[i] == T(0))
+            return false;
+          for (std::size_t c = 0; c != r; ++c) {
+            U& x = b(i, c);
+            x = (x - dot(i, row, 1, &b(0, c), b.rs)) / row[i];
+          }
+        }
+      } else {
+        for (std::size_t i = n; i-- != 0; ) {
+          const T* row = a + upper_offset(n, i, i);
+          if (row[0] == T(0))
+            return false;
+          for (std::size_t c = 0; c != r; ++c) {
+            U& x = b(i, c);
+            x = (x - dot(n - i - 1, row + 1, 1, &b(i + 1, c), b.rs)) / row[0];
+          }
+        }
+      }
+      return true;
+    }
+
+  // Solve l^T x = b for the lower triangular matrix l, overwriting the n x r
+  // block b with x. Each solved element is eliminated from the preceding
+  // equations using a row of l, so that l is traversed along its contiguous
+  // rows. The diagonal of l must be nonzero.
+  template <typename T, typename U>
+    void
+    lower_transpose_solve(std::size_t n, std::size_t r, const T* l, block<U> b)
+    {
+      for (std::size_t i = n; i-- != 0; ) {
+        const T* row = l + lower_offset(i, 0);
+        for (std::size_t c = 0; c != r; ++c) {
+          U& x = b(i, c);
+          x /= row[i];
+          axpy(i, -x, row, 1, &b(0, c), b.rs);
+        }
+      }
+    }
+
+  // Factor the packed symmetric matrix a in place as a = l l^T, where l is
+  // lower triangular with a positive diagonal. Returns false if a is not
+  // positive definite.
+  template <typename T>
+    bool
+    cholesky_factor(std::size_t n, T* a)
+    {
+      for (std::size_t i = 0; i != n; ++i) {
+        T* ri = a + lower_offset(i, 0);
+        for (std::size_t j = 0; j <= i; ++j) {
+          const T* rj = a + lower_offset(j, 0);
+          const T s = ri[j] - dot(j, ri, 1, rj, 1);
+          if (j == i) {
+            if (!(s > T(0)))
+              return false;
+            ri[i] = std::sqrt(s);
+          } else {
+            ri[j] = s / rj[j];
+          }
+        }
+      }
+      return true;
+    }
+
+  // Solve a tridiagonal system of n equations using the Thomas algorithm,
+  // overwriting d with the solution. The subdiagonal lo and superdiagonal up
+  // have n - 1 elements; the diagonal di has n. Elements are accessed with
+  // the given strides. The work array must have room for n - 1 elements.
+  //
+  // The algorithm is Gaussian elimination without pivoting. Returns false
+  // if a zero pivot is encountered, which cannot happen when the matrix is
+  // diagonally dominant or positive definite.
+  template <typename T, typename U>
+    bool
+    thomas(std::size_t n, const T* lo, std::size_t ls, const T* di, std::size_t ds,
+           const T* up, std::size_t us, U* d, std::size_t dstr, U* work)
+    {
+      if (n == 0)
+        return true;
+      U m = di[0];
+      if (m == U(0))
+        return false;
+      d[0] /= m;
+      for (std::size_t i = 1; i != n; ++i) {
+        work[i - 1] = up[(i - 1) * us] / m;
+        const T l = lo[(i - 1) * ls];
+        m = di[i * ds] - l * work[i - 1];
+        if (m == U(0))
+          return false;
+        d[i * dstr] = (d[i * dstr] - l * d[(i - 1) * dstr]) / m;
+      }
+      for (std::size_t i = n - 1; i-- != 0; )
+        d[i * dstr] -= work[i] * d[(i + 1) * dstr];
+      return true;
+    }
+
+  // Solve a x = b for the banded matrix a with kl subdiagonals and ku
+  // superdiagonals, overwriting the n x r block b with x and a with its LU
+  // factors. Without pivoting, elimination introduces no elements outside
+  // the band, so the cost is O(n kl ku). Returns false if a zero pivot is
+  // encountered.
+  template <typename T, typename U>
+    bool
+    banded_solve(std::size_t n, std::size_t kl, std::size_t ku, T* a,
+                 std::size_t r, block<U> b)
+    {
+      const std::size_t w = kl + ku + 1;
+      auto at = [&](std::size_t i, std::size_t j) -> T& {
+        return a[i * w + (j + kl - i)];
+      };
+
+      for (std::size_t k = 0; k != n; ++k) {
+        const T p = at(k, k);
+        if (p == T(0))
+          return false;
+        const std::size_t last = std::min(k + kl + 1, n);
+        const std::size_t cols = std::min(k + ku + 1, n) - (k + 1);
+        for (std::size_t i = k + 1; i != last; ++i) {
+          const T f = at(i, k) / p;
+          axpy(cols, -f, &at(k, k + 1), 1, &at(i, k + 1), 1);
+          for (std::size_t c = 0; c != r; ++c)
+            b(i, c) -= f * b(k, c);
+        }
+      }
+      for (std::size_t i = n; i-- != 0; ) {
+        const std::size_t cols = std::min(i + ku + 1, n) - (i + 1);
+        for (std::size_t c = 0; c != r; ++c) {
+          U& x = b(i, c);
+          x = (x - dot(cols, &at(i, i + 1), 1, &b(i + 1, c), b.rs)) / at(i, i);
+        }
+      }
+      return true;
+    }
+
+
+  // Returns the block of right-hand sides described by b, which is either a
+  // vector (one right-hand side) or a 2D matrix (one per column).
+  template <typename M>
+    inline Requires<M::order == 1, block<Value_type<M>>>
+    rhs_block(M& b)
+    {
+      const auto& d = b.descriptor();
+      return {b.data() + d.start, d.strides[0], 0};
+    }
+
+  template <typename M>
+    inline Requires<M::order == 2, block<Value_type<M>>>
+    rhs_block(M& b)
+    {
+      return make_block(b.data(), b.descriptor());
+    }
+
+  template <typename M>
+    inline std::size_t
+    rhs_count(const M& b)
+    {
+      return M::order == 1 ? 1 : b.extent(M::order - 1);
+    }
+
+} // namespace matrix_impl
+
+
+// Matrix-vector products
+//
+// Returns the product of a packed matrix and a vector.
+template <typename T, typename M>
+  inline Requires<Matrix<M>() && M::order == 1, matrix<T, 1>>
+  operator*(const symmetric_matrix<T>& a, const M& x)
+  {
+    assert(a.cols() == x.size());
+    const auto& d = x.descriptor();
+    matrix<T, 1> y(a.rows());
+    matrix_impl::symmetric_product(a.rows(), a.data(),
+                                   x.data() + d.start, d.strides[0], y.data(), 1);
+    return y;
+  }
+
+template <typename T, typename M>
+  inline Requires<Matrix<M>() && M::order == 1, matrix<T, 1>>
+  operator*(const triangular_matrix<T>& a, const M& x)
+  {
+    assert(a.cols() == x.size());
+    const auto& d = x.descriptor();
+    matrix<T, 1> y(a.rows());
+    matrix_impl::triangular_product(a.rows(), a.triangle(), a.data(),
+                                    x.data() + d.start, d.strides[0], y.data(), 1);
+    return y;
+  }
+
+template <typename T, typename M>
+  inline Requires<Matrix<M>() && M::order == 1, matrix<T, 1>>
+  operator*(const banded_matrix<T>& a, const M& x)
+  {
+    assert(a.cols() == x.size());
+    const auto& d = x.descriptor();
+    matrix<T, 1> y(a.rows());
+    matrix_impl::banded_product(a.rows(), a.lower_bandwidth(), a.upper_bandwidth(),
+                                a.data(), x.data() + d.start, d.strides[0],
+                                y.data(), 1);
+    return y;
+  }
+
+
+// Cholesky factorization
+//
+// Compute the lower triangular matrix l such that a = l l^T. Returns false
+// if a is not positive definite, in which case the contents of l are
+// unspecified.
+template <typename T>
+  bool
+  cholesky(const symmetric_matrix<T>& a, triangular_matrix<T>& l)
+  {
+    // The lower triangle of a and l are packed identically.
+    l = triangular_matrix<T>(a.rows(), matrix_triangle::lower);
+    std::copy(a.data(), a.data() + a.packed_size(), l.data());
+    return matrix_impl::cholesky_factor(l.rows(), l.data());
+  }
+
+
+// Solve
+//
+// Solve a x = b, where b is a vector or a 2D matrix whose columns are the
+// right-hand sides, overwriting b with x. The matrix a is not modified.
+//
+// Triangular systems are solved by substitution, symmetric systems by the
+// Cholesky factorization (a must be positive definite), and banded systems
+// by Gaussian elimination without pivoting, which is stable for diagonally
+// dominant and positive definite matrices. Tridiagonal systems use the
+// Thomas algorithm.
+//
+// Returns false if the system cannot be solved in this way, in which case b
+// is left in an unspecified state.
+template <typename T, typename M>
+  bool
+  solve(const triangular_matrix<T>& a, M& b)
+  {
+    static_assert(M::order == 1 || M::order == 2, "");
+    assert(b.extent(0) == a.rows());
+    return matrix_impl::triangular_solve(a.rows(), matrix_impl::rhs_count(b),
+                                         a.triangle(), a.data(),
+                                         matrix_impl::rhs_block(b));
+  }
+
+template <typename T, typename M>
+  bool
+  solve(const symmetric_matrix<T>& a, M& b)
+  {
+    static_assert(M::order == 1 || M::order == 2, "");
+    assert(b.extent(0) == a.rows());
+    triangular_matrix<T> l;
+    if (!cholesky(a, l))
+      return false;
+    const std::size_t n = a.rows();
+    const std::size_t r = matrix_impl::rhs_count(b);
+    auto x = matrix_impl::rhs_block(b);
+    matrix_impl::triangular_solve(n, r, matrix_triangle::lower, l.data(), x);
+    matrix_impl::lower_transpose_solve(n, r, l.data(), x);
+    return true;
+  }
+
+template <typename T, typename M>
+  bool
+  solve(const banded_matrix<T>& a, M& b)
+  {
+    static_assert(M::order == 1 || M::order == 2, "");
+    assert(b.extent(0) == a.rows());
+    const std::size_t n = a.rows();
+    const std::size_t r = matrix_impl::rhs_count(b);
+    auto x = matrix_impl::rhs_block(b);
+
+    if (a.lower_bandwidth() == 1 && a.upper_bandwidth() == 1) {
+      // The subdiagonal, diagonal and superdiagonal are interleaved in rows
+      // of 3 elements.
+      const T* p = a.data();
+      std::vector<Value_type<M>> work(n);
+      for (std::size_t c = 0; c != r; ++c)
+        if (!matrix_impl::thomas(n, p + 3, 3, p + 1, 3, p + 2, 3,
+                                 &x(0, c), x.rs, work.data()))
+          return false;
+      return true;
+    }
+
+    banded_matrix<T> f = a;
+    return matrix_impl::banded_solve(n, a.lower_bandwidth(), a.upper_bandwidth(),
+                                     f.data(), r, x);
+  }
+
+
+// Tridiagonal solve
+//
+// Solve the tridiagonal system with subdiagonal lower (n - 1 elements),
+// diagonal diag (n elements) and superdiagonal upper (n - 1 elements) in
+// O(n) time using the Thomas algorithm, overwriting the vector d with the
+// solution. Returns false if a zero pivot is encountered.
+template <typename M1, typename M2, typename M3, typename M4>
+  bool
+  tridiagonal_solve(const M1& lower, const M2& diag, const M3& upper, M4& d)
+  {
+    static_assert(M1::order == 1 && M2::order == 1, "");
+    static_assert(M3::order == 1 && M4::order == 1, "");
+    const std::size_t n = diag.size();
+    assert(d.size() == n);
+    assert(n == 0 || (lower.size() == n - 1 && upper.size() == n - 1));
+
+    const auto& ld = lower.descriptor();
+    const auto& dd = diag.descriptor();
+    const auto& ud = upper.descriptor();
+    const auto& xd = d.descriptor();
+    std::vector<Value_type<M4>> work(n);
+    return matrix_impl::thomas(n, lower.data() + ld.start, ld.strides[0],
+                               diag.data() + dd.start, dd.strides[0],
+                               upper.data() + ud.start, ud.strides[0],
+                               d.data() + xd.start, xd.strides[0], work.data());
+  }
@@ -0,0 +1,57 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+namespace matrix_impl
+{
+  // ------------------------------------------------------------------------ //
+  //                          Parallel Execution
+  //
+  // Matrix algorithms that operate on independent pieces of work (e.g., the
+  // matrices in a batch or blocks of rows) partition that work into
+  // contiguous chunks and run the chunks on the thread pool shared with the
+  // parallel sequence algorithms (see default_thread_pool). A parallel loop
+  // that is nested in another runs on the same threads, so nesting does not
+  // create more threads than the pool has.
+
+  // Returns the number of threads available to parallel matrix algorithms:
+  // the workers of the pool and the calling thread.
+  inline std::size_t
+  concurrency()
+  {
+    return default_thread_pool().size() + 1;
+  }
+
+  // Partition the index range [0, n) into contiguous chunks of at least
+  // grain indexes and call f(first, last) for each chunk. One chunk is run
+  // on the calling thread, which runs queued tasks of the pool while it
+  // waits for the others. If fewer than two chunks can be formed, f(0, n)
+  // is called directly.
+  //
+  // If any call to f throws, the first such exception is rethrown after
+  // all chunks have finished.
+  template <typename F>
+    void
+    parallel_for(std::size_t n, std::size_t grain, F f)
+    {
+      if (n == 0)
+        return;
+      std::size_t threads = std::min(concurrency(), n / std::max(grain, std::size_t(1)));
+      if (threads < 2) {
+        f(std::size_t(0), n);
+        return;
+      }
+      sequence_impl::parallel_split(default_thread_pool(), n, threads,
+        [&f](std::size_t, std::size_t first, std::size_t last) {
+          f(first, last);
+        });
+    }
+
+} // namespace matrix_impl
@@ -0,0 +1,246 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+
+// -------------------------------------------------------------------------- //
+//                              Buffer Pool
+//
+// Programs that repeatedly create and destroy large matrices of the same
+// shape (e.g., the temporaries of arithmetic expressions) spend much of
+// their time allocating memory and faulting in fresh pages. The buffer pool
+// retains the buffers of destroyed matrices and reuses them for new ones.
+//
+// Each thread has its own pool, so allocation does not synchronize. Buffers
+// are grouped into size classes that are powers of two, and a request is
+// satisfied by any retained buffer of its class. Requests smaller than 4 KiB
+// are not pooled. A buffer returned to the pool when the pool already
+// retains its limit (256 MiB by default) is freed instead. The retained
+// buffers are freed when the thread exits, and buffers returned after that
+// (e.g., by static matrices) are freed directly.
+//
+// A matrix uses the pool when its allocator is a pool_allocator:
+//
+//    pooled_matrix<double, 2> a(1000, 1000);
+//    for (int i = 0; i < n; ++i) {
+//      pooled_matrix<double, 2> t = a * 2.0;    // Reuses a buffer after the
+//      ...                                     // first iteration
+//    }
+
+
+// Statistics describing the buffer pool of a thread.
+struct matrix_pool_stats
+{
+  std::size_t allocations;      // Number of pooled allocations
+  std::size_t hits;             // Allocations that reused a retained buffer
+  std::size_t buffers_retained; // Number of buffers retained for reuse
+  std::size_t bytes_retained;   // Total size of the retained buffers
+
+  // Returns the fraction of pooled allocations that reused a buffer.
+  double hit_rate() const
+  {
+    return allocations ? double(hits) / double(allocations) : 0.0;
+  }
+};
+
+
+namespace matrix_impl
+{
+  inline bool& pool_destroyed();
+
+  class buffer_pool
+  {
+  public:
+    // The smallest pooled size class is 2^min_class bytes, and the largest
+    // is 2^(max_class - 1).
+    static constexpr std::size_t min_class = 12;
+    static constexpr std::size_t max_class = 8 * sizeof(std::size_t) - 1;
+
+    buffer_pool()
+      : stats(), limit(std::size_t(1) << 28)
+    { }
+
+    buffer_pool(const buffer_pool&) = delete;
+    buffer_pool& operator=(const buffer_pool&) = delete;
+
+    ~buffer_pool()
+    {
+      release();
+      pool_destroyed() = true;
+    }
+
+    void* allocate(std::size_t n)
+    {
+      const std::size_t c = size_class(n);
+      if (c == 0)
+        return ::operator new(n);
+
+      ++stats.allocations;
+      std::vector<void*>& list = free[c];
+      if (!list.empty()) {
+        void* p = list.back();
+        list.pop_back();
+        ++stats.hits;
+        --stats.buffers_retained;
+        stats.bytes_retained -= std::size_t(1) << c;
+        return p;
+      }
+      return ::operator new(std::size_t(1) << c);
+    }
+
+    void deallocate(void* p, std::size_t n)
+    {
+      const std::size_t c = size_class(n);
+      if (c == 0 || stats.bytes_retained + (std::size_t(1) << c) > limit) {
+        ::operator delete(p);
+        return;
+      }
+      free[c].push_back(p);
+      ++stats.buffers_retained;
+      stats.bytes_retained += std::size_t(1) << c;
+    }
+
+    // Free all retained buffers.
+    void release()
+    {
+      for (std::vector<void*>& list : free) {
+        for (void* p : list)
+          ::operator delete(p);
+        list.clear();
+      }
+      stats.buffers_retained = 0;
+      stats.bytes_retained = 0;
+    }
+
+    // Returns the size class of an allocation of n bytes, or 0 if it is
+    // not pooled.
+    static std::size_t size_class(std::size_t n)
+    {
+      if (n < (std::size_t(1) << min_class) || n > (std::size_t(1) << (max_class - 1)))
+        return 0;
+      std::size_t c = min_class;
+      while ((std::size_t(1) << c) < n)
+        ++c;
+      return c;
+    }
+
+    matrix_pool_stats stats;
+    std::size_t limit;
+
+  private:
+    std::vector<void*> free[max_class];
+  };
+
+  // Returns true if the pool of the calling thread has been destroyed, i.e.,
+  // during the destruction of static objects after the thread exits.
+  inline bool&
+  pool_destroyed()
+  {
+    static thread_local bool destroyed = false;
+    return destroyed;
+  }
+
+  // Returns the buffer pool of the calling thread.
+  inline buffer_pool&
+  local_pool()
+  {
+    static thread_local buffer_pool pool;
+    return pool;
+  }
+
+  // Allocate and deallocate from the pool of the calling thread, or from
+  // the free store if the pool has been destroyed.
+  inline void*
+  pool_allocate(std::size_t n)
+  {
+    return pool_destroyed() ? ::operator new(n) : local_pool().allocate(n);
+  }
+
+  inline void
+  pool_deallocate(void* p, std::size_t n)
+  {
+    if (pool_destroyed())
+      ::operator delete(p);
+    else
+      local_pool().deallocate(p, n);
+  }
+
+} // namespace matrix_impl
+
+
+// Returns the statistics of the buffer pool of the calling thread.
+inline matrix_pool_stats
+matrix_pool_statistics()
+{
+  return matrix_impl::local_pool().stats;
+}
+
+// Free the buffers retained by the pool of the calling thread.
+inline void
+matrix_pool_release()
+{
+  matrix_impl::local_pool().release();
+}
+
+// Set the maximum number of bytes retained by the pool of the calling
+// thread. Buffers already retained are not freed.
+inline void
+matrix_pool_limit(std::size_t bytes)
+{
+  matrix_impl::local_pool().limit = bytes;
+}
+
+
+// Pool allocator
+//
+// An allocator that allocates from the buffer pool of the calling thread.
+// Memory may be deallocated by a different thread, in which case the buffer
+// is retained by that thread's pool.
+template <typename T>
+  struct pool_allocator
+  {
+    using value_type = T;
+
+    pool_allocator() = default;
+
+    template <typename U>
+      pool_allocator(const pool_allocator<U>&) { }
+
+    T* allocate(std::size_t n)
+    {
+      if (n > std::size_t(-1) / sizeof(T))
+        throw std::bad_alloc();
+      return static_cast<T*>(matrix_impl::pool_allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n)
+    {
+      matrix_impl::pool_deallocate(p, n * sizeof(T));
+    }
+  };
+
+template <typename T, typename U>
+  inline bool
+  operator==(const pool_allocator<T>&, const pool_allocator<U>&)
+  {
+    return true;
+  }
+
+template <typename T, typename U>
+  inline bool
+  operator!=(const pool_allocator<T>&, const pool_allocator<U>&)
+  {
+    return false;
+  }
+
+
+// A matrix whose elements are allocated from the buffer pool.
+template <typename T, std::size_t N>
+  using pooled_matrix = matrix<T, N, pool_allocator<T>>;
@@ -0,0 +1,184 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+// ------------------------------------------------------------------------ //
+//                        Reduced Precision Types
+//
+// The bfloat16 and half types store floating point values in 16 bits for
+// matrices whose size is limited by memory or memory bandwidth. They are
+// storage types only: they convert implicitly to float, so arithmetic on
+// them is performed in single precision. Conversion from float is explicit
+// because it loses precision; it rounds to the nearest representable
+// value, with ties to even.
+
+
+namespace matrix_impl
+{
+  inline std::uint32_t
+  float_bits(float x)
+  {
+    std::uint32_t u;
+    std::memcpy(&u, &x, sizeof(u));
+    return u;
+  }
+
+  inline float
+  bits_float(std::uint32_t u)
+  {
+    float x;
+    std::memcpy(&x, &u, sizeof(x));
+    return x;
+  }
+} // namespace matrix_impl
+
+
+// A bfloat16 value has the sign and 8-bit exponent of a float but only 8
+// bits of significand, i.e., it is the upper half of a float. It has the
+// range of float with about 3 decimal digits of precision.
+class bfloat16
+{
+public:
+  bfloat16() = default;
+
+  explicit bfloat16(float x)
+    : bits(encode(x))
+  { }
+
+  operator float() const
+  {
+    return matrix_impl::bits_float(std::uint32_t(bits) << 16);
+  }
+
+  // Returns the bfloat16 value with the given representation.
+  static bfloat16 from_bits(std::uint16_t b)
+  {
+    bfloat16 x;
+    x.bits = b;
+    return x;
+  }
+
+  std::uint16_t to_bits() const { return bits; }
+
+private:
+  static std::uint16_t encode(float x)
+  {
+    std::uint32_t u = matrix_impl::float_bits(x);
+    if ((u & 0x7fffffff) > 0x7f800000)
+      return std::uint16_t((u >> 16) | 0x40); // Quiet the NaN
+    u += 0x7fff + ((u >> 16) & 1);
+    return std::uint16_t(u >> 16);
+  }
+
+  std::uint16_t bits;
+};
+
+
+// A half value is an IEEE 754 binary16 floating point number, with a 5-bit
+// exponent and 11 bits of significand. Its largest finite value is 65504
+// and it has about 3 decimal digits of precision.
+class half
+{
+public:
+  half() = default;
+
+  explicit half(float x)
+    : bits(encode(x))
+  { }
+
+  operator float() const { return decode(bits); }
+
+  // Returns the half value with the given representation.
+  static half from_bits(std::uint16_t b)
+  {
+    half x;
+    x.bits = b;
+    return x;
+  }
+
+  std::uint16_t to_bits() const { return bits; }
+
+private:
+  static std::uint16_t encode(float x)
+  {
+    const std::uint32_t u = matrix_impl::float_bits(x);
+    const std::uint32_t sign = (u >> 16) & 0x8000;
+    const std::uint32_t a = u & 0x7fffffff;
+
+    // Infinities and NaNs.
+    if (a >= 0x7f800000)
+      return std::uint16_t(sign | 0x7c00 | (a > 0x7f800000 ? 0x200 : 0));
+
+    // Values of at least 65520 round to infinity.
+    if (a >= 0x477ff000)
+      return std::uint16_t(sign | 0x7c00);
+
+    // Values less than 2^-14 are subnormal. Their significand is the
+    // value in units of 2^-24, which is rounded by the conversion.
+    if (a < 0x38800000) {
+      const float m = std::nearbyint(matrix_impl::bits_float(a) * 16777216.0f);
+      return std::uint16_t(sign | std::uint32_t(m));
+    }
+
+    // Rebias the exponent from 127 to 15 and round the significand to
+    // 10 bits. A carry out of the significand correctly increments the
+    // exponent.
+    const std::uint32_t r = a - 0x38000000 + 0xfff + ((a >> 13) & 1);
+    return std::uint16_t(sign | (r >> 13));
+  }
+
+  static float decode(std::uint16_t h)
+  {
+    const std::uint32_t sign = std::uint32_t(h & 0x8000) << 16;
+    const std::uint32_t exp = (h >> 10) & 0x1f;
+    const std::uint32_t mant = h & 0x3ff;
+    if (exp == 0) {
+      const float x = float(mant) * 5.9604644775390625e-8f; // 2^-24
+      return sign ? -x : x;
+    }
+    if (exp == 0x1f)
+      return matrix_impl::bits_float(sign | 0x7f800000 | (mant << 13));
+    return matrix_impl::bits_float(sign | ((exp + 112) << 23) | (mant << 13));
+  }
+
+  std::uint16_t bits;
+};
+
+
+// The accumulator type of T is the type in which sums of products of T
+// values are computed. It is float for the 16-bit floating point types and
+// a 32-bit integer for 8 and 16-bit integers, so that products do not
+// lose precision or overflow. For other types, it is T.
+template <typename T>
+  struct accumulator_type
+  {
+    using type = T;
+  };
+
+template <>
+  struct accumulator_type<bfloat16> { using type = float; };
+
+template <>
+  struct accumulator_type<half> { using type = float; };
+
+template <>
+  struct accumulator_type<std::int8_t> { using type = std::int32_t; };
+
+template <>
+  struct accumulator_type<std::uint8_t> { using type = std::uint32_t; };
+
+template <>
+  struct accumulator_type<std::int16_t> { using type = std::int32_t; };
+
+template <>
+  struct accumulator_type<std::uint16_t> { using type = std::uint32_t; };
+
+template <typename T>
+  using Accumulator_type = typename accumulator_type<Remove_const<T>>::type;
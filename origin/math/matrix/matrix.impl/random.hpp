@@ -0,0 +1,237 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+
+// -------------------------------------------------------------------------- //
+//                            Random Matrices
+//
+// The random fills assign each element of a matrix a value computed from a
+// seed and the index of the element, where elements are indexed in
+// row-major order. Because no generator state is carried from one element
+// to the next, the elements are filled in parallel, and the result depends
+// only on the seed and the extents of the matrix: not on the number of
+// threads or on the layout of the matrix.
+//
+// The value of the kth element is derived from the kth output of the
+// splitmix64 generator started at the seed, which can be computed directly
+// from k. For example:
+//
+//    matrix<double, 2> a(1000, 1000);
+//    fill_uniform(a, 42);                  // Uniform in [0, 1)
+//    fill_normal(a, 42, 0.0, 2.0);         // Normal with mean 0, sd 2
+//
+//    auto s = random_spd<double>(500, 7);  // Symmetric positive definite
+
+
+namespace matrix_impl
+{
+  // Returns the kth output of the splitmix64 generator with the given seed.
+  inline std::uint64_t
+  counter_random(std::uint64_t seed, std::uint64_t k)
+  {
+    std::uint64_t z = seed + (k + 1) * 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+  }
+
+  // Returns a double uniformly distributed in [0, 1), computed from the
+  // kth output of the generator with the given seed.
+  inline double
+  counter_uniform(std::uint64_t seed, std::uint64_t k)
+  {
+    return double(counter_random(seed, k) >> 11) * (1.0 / 9007199254740992.0);
+  }
+
+  // Returns a standard normal deviate computed from the outputs 2k and
+  // 2k + 1 of the generator with the given seed (by the Box-Muller
+  // transform).
+  inline double
+  counter_normal(std::uint64_t seed, std::uint64_t k)
+  {
+    const double u = 1.0 - counter_uniform(seed, 2 * k);
+    const double v = counter_uniform(seed, 2 * k + 1);
+    return std::sqrt(-2.0 * std::log(u)) * std::cos(6.283185307179586 * v);
+  }
+
+  // Returns a + w * u as a V, where u is in [0, 1) and a + w is hi. The
+  // sum can round up to hi, in which case the largest V below hi is
+  // returned instead, so that the result is in [a, hi).
+  template <typename V>
+    inline V
+    uniform_value(double a, double w, V hi, double u)
+    {
+      const V x = V(a + w * u);
+      return x < hi ? x : std::nextafter(hi, V(a));
+    }
+
+  // The number of elements filled by each thread.
+  constexpr std::size_t random_grain = 1 << 15;
+
+  // Assign f(k) to the elements of the slice s of p whose row-major indexes
+  // are in [first, last).
+  template <typename T, std::size_t N, typename F>
+    void
+    random_fill(T* p, const matrix_slice<N>& s, std::size_t first, std::size_t last, F f)
+    {
+      if (first == last)
+        return;
+
+      // Find the index and offset of the first element, and then step
+      // through the elements like an odometer.
+      std::size_t idx[N];
+      std::size_t off = s.start;
+      std::size_t r = first;
+      for (std::size_t d = N; d-- != 0; ) {
+        idx[d] = r % s.extents[d];
+        r /= s.extents[d];
+        off += idx[d] * s.strides[d];
+      }
+      for (std::size_t k = first; k != last; ++k) {
+        p[off] = f(k);
+        for (std::size_t d = N; d-- != 0; ) {
+          off += s.strides[d];
+          if (++idx[d] != s.extents[d])
+            break;
+          off -= s.extents[d] * s.strides[d];
+          idx[d] = 0;
+        }
+      }
+    }
+
+  // Assign f(k) to each element of m, where k is its row-major index.
+  template <typename M, typename F>
+    void
+    parallel_random_fill(M& m, F f)
+    {
+      auto* p = m.data();
+      const auto& s = m.descriptor();
+      parallel_for(s.size, random_grain, [&](std::size_t first, std::size_t last) {
+        random_fill(p, s, first, last, f);
+      });
+    }
+
+  // Returns a random n x n matrix whose off-diagonal elements are uniform in
+  // [-1, 1) and whose diagonal exceeds the sum of the absolute values of
+  // the other elements of its row by 1. If symmetric is true, the (i, j)th
+  // and (j, i)th elements are equal.
+  template <typename T>
+    matrix<T, 2>
+    dominant_matrix(std::size_t n, std::uint64_t seed, bool symmetric)
+    {
+      matrix<T, 2> a(n, n);
+      parallel_for(n, std::max(random_grain / std::max(n, std::size_t(1)), std::size_t(1)),
+        [&](std::size_t first, std::size_t last) {
+          for (std::size_t i = first; i != last; ++i) {
+            T sum = T(0);
+            for (std::size_t j = 0; j != n; ++j) {
+              if (i == j)
+                continue;
+              const std::size_t k = symmetric ? std::max(i, j) * n + std::min(i, j)
+                                              : i * n + j;
+              const T x = T(2.0 * counter_uniform(seed, k) - 1.0);
+              a(i, j) = x;
+              sum += std::abs(x);
+            }
+            a(i, i) = sum + T(1);
+          }
+        });
+      return a;
+    }
+
+} // namespace matrix_impl
+
+
+// Uniform fill
+//
+// Assign to each element of m a value uniformly distributed in [lo, hi),
+// determined by the seed. The value type of m must be a floating point
+// type.
+template <typename M, typename T = Value_type<M>>
+  void
+  fill_uniform(M& m, std::uint64_t seed, T lo = T(0), T hi = T(1))
+  {
+    using V = Value_type<M>;
+    static_assert(std::is_floating_point<V>::value, "");
+    const double a = double(lo);
+    const double w = double(hi) - double(lo);
+    const V b = V(hi);
+    matrix_impl::parallel_random_fill(m, [=](std::size_t k) {
+      return matrix_impl::uniform_value(a, w, b, matrix_impl::counter_uniform(seed, k));
+    });
+  }
+
+
+// Normal fill
+//
+// Assign to each element of m a normally distributed value with the given
+// mean and standard deviation, determined by the seed.
+template <typename M, typename T = Value_type<M>>
+  void
+  fill_normal(M& m, std::uint64_t seed, T mean = T(0), T stddev = T(1))
+  {
+    using V = Value_type<M>;
+    const double mu = double(mean);
+    const double sigma = double(stddev);
+    matrix_impl::parallel_random_fill(m, [=](std::size_t k) {
+      return V(mu + sigma * matrix_impl::counter_normal(seed, k));
+    });
+  }
+
+
+// Sparse fill
+//
+// Assign to each element of m, with probability density, a value uniformly
+// distributed in [lo, hi), and 0 otherwise. The pattern of nonzero elements
+// and their values are determined by the seed. The value type of m must be
+// a floating point type.
+template <typename M, typename T = Value_type<M>>
+  void
+  fill_sparse(M& m, std::uint64_t seed, double density, T lo = T(-1), T hi = T(1))
+  {
+    using V = Value_type<M>;
+    static_assert(std::is_floating_point<V>::value, "");
+    assert(0.0 <= density && density <= 1.0);
+    const double a = double(lo);
+    const double w = double(hi) - double(lo);
+    const V b = V(hi);
+    matrix_impl::parallel_random_fill(m, [=](std::size_t k) -> V {
+      if (matrix_impl::counter_uniform(seed, 2 * k) >= density)
+        return V(0);
+      return matrix_impl::uniform_value(a, w, b, matrix_impl::counter_uniform(seed, 2 * k + 1));
+    });
+  }
+
+
+// Diagonally dominant matrix
+//
+// Returns a random n x n matrix that is strictly diagonally dominant, and
+// therefore nonsingular and well conditioned. The off-diagonal elements are
+// uniform in [-1, 1).
+template <typename T>
+  inline matrix<T, 2>
+  random_diagonally_dominant(std::size_t n, std::uint64_t seed)
+  {
+    return matrix_impl::dominant_matrix<T>(n, seed, false);
+  }
+
+
+// Symmetric positive definite matrix
+//
+// Returns a random n x n symmetric positive definite matrix. The matrix is
+// symmetric and strictly diagonally dominant with a positive diagonal,
+// which implies that it is positive definite.
+template <typename T>
+  inline matrix<T, 2>
+  random_spd(std::size_t n, std::uint64_t seed)
+  {
+    return matrix_impl::dominant_matrix<T>(n, seed, true);
+  }
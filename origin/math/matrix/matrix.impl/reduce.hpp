@@ -0,0 +1,573 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+
+// -------------------------------------------------------------------------- //
+// Reductions                                                   [matrix.reduce]
+//
+// A reduction combines the elements of a matrix into a single value, or
+// combines the elements along one dimension (an axis) of an N-dimensional
+// matrix, giving an (N-1)-dimensional matrix of results.
+//
+//    sum(m)              -- the sum of the elements
+//    mean(m)             -- the arithmetic mean of the elements
+//    norm2(m)            -- the Euclidean (Frobenius) norm of the elements
+//    min(m), max(m)      -- the least and greatest elements
+//    argmin(m), argmax(m) -- the index of the least or greatest element
+//
+// Each reduction has an overload taking an axis. For example, if m has
+// extents (r, c), then sum(m, 0) has extent (c) and holds the sums of the
+// columns of m, and sum(m, 1) has extent (r) and holds the sums of the rows.
+//
+// Floating point sums are accumulated pairwise within each row of elements
+// and with Kahan compensation across rows, so the rounding error does not
+// grow with the number of elements. Large reductions are partitioned across
+// threads. For a given number of threads, the result is deterministic.
+
+
+namespace matrix_impl
+{
+  // The minimum number of elements reduced by each thread.
+  constexpr std::size_t reduce_grain = 1 << 16;
+
+
+  // A compensated (Kahan) accumulator. The compensation term holds the
+  // low-order bits lost by the most recent addition, and is subtracted from
+  // the next value added. Accumulators for non-floating point types simply
+  // add their values.
+  template <typename T, bool = std::is_floating_point<T>::value>
+    struct compensated_sum
+    {
+      compensated_sum() : sum() { }
+
+      void add(const T& x) { sum += x; }
+      void merge(const compensated_sum& x) { sum += x.sum; }
+      T value() const { return sum; }
+
+      T sum;
+    };
+
+  template <typename T>
+    struct compensated_sum<T, true>
+    {
+      compensated_sum() : sum(), comp() { }
+
+      void add(const T& x)
+      {
+        const T y = x - comp;
+        const T t = sum + y;
+        comp = (t - sum) - y;
+        sum = t;
+      }
+
+      void merge(const compensated_sum& x)
+      {
+        add(x.sum);
+        add(-x.comp);
+      }
+
+      T value() const { return sum; }
+
+      T sum;
+      T comp;
+    };
+
+
+  // Returns the sum of f(p[i * s]) for i in [0, n), computed by pairwise
+  // summation. Short sequences are summed into eight independent partial
+  // sums; this breaks the dependency between successive additions and lets
+  // the compiler keep the partial sums in vector registers without
+  // reassociating floating point arithmetic.
+  template <typename T, typename F>
+    T
+    pairwise_sum(const T* p, std::size_t n, std::size_t s, F f)
+    {
+      constexpr std::size_t base = 256;
+      if (n > base) {
+        const std::size_t h = (n / 2 + 7) & ~std::size_t(7);
+        return pairwise_sum(p, h, s, f) + pairwise_sum(p + h * s, n - h, s, f);
+      }
+
+      T a[8] {};
+      std::size_t i = 0;
+      if (s == 1) {
+        for (; i + 8 <= n; i += 8)
+          unroll<0, 8>::apply([&](std::size_t k) { a[k] += f(p[i + k]); });
+      } else {
+        for (; i + 8 <= n; i += 8)
+          unroll<0, 8>::apply([&](std::size_t k) { a[k] += f(p[(i + k) * s]); });
+      }
+      for (; i != n; ++i)
+        a[0] += f(p[i * s]);
+      return ((a[0] + a[1]) + (a[2] + a[3])) + ((a[4] + a[5]) + (a[6] + a[7]));
+    }
+
+
+  // Element projections used by the sum reductions.
+  struct project_value
+  {
+    template <typename T>
+      const T& operator()(const T& x) const { return x; }
+  };
+
+  struct project_square
+  {
+    template <typename T>
+      T operator()(const T& x) const { return x * x; }
+  };
+
+
+  // ------------------------------------------------------------------------ //
+  //                              Reducers
+  //
+  // A reducer describes how a reduction accumulates elements into a state.
+  // A reducer r with element type T provides:
+  //
+  //    r.init()            -- the initial state
+  //    r.add(a, x, i)      -- accumulate the ith element x into the state a
+  //    r.line(p, n, s, i)  -- the state of the n elements p[k * s], the first
+  //                           of which is the ith element
+  //    r.merge(a, b)       -- accumulate the state b, which describes elements
+  //                           following those in a, into a
+  //
+  // The index i is the position of the element in the order of the
+  // reduction. Reducers that do not need it ignore it.
+
+  // Sums the projections f(x) of the elements x.
+  template <typename T, typename F>
+    struct sum_reducer
+    {
+      using state = compensated_sum<T>;
+
+      state init() const { return state(); }
+
+      void add(state& a, const T& x, std::size_t) const { a.add(f(x)); }
+
+      state line(const T* p, std::size_t n, std::size_t s, std::size_t) const
+      {
+        state a;
+        a.add(pairwise_sum(p, n, s, f));
+        return a;
+      }
+
+      void merge(state& a, const state& b) const { a.merge(b); }
+
+      F f;
+    };
+
+  // Finds the greatest (when Max is true) or least element and its index.
+  // The first of several equal extrema is found. Unordered values (NaNs) are
+  // never selected.
+  template <typename T, bool Max>
+    struct extremum_reducer
+    {
+      struct state
+      {
+        T value;
+        std::size_t index;
+      };
+
+      static bool better(const T& x, const T& y) { return Max ? y < x : x < y; }
+
+      // Returns the value that every other value is better than.
+      static T bound()
+      {
+        using L = std::numeric_limits<T>;
+        if (Max)
+          return L::has_infinity ? T(-L::infinity()) : L::lowest();
+        else
+          return L::has_infinity ? L::infinity() : L::max();
+      }
+
+      state init() const { return {bound(), 0}; }
+
+      void add(state& a, const T& x, std::size_t i) const
+      {
+        if (better(x, a.value)) {
+          a.value = x;
+          a.index = i;
+        }
+      }
+
+      state line(const T* p, std::size_t n, std::size_t s, std::size_t i) const
+      {
+        state a = init();
+        for (std::size_t k = 0; k != n; ++k)
+          add(a, p[k * s], i + k);
+        return a;
+      }
+
+      void merge(state& a, const state& b) const
+      {
+        if (better(b.value, a.value))
+          a = b;
+      }
+    };
+
+
+  // ------------------------------------------------------------------------ //
+  //                          Slice Manipulation
+
+  // Returns a slice describing the same elements as s in which as many outer
+  // dimensions as possible are merged into the innermost dimension. The
+  // elements are enumerated in the same order. When s is contiguous, the
+  // result has a single row of s.size elements.
+  template <std::size_t N>
+    matrix_slice<N>
+    merge_inner_extents(matrix_slice<N> s)
+    {
+      for (std::size_t d = N - 1; d-- != 0; ) {
+        if (s.extents[d] != 1 &&
+            s.strides[d] != s.extents[N - 1] * s.strides[N - 1])
+          break;
+        s.extents[N - 1] *= s.extents[d];
+        s.extents[d] = 1;
+      }
+      return s;
+    }
+
+  // Returns the offset of the first element in the nth row of the slice s. A
+  // row is a sequence of elements in the innermost dimension.
+  template <std::size_t N>
+    std::size_t
+    row_offset(const matrix_slice<N>& s, std::size_t n)
+    {
+      std::size_t off = s.start;
+      for (std::size_t d = N - 1; d-- != 0; ) {
+        off += (n % s.extents[d]) * s.strides[d];
+        n /= s.extents[d];
+      }
+      return off;
+    }
+
+  // Returns the (N-1)-dimensional slice of s in which the index in dimension
+  // axis is fixed at n.
+  template <std::size_t N>
+    matrix_slice<N - 1>
+    remove_axis(const matrix_slice<N>& s, std::size_t axis, std::size_t n)
+    {
+      matrix_slice<N - 1> r;
+      r.start = s.start + n * s.strides[axis];
+      r.size = s.extents[axis] ? s.size / s.extents[axis] : 0;
+      for (std::size_t i = 0, j = 0; i != N; ++i) {
+        if (i != axis) {
+          r.extents[j] = s.extents[i];
+          r.strides[j] = s.strides[i];
+          ++j;
+        }
+      }
+      return r;
+    }
+
+  // Returns the slice of s restricted to the indexes [first, last) of its
+  // outermost dimension.
+  template <std::size_t N>
+    matrix_slice<N>
+    restrict_outer(matrix_slice<N> s, std::size_t first, std::size_t last)
+    {
+      s.start += first * s.strides[0];
+      s.size = s.extents[0] ? s.size / s.extents[0] * (last - first) : 0;
+      s.extents[0] = last - first;
+      return s;
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                          Reduction Algorithms
+
+  // Reduce the elements [first, last) of the slice s of p, in row-major
+  // order.
+  template <std::size_t N, typename T, typename R>
+    typename R::state
+    reduce_range(const matrix_slice<N>& s, const T* p,
+                 std::size_t first, std::size_t last, const R& r)
+    {
+      typename R::state a = r.init();
+      const std::size_t n = s.extents[N - 1];
+      const std::size_t st = s.strides[N - 1];
+      while (first != last) {
+        const std::size_t j = first % n;
+        const std::size_t k = std::min(n - j, last - first);
+        r.merge(a, r.line(p + row_offset(s, first / n) + j * st, k, st, first));
+        first += k;
+      }
+      return a;
+    }
+
+  // Reduce all elements of m. The elements are partitioned into contiguous
+  // ranges (in row-major order), which are reduced concurrently and then
+  // merged in order.
+  template <typename M, typename R>
+    typename R::state
+    reduce_all(const M& m, const R& r)
+    {
+      using State = typename R::state;
+      const auto s = merge_inner_extents(m.descriptor());
+      const auto* p = m.data();
+      const std::size_t n = s.size;
+      const std::size_t chunks = std::min(concurrency(), n / reduce_grain);
+      if (chunks < 2)
+        return reduce_range(s, p, 0, n, r);
+
+      std::vector<State> parts(chunks);
+      parallel_for(chunks, 1, [&](std::size_t first, std::size_t last) {
+        for (std::size_t c = first; c != last; ++c)
+          parts[c] = reduce_range(s, p, c * n / chunks, (c + 1) * n / chunks, r);
+      });
+      State a = parts[0];
+      for (std::size_t c = 1; c != chunks; ++c)
+        r.merge(a, parts[c]);
+      return a;
+    }
+
+  // Reduce the elements of m along the given axis, assigning get(a) to each
+  // element of out, where a is the state of the corresponding reduction. The
+  // index passed to the reducer is the index along the axis.
+  //
+  // When the axis is the innermost dimension, each result is the reduction
+  // of one row. Otherwise, the (N-1)-dimensional slices of m along the axis
+  // are accumulated elementwise into a matrix of states, so that m is
+  // traversed in its storage order. In both cases, the results are
+  // partitioned across threads.
+  template <typename M, typename R, typename U, typename G>
+    void
+    reduce_axis(const M& m, std::size_t axis, const R& r,
+                matrix<U, M::order - 1>& out, G get)
+    {
+      constexpr std::size_t N = M::order;
+      using T = Value_type<M>;
+      using State = typename R::state;
+      assert(axis < N);
+
+      const matrix_slice<N> s = m.descriptor();
+      const T* p = m.data();
+      const std::size_t n = s.extents[axis];
+      const matrix_slice<N - 1> e = remove_axis(s, axis, 0);
+      out = matrix<U, N - 1>(matrix_slice<N - 1>(0, e.extents));
+      const std::size_t size = out.size();
+      if (size == 0)
+        return;
+      const std::size_t one = 1;
+
+      if (axis == N - 1) {
+        const std::size_t st = s.strides[N - 1];
+        U* q = out.data();
+        parallel_for(size, std::max(reduce_grain / std::max(n, one), one),
+          [&](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i != last; ++i)
+              q[i] = get(r.line(p + row_offset(s, i), n, st, 0));
+          });
+        return;
+      }
+
+      std::vector<State> acc(size, r.init());
+      const matrix_slice<N - 1> a(0, out.descriptor().extents);
+      const std::size_t outer = a.extents[0];
+      const std::size_t work = n * (size / outer);
+      parallel_for(outer, std::max(reduce_grain / std::max(work, one), one),
+        [&](std::size_t first, std::size_t last) {
+          const auto x = restrict_outer(a, first, last);
+          for (std::size_t k = 0; k != n; ++k) {
+            const auto y = restrict_outer(remove_axis(s, axis, k), first, last);
+            elementwise(x, acc.data(), y, p, [&r, k](State& z, const T& e) {
+              r.add(z, e, k);
+            });
+          }
+          U* q = out.data();
+          for (std::size_t i = x.start; i != x.start + x.size; ++i)
+            q[i] = get(acc[i]);
+        });
+    }
+
+} // namespace matrix_impl
+
+
+// Sum
+//
+// Returns the sum of the elements of m, or the matrix of sums of the
+// elements of m along the given axis.
+template <typename M>
+  inline Requires<Matrix<M>(), Value_type<M>>
+  sum(const M& m)
+  {
+    using T = Value_type<M>;
+    matrix_impl::sum_reducer<T, matrix_impl::project_value> r {};
+    return matrix_impl::reduce_all(m, r).value();
+  }
+
+template <typename M>
+  inline Requires<Matrix<M>(), matrix<Value_type<M>, M::order - 1>>
+  sum(const M& m, std::size_t axis)
+  {
+    using T = Value_type<M>;
+    using R = matrix_impl::sum_reducer<T, matrix_impl::project_value>;
+    matrix<T, M::order - 1> result;
+    matrix_impl::reduce_axis(m, axis, R {}, result,
+                             [](const typename R::state& a) { return a.value(); });
+    return result;
+  }
+
+
+// Mean
+//
+// Returns the arithmetic mean of the elements of m, or the matrix of means
+// of the elements of m along the given axis. For integral element types, the
+// division truncates.
+template <typename M>
+  inline Requires<Matrix<M>(), Value_type<M>>
+  mean(const M& m)
+  {
+    using T = Value_type<M>;
+    assert(m.size() != 0);
+    return sum(m) / T(m.size());
+  }
+
+template <typename M>
+  inline Requires<Matrix<M>(), matrix<Value_type<M>, M::order - 1>>
+  mean(const M& m, std::size_t axis)
+  {
+    using T = Value_type<M>;
+    assert(m.extent(axis) != 0);
+    matrix<T, M::order - 1> result = sum(m, axis);
+    result /= T(m.extent(axis));
+    return result;
+  }
+
+
+// Euclidean norm
+//
+// Returns the square root of the sum of the squares of the elements of m
+// (the Frobenius norm when m is 2D), or the matrix of those norms along the
+// given axis.
+template <typename M>
+  inline Requires<Matrix<M>(), Value_type<M>>
+  norm2(const M& m)
+  {
+    using T = Value_type<M>;
+    using std::sqrt;
+    matrix_impl::sum_reducer<T, matrix_impl::project_square> r {};
+    return sqrt(matrix_impl::reduce_all(m, r).value());
+  }
+
+template <typename M>
+  inline Requires<Matrix<M>(), matrix<Value_type<M>, M::order - 1>>
+  norm2(const M& m, std::size_t axis)
+  {
+    using T = Value_type<M>;
+    using R = matrix_impl::sum_reducer<T, matrix_impl::project_square>;
+    matrix<T, M::order - 1> result;
+    matrix_impl::reduce_axis(m, axis, R {}, result,
+      [](const typename R::state& a) { using std::sqrt; return sqrt(a.value()); });
+    return result;
+  }
+
+
+// Minimum and maximum
+//
+// Returns the least or greatest element of m, or the matrix of the least or
+// greatest elements of m along the given axis. The matrix m must not be
+// empty.
+//
+// NOTE: The whole-matrix overloads take M& (deducing a const M for constant
+// matrices) so that they are preferred over the range algorithms min(R&&)
+// and max(R&&) for lvalue matrices.
+template <typename M>
+  inline Requires<Matrix<M>(), Value_type<M>>
+  min(M& m)
+  {
+    assert(m.size() != 0);
+    matrix_impl::extremum_reducer<Value_type<M>, false> r;
+    return matrix_impl::reduce_all(m, r).value;
+  }
+
+template <typename M>
+  inline Requires<Matrix<M>(), matrix<Value_type<M>, M::order - 1>>
+  min(const M& m, std::size_t axis)
+  {
+    using T = Value_type<M>;
+    using R = matrix_impl::extremum_reducer<T, false>;
+    assert(m.extent(axis) != 0);
+    matrix<T, M::order - 1> result;
+    matrix_impl::reduce_axis(m, axis, R {}, result,
+                             [](const typename R::state& a) { return a.value; });
+    return result;
+  }
+
+template <typename M>
+  inline Requires<Matrix<M>(), Value_type<M>>
+  max(M& m)
+  {
+    assert(m.size() != 0);
+    matrix_impl::extremum_reducer<Value_type<M>, true> r;
+    return matrix_impl::reduce_all(m, r).value;
+  }
+
+template <typename M>
+  inline Requires<Matrix<M>(), matrix<Value_type<M>, M::order - 1>>
+  max(const M& m, std::size_t axis)
+  {
+    using T = Value_type<M>;
+    using R = matrix_impl::extremum_reducer<T, true>;
+    assert(m.extent(axis) != 0);
+    matrix<T, M::order - 1> result;
+    matrix_impl::reduce_axis(m, axis, R {}, result,
+                             [](const typename R::state& a) { return a.value; });
+    return result;
+  }
+
+
+// Argmin and argmax
+//
+// Returns the position of the first least or greatest element of m, or the
+// matrix of the indexes of the least or greatest elements along the given
+// axis. The position of an element in the whole matrix is its index in
+// row-major order. The matrix m must not be empty.
+template <typename M>
+  inline Requires<Matrix<M>(), std::size_t>
+  argmin(const M& m)
+  {
+    assert(m.size() != 0);
+    matrix_impl::extremum_reducer<Value_type<M>, false> r;
+    return matrix_impl::reduce_all(m, r).index;
+  }
+
+template <typename M>
+  inline Requires<Matrix<M>(), matrix<std::size_t, M::order - 1>>
+  argmin(const M& m, std::size_t axis)
+  {
+    using R = matrix_impl::extremum_reducer<Value_type<M>, false>;
+    assert(m.extent(axis) != 0);
+    matrix<std::size_t, M::order - 1> result;
+    matrix_impl::reduce_axis(m, axis, R {}, result,
+                             [](const typename R::state& a) { return a.index; });
+    return result;
+  }
+
+template <typename M>
+  inline Requires<Matrix<M>(), std::size_t>
+  argmax(const M& m)
+  {
+    assert(m.size() != 0);
+    matrix_impl::extremum_reducer<Value_type<M>, true> r;
+    return matrix_impl::reduce_all(m, r).index;
+  }
+
+template <typename M>
+  inline Requires<Matrix<M>(), matrix<std::size_t, M::order - 1>>
+  argmax(const M& m, std::size_t axis)
+  {
+    using R = matrix_impl::extremum_reducer<Value_type<M>, true>;
+    assert(m.extent(axis) != 0);
+    matrix<std::size_t, M::order - 1> result;
+    matrix_impl::reduce_axis(m, axis, R {}, result,
+                             [](const typename R::state& a) { return a.index; });
+    return result;
+  }
@@ -51,6 +51,23 @@ template<typename C, typename T>
 
 
 
+// -------------------------------------------------------------------------- //
+//                                Layout
+//
+// The layout of a matrix determines the order in which its elements are
+// stored in memory. In row-major layout, the elements of each row are
+// contiguous (the last index varies fastest). In column-major layout, the
+// elements of each column are contiguous (the first index varies fastest).
+//
+// A layout is expressed entirely by the strides of a slice, so every
+// algorithm that respects strides also respects the layout.
+enum class matrix_layout
+{
+  row_major,
+  column_major
+};
+
+
 // -------------------------------------------------------------------------- //
 //                                Matrix Slice
 //
@@ -66,7 +83,12 @@ template<std::size_t N>
   {
     static constexpr std::size_t order = N;
 
-    matrix_slice() = default;
+    // Default construction
+    //
+    // The default slice describes an empty matrix.
+    matrix_slice()
+      : size(0), start(0), extents{}, strides{}
+    { }
 
     // Copy semantics
     matrix_slice(const matrix_slice&) = default;
@@ -78,9 +100,20 @@ template<std::size_t N>
     template<typename R, typename = Requires<Range<R>()>>
       matrix_slice(std::size_t s, R&& range);
 
+    // Create a slice from a range of extents with a starting offset, s,
+    // whose strides describe contiguous elements in the layout, l.
+    template<typename R, typename = Requires<Range<R>()>>
+      matrix_slice(std::size_t s, R&& range, matrix_layout l);
+
     // Create a slice with a starting offset s, and the extents, exts.
     matrix_slice(std::size_t s, std::initializer_list<std::size_t> exts);
 
+    // Create a slice with a starting offset s, and the extents, exts, whose
+    // strides describe contiguous elements in the layout, l.
+    matrix_slice(std::size_t s, 
+                 std::initializer_list<std::size_t> exts,
+                 matrix_layout l);
+
     // Create a slice with a starting offset s, a sequence of extents (exts),
     // and a sequence of strides (strs).
     matrix_slice(std::size_t s, 
@@ -139,7 +172,7 @@ template<std::size_t N>
       matrix_slice<N-1> row(std::size_t n) const;
 
   private:
-    void init();
+    void init(matrix_layout l = matrix_layout::row_major);
     
     template<std::size_t M, typename T, typename... Args>
       std::size_t do_slice(const matrix_slice<M>&, const T&, const Args&...);
@@ -172,6 +205,17 @@ template<std::size_t N>
       init();
     }
 
+template<std::size_t N>
+  template<typename R, typename X>
+    matrix_slice<N>::matrix_slice(std::size_t s, R&& range, matrix_layout l)
+      : start(s)
+    {
+      using std::begin;
+      using std::end;
+      std::copy(begin(range), end(range), extents);
+      init(l);
+    }
+
 template<std::size_t N>
   matrix_slice<N>::matrix_slice(std::size_t s, 
                                 std::initializer_list<std::size_t> exts)
@@ -182,6 +226,17 @@ template<std::size_t N>
     init();
   }
 
+template<std::size_t N>
+  matrix_slice<N>::matrix_slice(std::size_t s, 
+                                std::initializer_list<std::size_t> exts,
+                                matrix_layout l)
+    : start(s)
+  {
+    assert(exts.size() == N);
+    std::copy(exts.begin(), exts.end(), extents);
+    init(l);
+  }
+
 template<std::size_t N>
   matrix_slice<N>::matrix_slice(std::size_t s, 
                                 std::initializer_list<std::size_t> exts,
@@ -192,7 +247,8 @@ template<std::size_t N>
     assert(strs.size() == N);
     std::copy(exts.begin(), exts.end(), extents);
     std::copy(strs.begin(), strs.end(), strides);
-    size = extents[0] * strides[0];
+    std::multiplies<std::size_t> mul;
+    size = std::accumulate(extents, extents + N, std::size_t(1), mul);
   }
 
 template<std::size_t N>
@@ -331,18 +387,28 @@ template<std::size_t N>
 
 
 
-// Initialize the stride vector so that it computes offsets in row-major order.
-// This is effectively the partial product of extents, computed in reverse,
-// with 1 being the stride in the innermost dimension.
+// Initialize the stride vector so that it computes offsets in the layout l.
+// For row-major order, this is effectively the partial product of extents,
+// computed in reverse, with 1 being the stride in the innermost dimension.
+// For column-major order, the partial products are computed forwards, with 1
+// being the stride in the outermost dimension.
 template<std::size_t N>
   inline void
-  matrix_slice<N>::init()
+  matrix_slice<N>::init(matrix_layout l)
   {
-    strides[N - 1] = 1;
-    for (std::size_t i = N - 1; i != 0; --i) {
-      strides[i - 1] = strides[i] * extents[i];
+    if (l == matrix_layout::row_major) {
+      strides[N - 1] = 1;
+      for (std::size_t i = N - 1; i != 0; --i) {
+        strides[i - 1] = strides[i] * extents[i];
+      }
+    } else {
+      strides[0] = 1;
+      for (std::size_t i = 1; i != N; ++i) {
+        strides[i] = strides[i - 1] * extents[i - 1];
+      }
     }
-    size = extents[0] * strides[0];
+    std::multiplies<std::size_t> mul;
+    size = std::accumulate(extents, extents + N, std::size_t(1), mul);
   }
 
 
@@ -426,6 +492,172 @@ template<std::size_t N>
     }
 
 
+// -------------------------------------------------------------------------- //
+//                           Slice Transformations
+//
+// The following operations compute new descriptors over the same elements as
+// a given slice. Because a slice stores explicit strides, transposition,
+// axis permutation, diagonal selection and striding are all expressed by
+// rearranging or scaling extents and strides. No elements are moved.
+
+
+// Returns a slice whose ith dimension is the axes[i]th dimension of s. The
+// axes array must be a permutation of 0, 1, ..., N - 1.
+template <std::size_t N>
+  inline matrix_slice<N>
+  permute(const matrix_slice<N>& s, const std::array<std::size_t, N>& axes)
+  {
+    matrix_slice<N> r;
+    r.start = s.start;
+    r.size = s.size;
+    for (std::size_t i = 0; i < N; ++i) {
+      assert(axes[i] < N);
+      r.extents[i] = s.extents[axes[i]];
+      r.strides[i] = s.strides[axes[i]];
+    }
+    return r;
+  }
+
+// Returns the transpose of a 2D slice. Rows and columns are exchanged by
+// swapping the extents and strides.
+inline matrix_slice<2>
+transpose(const matrix_slice<2>& s)
+{
+  return permute(s, {{1, 0}});
+}
+
+// Returns a 1D slice describing the main diagonal of a 2D slice. The stride
+// between diagonal elements is the sum of the row and column strides.
+inline matrix_slice<1>
+diagonal(const matrix_slice<2>& s)
+{
+  std::size_t n = std::min(s.extents[0], s.extents[1]);
+  return {s.start, {n}, {s.strides[0] + s.strides[1]}};
+}
+
+// Returns a slice that selects every steps[i]th element in the ith dimension,
+// starting with the first.
+template <std::size_t N>
+  inline matrix_slice<N>
+  strided(const matrix_slice<N>& s, const std::array<std::size_t, N>& steps)
+  {
+    matrix_slice<N> r;
+    r.start = s.start;
+    r.size = 1;
+    for (std::size_t i = 0; i < N; ++i) {
+      assert(steps[i] != 0);
+      r.extents[i] = (s.extents[i] + steps[i] - 1) / steps[i];
+      r.strides[i] = s.strides[i] * steps[i];
+      r.size *= r.extents[i];
+    }
+    return r;
+  }
+
+// Returns the layout of the slice s: column-major if its first dimension
+// is the one with unit stride, and row-major otherwise. A 1D slice is always
+// row-major.
+template <std::size_t N>
+  inline matrix_layout
+  layout(const matrix_slice<N>& s)
+  {
+    if (N > 1 && s.strides[0] == 1 && s.strides[N - 1] != 1)
+      return matrix_layout::column_major;
+    else
+      return matrix_layout::row_major;
+  }
+
+// Returns a slice whose dimensions are those of s in reverse order. The
+// reverse of a column-major slice is row-major, and vice versa.
+template <std::size_t N>
+  inline matrix_slice<N>
+  reverse_axes(const matrix_slice<N>& s)
+  {
+    matrix_slice<N> r;
+    r.start = s.start;
+    r.size = s.size;
+    for (std::size_t i = 0; i < N; ++i) {
+      r.extents[i] = s.extents[N - 1 - i];
+      r.strides[i] = s.strides[N - 1 - i];
+    }
+    return r;
+  }
+
+namespace matrix_impl
+{
+  // Returns true if the slice s can be broadcast to the N extents pointed to
+  // by exts. Extents are compared from the innermost dimension outwards; each
+  // extent of s must be equal to the corresponding extent or 1.
+  template <std::size_t N, std::size_t M>
+    inline bool
+    is_broadcastable(const matrix_slice<M>& s, const std::size_t* exts)
+    {
+      static_assert(M <= N, "");
+      for (std::size_t i = 0; i < M; ++i) {
+        const std::size_t e = s.extents[i];
+        if (e != exts[N - M + i] && e != 1)
+          return false;
+      }
+      return true;
+    }
+
+  // Returns a slice with the N extents pointed to by exts that refers to the
+  // elements of s, repeated along each broadcast dimension. See broadcast().
+  template <std::size_t N, std::size_t M>
+    matrix_slice<N>
+    broadcast_slice(const matrix_slice<M>& s, const std::size_t* exts)
+    {
+      assert((is_broadcastable<N>(s, exts)));
+      matrix_slice<N> r;
+      r.start = s.start;
+      r.size = 1;
+      for (std::size_t i = 0; i < N; ++i) {
+        r.extents[i] = exts[i];
+        r.size *= exts[i];
+        if (i < N - M)
+          r.strides[i] = 0;
+        else
+          r.strides[i] = s.extents[i - (N - M)] == exts[i] 
+                       ? s.strides[i - (N - M)] : 0;
+      }
+      return r;
+    }
+
+  // Compute the extents of the result of a broadcast operation on the slices
+  // a and b, storing them in exts. The order of the result is the larger of
+  // the two orders. Returns false if the extents are incompatible.
+  template <std::size_t N, std::size_t M1, std::size_t M2>
+    bool
+    broadcast_extents(const matrix_slice<M1>& a, 
+                      const matrix_slice<M2>& b, 
+                      std::size_t* exts)
+    {
+      static_assert(N == (M1 < M2 ? M2 : M1), "");
+      for (std::size_t i = 0; i < N; ++i) {
+        std::size_t x = i < N - M1 ? 1 : a.extents[i - (N - M1)];
+        std::size_t y = i < N - M2 ? 1 : b.extents[i - (N - M2)];
+        if (x != y && x != 1 && y != 1)
+          return false;
+        exts[i] = x == 1 ? y : x;
+      }
+      return true;
+    }
+
+} // namespace matrix_impl
+
+
+// Returns a slice of order N with the given extents that repeats the elements
+// of s along each broadcast dimension, following the usual broadcasting rules
+// for arrays: the extents of s are aligned with the innermost extents, and
+// each must be equal to its target extent or 1. Repetition is expressed by a
+// stride of 0, so no elements are copied.
+template <std::size_t N, std::size_t M>
+  inline matrix_slice<N>
+  broadcast(const matrix_slice<M>& s, const std::array<std::size_t, N>& exts)
+  {
+    return matrix_impl::broadcast_slice<N>(s, exts.data());
+  }
+
+
 // -------------------------------------------------------------------------- //
 //                              Equality Comparison
 //
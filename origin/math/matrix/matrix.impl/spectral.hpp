@@ -0,0 +1,529 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+
+// -------------------------------------------------------------------------- //
+//                        Spectral Decompositions
+//
+// The symmetric eigendecomposition and the singular value decomposition of
+// dense matrices. The algorithms work on copies of their arguments, stored
+// so that the vectors being transformed are contiguous rows, and use the
+// dot and axpy kernels for their inner loops.
+//
+// The decompositions return false if the iteration fails to converge, which
+// does not happen for matrices with finite elements in practice.
+
+namespace matrix_impl
+{
+  // Reduce the symmetric matrix at v (n x n) to tridiagonal form using
+  // Householder reflections. On return, d holds the diagonal, e holds the
+  // subdiagonal in e[1] .. e[n - 1], and v holds the orthogonal matrix that
+  // accumulates the reflections.
+  //
+  // This is the tred2 procedure of the EISPACK library.
+  template <typename T>
+    void
+    tridiagonalize(std::size_t n, matrix_cursor<T, 2> v, T* d, T* e)
+    {
+      for (std::size_t j = 0; j != n; ++j)
+        d[j] = v(n - 1, j);
+
+      for (std::size_t i = n - 1; i != 0; --i) {
+        T scale = T(0);
+        T h = T(0);
+        for (std::size_t k = 0; k != i; ++k)
+          scale += std::abs(d[k]);
+
+        if (scale == T(0)) {
+          e[i] = d[i - 1];
+          for (std::size_t j = 0; j != i; ++j) {
+            d[j] = v(i - 1, j);
+            v(i, j) = T(0);
+            v(j, i) = T(0);
+          }
+        } else {
+          // Generate the Householder vector.
+          for (std::size_t k = 0; k != i; ++k) {
+            d[k] /= scale;
+            h += d[k] * d[k];
+          }
+          T f = d[i - 1];
+          T g = std::sqrt(h);
+          if (f > T(0))
+            g = -g;
+          e[i] = scale * g;
+          h -= f * g;
+          d[i - 1] = f - g;
+          for (std::size_t j = 0; j != i; ++j)
+            e[j] = T(0);
+
+          // Apply the similarity transformation to the remaining columns.
+          for (std::size_t j = 0; j != i; ++j) {
+            f = d[j];
+            v(j, i) = f;
+            g = e[j] + v(j, j) * f;
+            for (std::size_t k = j + 1; k != i; ++k) {
+              g += v(k, j) * d[k];
+              e[k] += v(k, j) * f;
+            }
+            e[j] = g;
+          }
+          f = T(0);
+          for (std::size_t j = 0; j != i; ++j) {
+            e[j] /= h;
+            f += e[j] * d[j];
+          }
+          const T hh = f / (h + h);
+          for (std::size_t j = 0; j != i; ++j)
+            e[j] -= hh * d[j];
+          for (std::size_t j = 0; j != i; ++j) {
+            f = d[j];
+            g = e[j];
+            for (std::size_t k = j; k != i; ++k)
+              v(k, j) -= (f * e[k] + g * d[k]);
+            d[j] = v(i - 1, j);
+            v(i, j) = T(0);
+          }
+        }
+        d[i] = h;
+      }
+
+      // Accumulate the transformations.
+      for (std::size_t i = 0; i + 1 < n; ++i) {
+        v(n - 1, i) = v(i, i);
+        v(i, i) = T(1);
+        const T h = d[i + 1];
+        if (h != T(0)) {
+          for (std::size_t k = 0; k <= i; ++k)
+            d[k] = v(k, i + 1) / h;
+          for (std::size_t j = 0; j <= i; ++j) {
+            T g = T(0);
+            for (std::size_t k = 0; k <= i; ++k)
+              g += v(k, i + 1) * v(k, j);
+            for (std::size_t k = 0; k <= i; ++k)
+              v(k, j) -= g * d[k];
+          }
+        }
+        for (std::size_t k = 0; k <= i; ++k)
+          v(k, i + 1) = T(0);
+      }
+      for (std::size_t j = 0; j != n; ++j) {
+        d[j] = v(n - 1, j);
+        v(n - 1, j) = T(0);
+      }
+      v(n - 1, n - 1) = T(1);
+      e[0] = T(0);
+    }
+
+  // Compute the eigenvalues of the symmetric tridiagonal matrix with
+  // diagonal d and subdiagonal e[1] .. e[n - 1] using the QL algorithm with
+  // implicit shifts. The eigenvalues are stored in d. If z is not null, the
+  // plane rotations are also applied to its n rows of length n, so that if
+  // z initially holds the (transposed) reduction computed by tridiagonalize,
+  // its rows become the eigenvectors.
+  //
+  // This is the tql2 procedure of the EISPACK library. Returns false if an
+  // eigenvalue does not converge.
+  template <typename T>
+    bool
+    tridiagonal_ql(std::size_t n, T* d, T* e, T* z)
+    {
+      constexpr int max_iterations = 60;
+      const T eps = std::numeric_limits<T>::epsilon();
+
+      for (std::size_t i = 1; i < n; ++i)
+        e[i - 1] = e[i];
+      e[n - 1] = T(0);
+
+      T f = T(0);
+      T tst1 = T(0);
+      for (std::size_t l = 0; l != n; ++l) {
+        // Find a small subdiagonal element.
+        tst1 = std::max(tst1, std::abs(d[l]) + std::abs(e[l]));
+        std::size_t m = l;
+        while (m < n - 1 && std::abs(e[m]) > eps * tst1)
+          ++m;
+
+        // If m == l, d[l] is already an eigenvalue. Otherwise, iterate.
+        if (m > l) {
+          int iter = 0;
+          do {
+            if (++iter > max_iterations)
+              return false;
+
+            // Compute the implicit shift.
+            T g = d[l];
+            T p = (d[l + 1] - g) / (T(2) * e[l]);
+            T r = std::hypot(p, T(1));
+            if (p < T(0))
+              r = -r;
+            d[l] = e[l] / (p + r);
+            d[l + 1] = e[l] * (p + r);
+            const T dl1 = d[l + 1];
+            T h = g - d[l];
+            for (std::size_t i = l + 2; i < n; ++i)
+              d[i] -= h;
+            f += h;
+
+            // Implicit QL transformation.
+            p = d[m];
+            T c = T(1), c2 = c, c3 = c;
+            const T el1 = e[l + 1];
+            T s = T(0), s2 = T(0);
+            for (std::size_t i = m; i-- > l; ) {
+              c3 = c2;
+              c2 = c;
+              s2 = s;
+              g = c * e[i];
+              h = c * p;
+              r = std::hypot(p, e[i]);
+              e[i + 1] = s * r;
+              s = e[i] / r;
+              c = p / r;
+              p = c * d[i] - s * g;
+              d[i + 1] = h + s * (c * g + s * d[i]);
+
+              // Rotate the rows i and i + 1 of z.
+              if (z) {
+                T* zi = z + i * n;
+                T* zj = zi + n;
+                for (std::size_t k = 0; k != n; ++k) {
+                  const T t = zj[k];
+                  zj[k] = s * zi[k] + c * t;
+                  zi[k] = c * zi[k] - s * t;
+                }
+              }
+            }
+            p = -s * s2 * c3 * el1 * e[l] / dl1;
+            e[l] = s * p;
+            d[l] = c * p;
+          } while (std::abs(e[l]) > eps * tst1);
+        }
+        d[l] += f;
+        e[l] = T(0);
+      }
+      return true;
+    }
+
+  // Returns the indexes of the n values in x, sorted so that the values are
+  // ascending (or descending).
+  template <typename T>
+    std::vector<std::size_t>
+    sorted_indexes(std::size_t n, const T* x, bool descending)
+    {
+      std::vector<std::size_t> idx(n);
+      std::iota(idx.begin(), idx.end(), std::size_t(0));
+      std::stable_sort(idx.begin(), idx.end(), [&](std::size_t i, std::size_t j) {
+        return descending ? x[j] < x[i] : x[i] < x[j];
+      });
+      return idx;
+    }
+
+
+  // Orthogonalize the rows of w (n rows of length m) using one-sided
+  // Jacobi rotations, applying the same rotations to the rows of v (n rows
+  // of length n). A pair of rows is rotated until their inner product is
+  // negligible relative to their norms. Returns false if the rows are not
+  // orthogonal after the maximum number of sweeps.
+  template <typename T>
+    bool
+    jacobi_orthogonalize(std::size_t n, std::size_t m, T* w, T* v)
+    {
+      constexpr int max_sweeps = 60;
+      const T eps = std::numeric_limits<T>::epsilon();
+      for (int sweep = 0; sweep != max_sweeps; ++sweep) {
+        bool rotated = false;
+        for (std::size_t p = 0; p < n; ++p) {
+          T* wp = w + p * m;
+          for (std::size_t q = p + 1; q < n; ++q) {
+            T* wq = w + q * m;
+            const T alpha = dot(m, wp, 1, wp, 1);
+            const T beta = dot(m, wq, 1, wq, 1);
+            const T gamma = dot(m, wp, 1, wq, 1);
+            if (std::abs(gamma) <= eps * std::sqrt(alpha * beta))
+              continue;
+            rotated = true;
+
+            // Compute the rotation that annihilates gamma.
+            const T zeta = (beta - alpha) / (T(2) * gamma);
+            const T t = (zeta < T(0) ? T(-1) : T(1))
+                      / (std::abs(zeta) + std::hypot(T(1), zeta));
+            const T c = T(1) / std::hypot(T(1), t);
+            const T s = c * t;
+
+            T* vp = v + p * n;
+            T* vq = v + q * n;
+            for (std::size_t k = 0; k != m; ++k) {
+              const T x = wp[k];
+              wp[k] = c * x - s * wq[k];
+              wq[k] = s * x + c * wq[k];
+            }
+            for (std::size_t k = 0; k != n; ++k) {
+              const T x = vp[k];
+              vp[k] = c * x - s * vq[k];
+              vq[k] = s * x + c * vq[k];
+            }
+          }
+        }
+        if (!rotated)
+          return true;
+      }
+      return false;
+    }
+
+  // Compute the thin SVD of the m x n matrix a, m >= n, given its transpose
+  // at (n x m). On return, u is m x n, s has n elements in descending order,
+  // and v is n x n.
+  template <typename T>
+    bool
+    jacobi_svd(std::size_t m, std::size_t n, matrix<T, 2>& at,
+               matrix<T, 2>& u, matrix<T, 1>& s, matrix<T, 2>& v)
+    {
+      matrix<T, 2> vt(n, n);
+      for (std::size_t i = 0; i != n; ++i)
+        vt(i, i) = T(1);
+      if (!jacobi_orthogonalize(n, m, at.data(), vt.data()))
+        return false;
+
+      // The rows of at are now orthogonal. Their norms are the singular
+      // values, and the normalized rows are the left singular vectors.
+      std::vector<T> norms(n);
+      for (std::size_t i = 0; i != n; ++i)
+        norms[i] = std::sqrt(dot(m, &at(i, 0), 1, &at(i, 0), 1));
+      std::vector<std::size_t> idx = sorted_indexes(n, norms.data(), true);
+
+      u = matrix<T, 2>(m, n);
+      s = matrix<T, 1>(n);
+      v = matrix<T, 2>(n, n);
+      auto uc = cursor(u);
+      auto vc = cursor(v);
+      for (std::size_t j = 0; j != n; ++j, uc.move(1), vc.move(1)) {
+        const std::size_t k = idx[j];
+        s(j) = norms[k];
+        const T r = norms[k] == T(0) ? T(0) : T(1) / norms[k];
+        const T* x = &at(k, 0);
+        const T* y = &vt(k, 0);
+        auto ucol = uc.line(0);
+        auto vcol = vc.line(0);
+        for (std::size_t i = 0; i != m; ++i)
+          ucol[i] = x[i] * r;
+        for (std::size_t i = 0; i != n; ++i)
+          vcol[i] = y[i];
+      }
+      return true;
+    }
+
+  // Orthonormalize the rows of q (n rows of length m) using the modified
+  // Gram-Schmidt process, repeated once to restore orthogonality lost to
+  // rounding. Rows that are linearly dependent on the preceding rows are
+  // set to 0.
+  template <typename T>
+    void
+    orthonormalize_rows(std::size_t n, std::size_t m, T* q)
+    {
+      for (std::size_t i = 0; i != n; ++i) {
+        T* qi = q + i * m;
+        const T norm0 = std::sqrt(dot(m, qi, 1, qi, 1));
+        for (int pass = 0; pass != 2; ++pass)
+          for (std::size_t j = 0; j != i; ++j) {
+            const T* qj = q + j * m;
+            axpy(m, -dot(m, qj, 1, qi, 1), qj, 1, qi, 1);
+          }
+        const T norm = std::sqrt(dot(m, qi, 1, qi, 1));
+        if (norm <= norm0 * T(m) * std::numeric_limits<T>::epsilon())
+          scal(m, T(0), qi, 1);
+        else
+          scal(m, T(1) / norm, qi, 1);
+      }
+    }
+
+} // namespace matrix_impl
+
+
+// Symmetric eigendecomposition
+//
+// Compute the eigenvalues and eigenvectors of the symmetric n x n matrix a,
+// so that a v = v diag(w). The eigenvalues are stored in ascending order in
+// w, and the corresponding orthonormal eigenvectors are the columns of v.
+// Only the lower triangle of a is used, so a may be a symmetric_matrix.
+//
+// The matrix is reduced to tridiagonal form by Householder reflections,
+// whose eigenvalues are found by the implicit QL algorithm. Returns false
+// if the iteration does not converge.
+template <typename M, typename T>
+  bool
+  symmetric_eigen(const M& a, matrix<T, 1>& w, matrix<T, 2>& v)
+  {
+    static_assert(M::order == 2, "");
+    assert(a.extent(0) == a.extent(1));
+    const std::size_t n = a.extent(0);
+    w = matrix<T, 1>(n);
+    v = matrix<T, 2>(n, n);
+    if (n == 0)
+      return true;
+
+    for (std::size_t i = 0; i != n; ++i)
+      for (std::size_t j = 0; j <= i; ++j)
+        v(i, j) = v(j, i) = a(i, j);
+
+    std::vector<T> e(n);
+    matrix_impl::tridiagonalize(n, cursor(v), w.data(), e.data());
+
+    // Rotate the rows of the transposed transformation, which are
+    // contiguous.
+    matrix<T, 2> z = transpose(v);
+    if (!matrix_impl::tridiagonal_ql(n, w.data(), e.data(), z.data()))
+      return false;
+
+    std::vector<std::size_t> idx = matrix_impl::sorted_indexes(n, w.data(), false);
+    matrix<T, 1> d = w;
+    auto vc = cursor(v);
+    for (std::size_t j = 0; j != n; ++j, vc.move(1)) {
+      w(j) = d(idx[j]);
+      const T* x = &z(idx[j], 0);
+      auto col = vc.line(0);
+      for (std::size_t i = 0; i != n; ++i)
+        col[i] = x[i];
+    }
+    return true;
+  }
+
+// Compute the eigenvalues of the symmetric matrix a in ascending order,
+// without the eigenvectors.
+template <typename M, typename T>
+  bool
+  symmetric_eigenvalues(const M& a, matrix<T, 1>& w)
+  {
+    static_assert(M::order == 2, "");
+    assert(a.extent(0) == a.extent(1));
+    const std::size_t n = a.extent(0);
+    w = matrix<T, 1>(n);
+    if (n == 0)
+      return true;
+
+    matrix<T, 2> v(n, n);
+    for (std::size_t i = 0; i != n; ++i)
+      for (std::size_t j = 0; j <= i; ++j)
+        v(i, j) = v(j, i) = a(i, j);
+
+    std::vector<T> e(n);
+    matrix_impl::tridiagonalize(n, cursor(v), w.data(), e.data());
+    if (!matrix_impl::tridiagonal_ql<T>(n, w.data(), e.data(), nullptr))
+      return false;
+    std::sort(w.begin(), w.end());
+    return true;
+  }
+
+
+// Singular value decomposition
+//
+// Compute the thin SVD of the m x n matrix a, so that a = u diag(s) v^T.
+// With k = min(m, n), u is m x k, s holds the k singular values in
+// descending order, and v is n x k. The columns of u and v are orthonormal,
+// except that the left singular vectors of zero singular values are 0.
+//
+// The SVD is computed by one-sided Jacobi rotations, which orthogonalize
+// the columns of a (or of its transpose, if m < n). The singular values
+// are computed to high relative accuracy. Returns false if the rotations
+// do not converge.
+template <typename M, typename T>
+  bool
+  svd(const M& a, matrix<T, 2>& u, matrix<T, 1>& s, matrix<T, 2>& v)
+  {
+    static_assert(M::order == 2, "");
+    const std::size_t m = a.extent(0);
+    const std::size_t n = a.extent(1);
+
+    // Store the columns of a as rows, so that they are contiguous. If a is
+    // wide, decompose a^T = v s u^T instead.
+    if (m >= n) {
+      matrix<T, 2> at(n, m);
+      for (std::size_t i = 0; i != m; ++i)
+        for (std::size_t j = 0; j != n; ++j)
+          at(j, i) = a(i, j);
+      return matrix_impl::jacobi_svd(m, n, at, u, s, v);
+    } else {
+      matrix<T, 2> at(m, n);
+      for (std::size_t i = 0; i != m; ++i)
+        for (std::size_t j = 0; j != n; ++j)
+          at(i, j) = a(i, j);
+      return matrix_impl::jacobi_svd(n, m, at, v, s, u);
+    }
+  }
+
+
+// Randomized SVD
+//
+// Compute an approximation of the k largest singular values and vectors of
+// the m x n matrix a, so that a ~ u diag(s) v^T, where u is m x k, s has k
+// elements in descending order, and v is n x k.
+//
+// The range of a is sampled by multiplying it by a random n x (k + p)
+// matrix, where p is the oversampling, and refined by the given number of
+// power iterations, which improve the accuracy when the singular values
+// decay slowly. The SVD of a is then approximated by the SVD of its small
+// projection onto that range. The work is dominated by matrix products
+// with a, so this is much faster than svd() for large matrices when k is
+// small. The seed determines the random matrix.
+//
+// Returns false if the SVD of the projection does not converge.
+template <typename M, typename T>
+  bool
+  randomized_svd(const M& a, std::size_t k,
+                 matrix<T, 2>& u, matrix<T, 1>& s, matrix<T, 2>& v,
+                 std::size_t oversample = 10, std::size_t iterations = 2,
+                 std::uint64_t seed = 0)
+  {
+    static_assert(M::order == 2, "");
+    const std::size_t m = a.extent(0);
+    const std::size_t n = a.extent(1);
+    k = std::min(k, std::min(m, n));
+    const std::size_t l = std::min(k + oversample, std::min(m, n));
+
+    // The sample of the range, y = a g, and its orthonormal basis q are
+    // stored transposed (l x m) so that the basis vectors are contiguous.
+    matrix<T, 2> gt(l, n);
+    fill_uniform(gt, seed, T(-1), T(1));
+    matrix<T, 2> qt(l, m);
+    matrix_product(gt, transpose(a), qt);
+    matrix_impl::orthonormalize_rows(l, m, qt.data());
+
+    // Power iterations: q = orth(a orth(a^T q)).
+    matrix<T, 2> zt(l, n);
+    for (std::size_t it = 0; it != iterations; ++it) {
+      zt = T(0);
+      matrix_product(qt, a, zt);
+      matrix_impl::orthonormalize_rows(l, n, zt.data());
+      qt = T(0);
+      matrix_product(zt, transpose(a), qt);
+      matrix_impl::orthonormalize_rows(l, m, qt.data());
+    }
+
+    // Project a onto the basis, b = q^T a, and decompose the projection.
+    matrix<T, 2> b(l, n);
+    matrix_product(qt, a, b);
+    matrix<T, 2> ub, vb;
+    matrix<T, 1> sb;
+    if (!svd(b, ub, sb, vb))
+      return false;
+
+    // u = q ub, truncated to k columns.
+    u = matrix<T, 2>(m, k);
+    matrix_product(transpose(qt), ub(slice(0, l), slice(0, k)), u);
+    s = matrix<T, 1>(k);
+    v = matrix<T, 2>(n, k);
+    auto vc = cursor(v);
+    auto vbc = cursor(vb);
+    for (std::size_t i = 0; i != n; ++i, vc.move(0), vbc.move(0))
+      std::copy_n(vbc.get(), k, vc.get());
+    std::copy_n(sb.data(), k, s.data());
+    return true;
+  }
@@ -0,0 +1,577 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+
+// -------------------------------------------------------------------------- //
+// Static matrix                                                [matrix.static]
+//
+// A static matrix is a 2D matrix whose extents are part of its type. The
+// elements are stored inline, in row-major order, so a static matrix never
+// allocates and all offset computations reduce to constant multiplications.
+// This makes the class well suited for the small, fixed-size matrices that
+// are common in geometry (e.g., 3x3 rotations and 4x4 transforms).
+//
+// A static matrix models the Matrix concept. It can be compared with,
+// printed like, and converted to a matrix_ref<T, 2> so that it can be passed
+// to algorithms written for dynamically sized matrices.
+//
+// Template Parameters:
+//    T -- The element type stored by the matrix
+//    R -- The number of rows
+//    C -- The number of columns
+template <typename T, std::size_t R, std::size_t C>
+  class static_matrix
+  {
+    static_assert(0 < R && 0 < C, "static matrix extents must be non-zero");
+  public:
+    static constexpr std::size_t order = 2;
+
+    using value_type     = T;
+    using iterator       = T*;
+    using const_iterator = const T*;
+
+
+    // Default construction
+    //
+    // All elements are value initialized.
+    static_matrix() : elems{} { }
+
+
+    // Fill initialization
+    //
+    // Initialize each element of the matrix with the given value.
+    explicit static_matrix(const T& value);
+
+
+    // Value initialization
+    //
+    // Initialize the matrix from a nesting of initializer lists. The extents
+    // of the initializer must match those of the matrix.
+    static_matrix(matrix_initializer<T, 2> init);
+
+
+    // Matrix initialization
+    //
+    // Copy the elements of another 2D matrix, which must have the same
+    // extents as this matrix.
+    template <typename M, typename = Requires<Matrix<M>()>>
+      explicit static_matrix(const M& x);
+
+
+    // Properties
+
+    // Return a slice describing the layout of the matrix.
+    matrix_slice<2> descriptor() const { return {0, {R, C}, {C, 1}}; }
+
+    // Returns the extent of the matrix in the nth dimension.
+    static constexpr std::size_t extent(std::size_t n) { return n ? C : R; }
+
+    // Returns the number of rows in the matrix.
+    static constexpr std::size_t rows() { return R; }
+
+    // Returns the number of columns in the matrix.
+    static constexpr std::size_t cols() { return C; }
+
+    // Returns the total number of elements in the matrix.
+    static constexpr std::size_t size() { return R * C; }
+
+
+    // Subscripting
+    //
+    // Returns a reference to the element in the ith row and jth column.
+    T&       operator()(std::size_t i, std::size_t j)       { return elems[i * C + j]; }
+    const T& operator()(std::size_t i, std::size_t j) const { return elems[i * C + j]; }
+
+
+    // Row subscripting
+    //
+    // Returns a reference to the nth row of the matrix.
+    matrix_ref<T, 1>       operator[](std::size_t n)       { return row(n); }
+    matrix_ref<const T, 1> operator[](std::size_t n) const { return row(n); }
+
+    // Row
+    //
+    // Returns a matrix_ref referring to the nth row of the matrix.
+    matrix_ref<T, 1>       row(std::size_t n);
+    matrix_ref<const T, 1> row(std::size_t n) const;
+
+    // Column
+    //
+    // Returns a matrix_ref referring to the nth column of the matrix.
+    matrix_ref<T, 1>       col(std::size_t n);
+    matrix_ref<const T, 1> col(std::size_t n) const;
+
+
+    // Reference conversion
+    //
+    // A static matrix can be used wherever a matrix_ref is expected.
+    operator matrix_ref<T, 2>()             { return {descriptor(), elems}; }
+    operator matrix_ref<const T, 2>() const { return {descriptor(), elems}; }
+
+
+    // Data access
+    T*       data()       { return elems; }
+    const T* data() const { return elems; }
+
+
+    // Scalar arithmetic
+    static_matrix& operator+=(const T& x);
+    static_matrix& operator-=(const T& x);
+    static_matrix& operator*=(const T& x);
+    static_matrix& operator/=(const T& x);
+
+    // Matrix arithmetic
+    static_matrix& operator+=(const static_matrix& x);
+    static_matrix& operator-=(const static_matrix& x);
+
+
+    // Iterators
+    iterator begin() { return elems; }
+    iterator end()   { return elems + R * C; }
+
+    const_iterator begin() const { return elems; }
+    const_iterator end() const   { return elems + R * C; }
+
+  private:
+    T elems[R * C];
+  };
+
+
+template <typename T, std::size_t R, std::size_t C>
+  inline
+  static_matrix<T, R, C>::static_matrix(const T& value)
+  {
+    std::fill_n(elems, R * C, value);
+  }
+
+template <typename T, std::size_t R, std::size_t C>
+  inline
+  static_matrix<T, R, C>::static_matrix(matrix_initializer<T, 2> init)
+  {
+    assert(init.size() == R);
+    T* p = elems;
+    for (const auto& r : init) {
+      assert(r.size() == C);
+      p = std::copy(r.begin(), r.end(), p);
+    }
+  }
+
+template <typename T, std::size_t R, std::size_t C>
+  template <typename M, typename X>
+    inline
+    static_matrix<T, R, C>::static_matrix(const M& x)
+    {
+      static_assert(M::order == 2, "");
+      static_assert(Convertible<Value_type<M>, T>(), "");
+      assert(x.extent(0) == R && x.extent(1) == C);
+      // Copy by index: the iterators of a column-major matrix walk its
+      // columns.
+      using U = Value_type<M>;
+      matrix_impl::elementwise(descriptor(), elems, x.descriptor(), x.data(),
+                               [](T& t, const U& u) { t = u; });
+    }
+
+
+// Row
+
+template <typename T, std::size_t R, std::size_t C>
+  inline matrix_ref<T, 1>
+  static_matrix<T, R, C>::row(std::size_t n)
+  {
+    assert(n < R);
+    return {{n * C, {C}, {1}}, elems};
+  }
+
+template <typename T, std::size_t R, std::size_t C>
+  inline matrix_ref<const T, 1>
+  static_matrix<T, R, C>::row(std::size_t n) const
+  {
+    assert(n < R);
+    return {{n * C, {C}, {1}}, elems};
+  }
+
+// Column
+
+template <typename T, std::size_t R, std::size_t C>
+  inline matrix_ref<T, 1>
+  static_matrix<T, R, C>::col(std::size_t n)
+  {
+    assert(n < C);
+    return {{n, {R}, {C}}, elems};
+  }
+
+template <typename T, std::size_t R, std::size_t C>
+  inline matrix_ref<const T, 1>
+  static_matrix<T, R, C>::col(std::size_t n) const
+  {
+    assert(n < C);
+    return {{n, {R}, {C}}, elems};
+  }
+
+
+// Scalar addition
+template <typename T, std::size_t R, std::size_t C>
+  inline static_matrix<T, R, C>&
+  static_matrix<T, R, C>::operator+=(const T& x)
+  {
+    matrix_impl::unroll<0, R * C>::apply([&](std::size_t i) { elems[i] += x; });
+    return *this;
+  }
+
+// Scalar subtraction
+template <typename T, std::size_t R, std::size_t C>
+  inline static_matrix<T, R, C>&
+  static_matrix<T, R, C>::operator-=(const T& x)
+  {
+    matrix_impl::unroll<0, R * C>::apply([&](std::size_t i) { elems[i] -= x; });
+    return *this;
+  }
+
+// Scalar multiplication
+template <typename T, std::size_t R, std::size_t C>
+  inline static_matrix<T, R, C>&
+  static_matrix<T, R, C>::operator*=(const T& x)
+  {
+    matrix_impl::unroll<0, R * C>::apply([&](std::size_t i) { elems[i] *= x; });
+    return *this;
+  }
+
+// Scalar division
+template <typename T, std::size_t R, std::size_t C>
+  inline static_matrix<T, R, C>&
+  static_matrix<T, R, C>::operator/=(const T& x)
+  {
+    matrix_impl::unroll<0, R * C>::apply([&](std::size_t i) { elems[i] /= x; });
+    return *this;
+  }
+
+// Matrix addition
+template <typename T, std::size_t R, std::size_t C>
+  inline static_matrix<T, R, C>&
+  static_matrix<T, R, C>::operator+=(const static_matrix& x)
+  {
+    matrix_impl::unroll<0, R * C>::apply([&](std::size_t i) {
+      elems[i] += x.elems[i];
+    });
+    return *this;
+  }
+
+// Matrix subtraction
+template <typename T, std::size_t R, std::size_t C>
+  inline static_matrix<T, R, C>&
+  static_matrix<T, R, C>::operator-=(const static_matrix& x)
+  {
+    matrix_impl::unroll<0, R * C>::apply([&](std::size_t i) {
+      elems[i] -= x.elems[i];
+    });
+    return *this;
+  }
+
+
+// -------------------------------------------------------------------------- //
+//                          Static Matrix Operations
+//
+// The following operations are overloaded for static matrices so that they
+// preserve the static extents of their operands. The loops over elements are
+// fully unrolled.
+
+template <typename T, std::size_t R, std::size_t C>
+  inline static_matrix<T, R, C>
+  operator+(const static_matrix<T, R, C>& a, const static_matrix<T, R, C>& b)
+  {
+    static_matrix<T, R, C> result = a;
+    return result += b;
+  }
+
+template <typename T, std::size_t R, std::size_t C>
+  inline static_matrix<T, R, C>
+  operator-(const static_matrix<T, R, C>& a, const static_matrix<T, R, C>& b)
+  {
+    static_matrix<T, R, C> result = a;
+    return result -= b;
+  }
+
+template <typename T, std::size_t R, std::size_t C>
+  inline static_matrix<T, R, C>
+  operator*(const static_matrix<T, R, C>& x, const T& n)
+  {
+    static_matrix<T, R, C> result = x;
+    return result *= n;
+  }
+
+template <typename T, std::size_t R, std::size_t C>
+  inline static_matrix<T, R, C>
+  operator*(const T& n, const static_matrix<T, R, C>& x)
+  {
+    static_matrix<T, R, C> result = x;
+    return result *= n;
+  }
+
+template <typename T, std::size_t R, std::size_t C>
+  inline static_matrix<T, R, C>
+  operator/(const static_matrix<T, R, C>& x, const T& n)
+  {
+    static_matrix<T, R, C> result = x;
+    return result /= n;
+  }
+
+
+// Matrix multiplication
+//
+// Multiplying an M x K matrix by a K x N matrix yields an M x N matrix. Each
+// of the M * N dot products of length K is unrolled.
+template <typename T, std::size_t M, std::size_t K, std::size_t N>
+  inline static_matrix<T, M, N>
+  operator*(const static_matrix<T, M, K>& a, const static_matrix<T, K, N>& b)
+  {
+    static_matrix<T, M, N> result;
+    matrix_impl::unroll<0, M * N>::apply([&](std::size_t ij) {
+      const std::size_t i = ij / N;
+      const std::size_t j = ij % N;
+      T s {};
+      matrix_impl::unroll<0, K>::apply([&](std::size_t k) {
+        s += a(i, k) * b(k, j);
+      });
+      result(i, j) = s;
+    });
+    return result;
+  }
+
+
+// Returns the C x R matrix whose (i, j) element is the (j, i) element of
+// the R x C matrix m.
+template <typename T, std::size_t R, std::size_t C>
+  inline static_matrix<T, C, R>
+  transpose(const static_matrix<T, R, C>& m)
+  {
+    static_matrix<T, C, R> result;
+    matrix_impl::unroll<0, R * C>::apply([&](std::size_t ij) {
+      result(ij % C, ij / C) = m(ij / C, ij % C);
+    });
+    return result;
+  }
+
+
+// Returns the N x N identity matrix.
+template <typename T, std::size_t N>
+  inline static_matrix<T, N, N>
+  identity_matrix()
+  {
+    static_matrix<T, N, N> result;
+    matrix_impl::unroll<0, N>::apply([&](std::size_t i) { result(i, i) = T(1); });
+    return result;
+  }
+
+
+// -------------------------------------------------------------------------- //
+//                        Determinant and Inverse
+//
+// Closed-form determinants and inverses are provided for 1x1 through 4x4
+// matrices. Larger matrices are handled by Gaussian elimination with partial
+// pivoting on a local copy of the matrix.
+//
+// Inverting a singular matrix is undefined behavior.
+
+template <typename T>
+  inline T
+  determinant(const static_matrix<T, 1, 1>& m)
+  {
+    return m(0, 0);
+  }
+
+template <typename T>
+  inline T
+  determinant(const static_matrix<T, 2, 2>& m)
+  {
+    return m(0, 0) * m(1, 1) - m(0, 1) * m(1, 0);
+  }
+
+template <typename T>
+  inline T
+  determinant(const static_matrix<T, 3, 3>& m)
+  {
+    return m(0, 0) * (m(1, 1) * m(2, 2) - m(1, 2) * m(2, 1))
+         - m(0, 1) * (m(1, 0) * m(2, 2) - m(1, 2) * m(2, 0))
+         + m(0, 2) * (m(1, 0) * m(2, 1) - m(1, 1) * m(2, 0));
+  }
+
+// The 4x4 determinant is computed by the Laplace expansion of the upper and
+// lower pairs of rows into 2x2 minors.
+template <typename T>
+  inline T
+  determinant(const static_matrix<T, 4, 4>& m)
+  {
+    T s0 = m(0, 0) * m(1, 1) - m(1, 0) * m(0, 1);
+    T s1 = m(0, 0) * m(1, 2) - m(1, 0) * m(0, 2);
+    T s2 = m(0, 0) * m(1, 3) - m(1, 0) * m(0, 3);
+    T s3 = m(0, 1) * m(1, 2) - m(1, 1) * m(0, 2);
+    T s4 = m(0, 1) * m(1, 3) - m(1, 1) * m(0, 3);
+    T s5 = m(0, 2) * m(1, 3) - m(1, 2) * m(0, 3);
+
+    T c5 = m(2, 2) * m(3, 3) - m(3, 2) * m(2, 3);
+    T c4 = m(2, 1) * m(3, 3) - m(3, 1) * m(2, 3);
+    T c3 = m(2, 1) * m(3, 2) - m(3, 1) * m(2, 2);
+    T c2 = m(2, 0) * m(3, 3) - m(3, 0) * m(2, 3);
+    T c1 = m(2, 0) * m(3, 2) - m(3, 0) * m(2, 2);
+    T c0 = m(2, 0) * m(3, 1) - m(3, 0) * m(2, 1);
+
+    return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+  }
+
+namespace matrix_impl
+{
+  // Reduce the N x N matrix a to upper triangular form using partial
+  // pivoting, applying the same row operations to b. Returns the
+  // determinant of a.
+  template <typename T, std::size_t N, std::size_t M>
+    T
+    static_eliminate(static_matrix<T, N, N>& a, static_matrix<T, N, M>& b)
+    {
+      T det = T(1);
+      for (std::size_t j = 0; j < N; ++j) {
+        std::size_t p = j;
+        for (std::size_t i = j + 1; i < N; ++i)
+          if (std::abs(a(i, j)) > std::abs(a(p, j)))
+            p = i;
+        if (p != j) {
+          std::swap_ranges(&a(j, 0), &a(j, 0) + N, &a(p, 0));
+          std::swap_ranges(&b(j, 0), &b(j, 0) + M, &b(p, 0));
+          det = -det;
+        }
+        det *= a(j, j);
+        if (a(j, j) == T(0))
+          return det;
+        for (std::size_t i = j + 1; i < N; ++i) {
+          T f = a(i, j) / a(j, j);
+          for (std::size_t k = j; k < N; ++k)
+            a(i, k) -= f * a(j, k);
+          for (std::size_t k = 0; k < M; ++k)
+            b(i, k) -= f * b(j, k);
+        }
+      }
+      return det;
+    }
+
+} // namespace matrix_impl
+
+template <typename T, std::size_t N>
+  inline T
+  determinant(const static_matrix<T, N, N>& m)
+  {
+    static_matrix<T, N, N> a = m;
+    static_matrix<T, N, 1> b;
+    return matrix_impl::static_eliminate(a, b);
+  }
+
+
+template <typename T>
+  inline static_matrix<T, 1, 1>
+  inverse(const static_matrix<T, 1, 1>& m)
+  {
+    assert(m(0, 0) != T(0));
+    return static_matrix<T, 1, 1>(T(1) / m(0, 0));
+  }
+
+template <typename T>
+  inline static_matrix<T, 2, 2>
+  inverse(const static_matrix<T, 2, 2>& m)
+  {
+    T det = determinant(m);
+    assert(det != T(0));
+    static_matrix<T, 2, 2> r {
+      { m(1, 1), -m(0, 1)},
+      {-m(1, 0),  m(0, 0)}
+    };
+    return r /= det;
+  }
+
+template <typename T>
+  inline static_matrix<T, 3, 3>
+  inverse(const static_matrix<T, 3, 3>& m)
+  {
+    static_matrix<T, 3, 3> r {
+      {m(1, 1) * m(2, 2) - m(1, 2) * m(2, 1),
+       m(0, 2) * m(2, 1) - m(0, 1) * m(2, 2),
+       m(0, 1) * m(1, 2) - m(0, 2) * m(1, 1)},
+      {m(1, 2) * m(2, 0) - m(1, 0) * m(2, 2),
+       m(0, 0) * m(2, 2) - m(0, 2) * m(2, 0),
+       m(0, 2) * m(1, 0) - m(0, 0) * m(1, 2)},
+      {m(1, 0) * m(2, 1) - m(1, 1) * m(2, 0),
+       m(0, 1) * m(2, 0) - m(0, 0) * m(2, 1),
+       m(0, 0) * m(1, 1) - m(0, 1) * m(1, 0)}
+    };
+    T det = m(0, 0) * r(0, 0) + m(0, 1) * r(1, 0) + m(0, 2) * r(2, 0);
+    assert(det != T(0));
+    return r /= det;
+  }
+
+// The 4x4 inverse is the adjugate divided by the determinant. The cofactors
+// are built from the same 2x2 minors used by the determinant.
+template <typename T>
+  inline static_matrix<T, 4, 4>
+  inverse(const static_matrix<T, 4, 4>& m)
+  {
+    T s0 = m(0, 0) * m(1, 1) - m(1, 0) * m(0, 1);
+    T s1 = m(0, 0) * m(1, 2) - m(1, 0) * m(0, 2);
+    T s2 = m(0, 0) * m(1, 3) - m(1, 0) * m(0, 3);
+    T s3 = m(0, 1) * m(1, 2) - m(1, 1) * m(0, 2);
+    T s4 = m(0, 1) * m(1, 3) - m(1, 1) * m(0, 3);
+    T s5 = m(0, 2) * m(1, 3) - m(1, 2) * m(0, 3);
+
+    T c5 = m(2, 2) * m(3, 3) - m(3, 2) * m(2, 3);
+    T c4 = m(2, 1) * m(3, 3) - m(3, 1) * m(2, 3);
+    T c3 = m(2, 1) * m(3, 2) - m(3, 1) * m(2, 2);
+    T c2 = m(2, 0) * m(3, 3) - m(3, 0) * m(2, 3);
+    T c1 = m(2, 0) * m(3, 2) - m(3, 0) * m(2, 2);
+    T c0 = m(2, 0) * m(3, 1) - m(3, 0) * m(2, 1);
+
+    T det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+    assert(det != T(0));
+
+    static_matrix<T, 4, 4> r {
+      { m(1, 1) * c5 - m(1, 2) * c4 + m(1, 3) * c3,
+       -m(0, 1) * c5 + m(0, 2) * c4 - m(0, 3) * c3,
+        m(3, 1) * s5 - m(3, 2) * s4 + m(3, 3) * s3,
+       -m(2, 1) * s5 + m(2, 2) * s4 - m(2, 3) * s3},
+      {-m(1, 0) * c5 + m(1, 2) * c2 - m(1, 3) * c1,
+        m(0, 0) * c5 - m(0, 2) * c2 + m(0, 3) * c1,
+       -m(3, 0) * s5 + m(3, 2) * s2 - m(3, 3) * s1,
+        m(2, 0) * s5 - m(2, 2) * s2 + m(2, 3) * s1},
+      { m(1, 0) * c4 - m(1, 1) * c2 + m(1, 3) * c0,
+       -m(0, 0) * c4 + m(0, 1) * c2 - m(0, 3) * c0,
+        m(3, 0) * s4 - m(3, 1) * s2 + m(3, 3) * s0,
+       -m(2, 0) * s4 + m(2, 1) * s2 - m(2, 3) * s0},
+      {-m(1, 0) * c3 + m(1, 1) * c1 - m(1, 2) * c0,
+        m(0, 0) * c3 - m(0, 1) * c1 + m(0, 2) * c0,
+       -m(3, 0) * s3 + m(3, 1) * s1 - m(3, 2) * s0,
+        m(2, 0) * s3 - m(2, 1) * s1 + m(2, 2) * s0}
+    };
+    return r /= det;
+  }
+
+// The general inverse solves A X = I by elimination and back substitution.
+template <typename T, std::size_t N>
+  static_matrix<T, N, N>
+  inverse(const static_matrix<T, N, N>& m)
+  {
+    static_matrix<T, N, N> a = m;
+    static_matrix<T, N, N> x = identity_matrix<T, N>();
+    T det = matrix_impl::static_eliminate(a, x);
+    assert(det != T(0));
+    for (std::size_t i = N; i-- != 0; ) {
+      for (std::size_t k = i + 1; k < N; ++k)
+        for (std::size_t j = 0; j < N; ++j)
+          x(i, j) -= a(i, k) * x(k, j);
+      for (std::size_t j = 0; j < N; ++j)
+        x(i, j) /= a(i, i);
+    }
+    return x;
+  }
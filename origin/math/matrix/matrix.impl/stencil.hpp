@@ -0,0 +1,492 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+
+// -------------------------------------------------------------------------- //
+// Stencils                                                    [matrix.stencil]
+//
+// A stencil computes each element of its result as a weighted sum of the
+// neighboring elements of an N-dimensional matrix. The neighborhood is a
+// cube of width 2R + 1 centered on the element, where the radius R is a
+// compile-time constant. For example, the 2D Laplacian is the stencil
+//
+//    {0,  1, 0,
+//     1, -4, 1,
+//     0,  1, 0}
+//
+// with radius 1. Neighbors outside the matrix are given by a boundary
+// policy.
+//
+// A stencil is applied to a padded copy of its argument, whose halo of
+// width R holds the boundary values. The result is computed in parallel
+// over the leading dimension, in tiles along the last (contiguous)
+// dimension so that the rows of the neighborhood of a tile remain in
+// cache. Within a tile, each stencil point contributes a simple loop that
+// the compiler can vectorize.
+
+
+// The boundary policies of a stencil. Neighbors outside the matrix are:
+//
+//    zero      0
+//    clamp     the nearest element of the matrix
+//    wrap      the elements of the matrix repeated periodically
+//    reflect   the elements of the matrix mirrored about its edges, including
+//              the edge element (i.e., d c b a | a b c d | d c b a)
+enum class stencil_boundary { zero, clamp, wrap, reflect };
+
+
+namespace matrix_impl
+{
+  constexpr std::size_t
+  stencil_size(std::size_t w, std::size_t n)
+  {
+    return n == 0 ? 1 : w * stencil_size(w, n - 1);
+  }
+
+  // Returns the index of the element that is the ith of a dimension of n
+  // elements under the boundary policy b, or n if that element is 0.
+  inline std::size_t
+  boundary_index(std::ptrdiff_t i, std::size_t n, stencil_boundary b)
+  {
+    const std::ptrdiff_t m = n;
+    if (0 <= i && i < m)
+      return i;
+    switch (b) {
+    case stencil_boundary::zero:
+      return n;
+    case stencil_boundary::clamp:
+      return i < 0 ? 0 : n - 1;
+    case stencil_boundary::wrap:
+      return ((i % m) + m) % m;
+    case stencil_boundary::reflect:
+      i = ((i % (2 * m)) + 2 * m) % (2 * m);
+      return i < m ? i : 2 * m - 1 - i;
+    }
+    return n;
+  }
+} // namespace matrix_impl
+
+
+// Stencil
+//
+// A stencil of radius R over N-dimensional matrices of T. The weights are
+// indexed by offsets in [-R, R] from the center:
+//
+//    stencil<float, 2, 1> s;   // All weights are 0
+//    s(0, 0) = -4;
+//    s(-1, 0) = s(1, 0) = s(0, -1) = s(0, 1) = 1;
+//
+// The weights can also be initialized in row-major order.
+template <typename T, std::size_t N, std::size_t R>
+  class stencil
+  {
+  public:
+    static constexpr std::size_t radius = R;
+    static constexpr std::size_t width = 2 * R + 1;
+    static constexpr std::size_t size = matrix_impl::stencil_size(width, N);
+
+    stencil()
+      : weights()
+    { }
+
+    stencil(std::initializer_list<T> list)
+      : weights()
+    {
+      assert(list.size() == size);
+      std::copy(list.begin(), list.end(), weights.begin());
+    }
+
+    // Element access
+    template <typename... Offsets>
+      T& operator()(Offsets... offs)
+      {
+        return weights[index(offs...)];
+      }
+
+    template <typename... Offsets>
+      const T& operator()(Offsets... offs) const
+      {
+        return weights[index(offs...)];
+      }
+
+    // Returns the stencil reflected through its center. Applying the
+    // reflected stencil computes the convolution with this stencil.
+    stencil reflected() const
+    {
+      stencil s;
+      std::reverse_copy(weights.begin(), weights.end(), s.weights.begin());
+      return s;
+    }
+
+    T* data() { return weights.data(); }
+    const T* data() const { return weights.data(); }
+
+  private:
+    template <typename... Offsets>
+      static std::size_t index(Offsets... offs)
+      {
+        static_assert(sizeof...(Offsets) == N, "");
+        const std::ptrdiff_t o[] {std::ptrdiff_t(offs)...};
+        std::size_t k = 0;
+        for (std::size_t d = 0; d != N; ++d) {
+          assert(-std::ptrdiff_t(R) <= o[d] && o[d] <= std::ptrdiff_t(R));
+          k = k * width + std::size_t(o[d] + std::ptrdiff_t(R));
+        }
+        return k;
+      }
+
+    std::array<T, size> weights;
+  };
+
+template <typename T, std::size_t N, std::size_t R>
+  constexpr std::size_t stencil<T, N, R>::size;
+
+
+// Returns the discrete Laplacian in N dimensions, whose weight is -2N at
+// the center and 1 at the nearest neighbors along each axis.
+template <typename T, std::size_t N>
+  stencil<T, N, 1>
+  laplacian_stencil()
+  {
+    stencil<T, N, 1> s;
+    T* w = s.data();
+    std::size_t center = (stencil<T, N, 1>::size - 1) / 2;
+    w[center] = T(-2 * int(N));
+    for (std::size_t d = 0, step = 1; d != N; ++d, step *= 3) {
+      w[center - step] = T(1);
+      w[center + step] = T(1);
+    }
+    return s;
+  }
+
+// Returns the stencil of radius R that averages the (2R + 1)^N elements of
+// its neighborhood.
+template <typename T, std::size_t N, std::size_t R>
+  stencil<T, N, R>
+  box_stencil()
+  {
+    stencil<T, N, R> s;
+    using S = stencil<T, N, R>;
+    std::fill(s.data(), s.data() + S::size, T(1) / T(S::size));
+    return s;
+  }
+
+
+namespace matrix_impl
+{
+  // The geometry of the application of a stencil of radius r to a matrix
+  // with the given extents. The argument is copied into a contiguous padded
+  // matrix, whose extents are 2r greater, and the nonzero weights of the
+  // stencil are stored with the offsets of their elements in the padded
+  // matrix.
+  template <typename T, std::size_t N>
+    class stencil_sweep
+    {
+    public:
+      stencil_sweep(const T* w, std::size_t r, const std::size_t* ext)
+        : r(r)
+      {
+        for (std::size_t d = 0; d != N; ++d) {
+          extents[d] = ext[d];
+          padded[d] = ext[d] + 2 * r;
+        }
+        strides[N - 1] = 1;
+        for (std::size_t d = N - 1; d != 0; --d)
+          strides[d - 1] = strides[d] * padded[d];
+
+        // Enumerate the offsets of the stencil cube in row-major order.
+        const std::size_t width = 2 * r + 1;
+        const std::size_t n = stencil_size(width, N);
+        for (std::size_t k = 0; k != n; ++k) {
+          if (w[k] == T(0))
+            continue;
+          std::ptrdiff_t off = 0;
+          for (std::size_t d = N, q = k; d-- != 0; q /= width)
+            off += (std::ptrdiff_t(q % width) - std::ptrdiff_t(r)) * std::ptrdiff_t(strides[d]);
+          points.push_back({off, w[k]});
+        }
+      }
+
+      std::size_t padded_size() const { return strides[0] * padded[0]; }
+
+      // Returns the number of rows (elements of the leading dimension) to
+      // assign to each thread.
+      std::size_t grain() const
+      {
+        std::size_t work = points.size() + 1;
+        for (std::size_t d = 1; d != N; ++d)
+          work *= extents[d];
+        return std::max(std::size_t(1 << 15) / std::max(work, std::size_t(1)),
+                        std::size_t(1));
+      }
+
+      // Copy the elements of x, described by s, into the padded matrix p,
+      // filling the halo according to the boundary policy b. If lo (or hi)
+      // is true, the low (high) edge of the leading dimension is not a
+      // boundary of the problem, and the halo there is filled arbitrarily.
+      template <typename U>
+        void
+        pad(const matrix_slice<N>& s, const U* x, stencil_boundary b,
+            bool lo, bool hi, T* p) const
+        {
+          auto policy = [&](std::size_t d, std::ptrdiff_t i) {
+            if (d == 0 && ((i < 0 && lo) || (i >= std::ptrdiff_t(extents[0]) && hi)))
+              return stencil_boundary::clamp;
+            return b;
+          };
+
+          const std::size_t w = padded[N - 1];
+          const std::size_t n = extents[N - 1];
+          const std::size_t last = s.strides[N - 1];
+          std::size_t rows = 1;
+          for (std::size_t d = 0; d + 1 < N; ++d)
+            rows *= padded[d];
+
+          for (std::size_t q = 0; q != rows; ++q) {
+            T* out = p + q * w;
+
+            // Find the source of the row, if it is not 0.
+            std::size_t off = s.start;
+            bool zero = false;
+            for (std::size_t d = N - 1, k = q; d-- != 0; k /= padded[d]) {
+              const std::ptrdiff_t i = std::ptrdiff_t(k % padded[d]) - std::ptrdiff_t(r);
+              const std::size_t j = boundary_index(i, extents[d], policy(d, i));
+              zero |= j == extents[d];
+              off += j * s.strides[d];
+            }
+            if (zero) {
+              std::fill(out, out + w, T(0));
+              continue;
+            }
+
+            const U* src = x + off;
+            for (std::size_t j = 0; j != r; ++j) {
+              const std::ptrdiff_t i = std::ptrdiff_t(j) - std::ptrdiff_t(r);
+              const std::size_t k = boundary_index(i, n, policy(N - 1, i));
+              out[j] = k == n ? T(0) : T(src[k * last]);
+            }
+            for (std::size_t j = 0; j != n; ++j)
+              out[r + j] = T(src[j * last]);
+            for (std::size_t j = 0; j != r; ++j) {
+              const std::ptrdiff_t i = std::ptrdiff_t(n + j);
+              const std::size_t k = boundary_index(i, n, policy(N - 1, i));
+              out[r + n + j] = k == n ? T(0) : T(src[k * last]);
+            }
+          }
+        }
+
+      // Compute the elements of the result y, described by s, whose leading
+      // index is in [first, last), from the padded matrix p.
+      template <typename U>
+        void
+        apply(const T* p, const matrix_slice<N>& s, U* y,
+              std::size_t first, std::size_t last) const
+        {
+          constexpr std::size_t tile = 256;
+          T acc[tile];
+
+          // The range of rows and of the elements within each row. When N
+          // is 1, the leading dimension is the row.
+          std::size_t per = 1;
+          for (std::size_t d = 1; d + 1 < N; ++d)
+            per *= extents[d];
+          std::size_t j0 = 0;
+          std::size_t j1 = extents[N - 1];
+          std::size_t q0 = 0;
+          std::size_t q1 = 1;
+          if (N == 1) {
+            j0 = first;
+            j1 = last;
+          } else {
+            q0 = first * per;
+            q1 = last * per;
+          }
+
+          const std::size_t ys = s.strides[N - 1];
+          for (std::size_t jt = j0; jt < j1; jt += tile) {
+            const std::size_t n = std::min(tile, j1 - jt);
+            for (std::size_t q = q0; q != q1; ++q) {
+              std::size_t in = r + jt;
+              std::size_t out = s.start + jt * ys;
+              for (std::size_t d = N - 1, k = q; d-- != 0; k /= extents[d]) {
+                in += (k % extents[d] + r) * strides[d];
+                out += (k % extents[d]) * s.strides[d];
+              }
+
+              std::fill(acc, acc + n, T(0));
+              for (const auto& pt : points) {
+                const T* src = p + in + pt.first;
+                const T wt = pt.second;
+                for (std::size_t j = 0; j != n; ++j)
+                  acc[j] += wt * src[j];
+              }
+              U* dst = y + out;
+              for (std::size_t j = 0; j != n; ++j)
+                dst[j * ys] = acc[j];
+            }
+          }
+        }
+
+      std::size_t r;
+      std::size_t extents[N];
+      std::size_t padded[N];
+      std::size_t strides[N];
+      std::vector<std::pair<std::ptrdiff_t, T>> points;
+    };
+
+  // Returns the number of rows in a band of the leading dimension for
+  // temporal blocking, so that the band and its halo of h rows on each side
+  // fit in cache.
+  inline std::size_t
+  stencil_band(std::size_t row_bytes, std::size_t h)
+  {
+    constexpr std::size_t cache = 1 << 18;
+    const std::size_t rows = cache / std::max(row_bytes, std::size_t(1));
+    return std::max(rows > 4 * h ? rows - 2 * h : 2 * h, std::size_t(1));
+  }
+
+  // Returns the slice describing the first element of the leading
+  // dimension of s, e.g., the first row of a 2D slice.
+  template <std::size_t N>
+    inline matrix_slice<N>
+    leading_row(const matrix_slice<N>& s)
+    {
+      matrix_slice<N> r = s;
+      r.size = s.size / s.extents[0];
+      r.extents[0] = 1;
+      return r;
+    }
+
+} // namespace matrix_impl
+
+
+// Apply stencil
+//
+// Assign to each element of out the weighted sum of the neighborhood of the
+// corresponding element of x given by the stencil s, with neighbors outside
+// x given by the boundary policy b. The matrices x and out must have the
+// same extents, and may be the same matrix.
+template <typename T, std::size_t N, std::size_t R, typename M1, typename M2>
+  void
+  apply_stencil(const stencil<T, N, R>& s, const M1& x, M2& out,
+                stencil_boundary b = stencil_boundary::zero)
+  {
+    static_assert(M1::order == N, "");
+    static_assert(M2::order == N, "");
+    assert(same_extents(x, out));
+    if (x.size() == 0)
+      return;
+
+    const matrix_impl::stencil_sweep<T, N> sweep(s.data(), R, x.descriptor().extents);
+    std::vector<T> p(sweep.padded_size());
+    sweep.pad(x.descriptor(), x.data(), b, false, false, p.data());
+    matrix_impl::parallel_for(x.extent(0), sweep.grain(),
+      [&](std::size_t first, std::size_t last) {
+        sweep.apply(p.data(), out.descriptor(), out.data(), first, last);
+      });
+  }
+
+// Convolve
+//
+// Assign to out the convolution of x with the stencil s, i.e., apply the
+// reflected stencil.
+template <typename T, std::size_t N, std::size_t R, typename M1, typename M2>
+  inline void
+  convolve(const stencil<T, N, R>& s, const M1& x, M2& out,
+           stencil_boundary b = stencil_boundary::zero)
+  {
+    apply_stencil(s.reflected(), x, out, b);
+  }
+
+
+// Iterate stencil
+//
+// Apply the stencil s to m the given number of times, in place.
+//
+// If the time block is greater than 1, that many applications are computed
+// at a time on bands of the leading dimension that fit in cache (temporal
+// blocking). Each band is extended by a halo of R rows per application,
+// whose elements are recomputed redundantly, so that the bands can be
+// processed independently and in parallel. This reduces the memory traffic
+// of iterated stencils whose matrices do not fit in cache.
+template <typename T, std::size_t N, std::size_t R>
+  void
+  iterate_stencil(const stencil<T, N, R>& s, matrix<T, N>& m, std::size_t steps,
+                  stencil_boundary b = stencil_boundary::zero,
+                  std::size_t time_block = 1)
+  {
+    if (m.size() == 0)
+      return;
+    if (time_block <= 1) {
+      for (std::size_t k = 0; k != steps; ++k)
+        apply_stencil(s, m, m, b);
+      return;
+    }
+
+    const matrix_slice<N>& desc = m.descriptor();
+    const std::size_t n = desc.extents[0];
+    for (std::size_t done = 0; done < steps; done += time_block) {
+      const std::size_t t = std::min(time_block, steps - done);
+      const std::size_t h = t * R;
+      const std::size_t band = matrix_impl::stencil_band(desc.size / n * sizeof(T), h);
+      const std::size_t bands = (n + band - 1) / band;
+
+      matrix<T, N> next = m;
+      matrix_impl::parallel_for(bands, 1, [&](std::size_t first, std::size_t last) {
+        for (std::size_t k = first; k != last; ++k) {
+          // The band [r0, r1) and its halo, which is wrapped for periodic
+          // boundaries and clipped to the matrix otherwise.
+          const std::size_t r0 = k * band;
+          const std::size_t r1 = std::min(r0 + band, n);
+          std::ptrdiff_t lo = std::ptrdiff_t(r0) - std::ptrdiff_t(h);
+          std::ptrdiff_t hi = std::ptrdiff_t(r1 + h);
+          if (b != stencil_boundary::wrap) {
+            lo = std::max(lo, std::ptrdiff_t(0));
+            hi = std::min(hi, std::ptrdiff_t(n));
+          }
+          const bool cut_lo = b == stencil_boundary::wrap || lo > 0;
+          const bool cut_hi = b == stencil_boundary::wrap || hi < std::ptrdiff_t(n);
+
+          // Copy the rows of the band into a contiguous slab.
+          std::array<std::size_t, N> ext;
+          std::copy(desc.extents, desc.extents + N, ext.begin());
+          ext[0] = hi - lo;
+          const matrix_slice<N> slab(0, ext);
+          matrix_slice<N> row = matrix_impl::leading_row(desc);
+          matrix_slice<N> srow = matrix_impl::leading_row(slab);
+          std::vector<T> cur(slab.size);
+          for (std::ptrdiff_t i = lo; i != hi; ++i) {
+            row.start = desc.start + matrix_impl::boundary_index(i, n, b) * desc.strides[0];
+            srow.start = (i - lo) * slab.strides[0];
+            matrix_impl::elementwise(srow, cur.data(), row, m.data(),
+                                     [](T& x, const T& y) { x = y; });
+          }
+
+          // Apply the stencil t times to the slab.
+          const matrix_impl::stencil_sweep<T, N> sweep(s.data(), R, slab.extents);
+          std::vector<T> p(sweep.padded_size());
+          for (std::size_t step = 0; step != t; ++step) {
+            sweep.pad(slab, cur.data(), b, cut_lo, cut_hi, p.data());
+            sweep.apply(p.data(), slab, cur.data(), 0, slab.extents[0]);
+          }
+
+          // Copy the band out of the slab.
+          for (std::size_t i = r0; i != r1; ++i) {
+            row.start = desc.start + i * desc.strides[0];
+            srow.start = (i - lo) * slab.strides[0];
+            matrix_impl::elementwise(row, next.data(), srow, cur.data(),
+                                     [](T& x, const T& y) { x = y; });
+          }
+        }
+      });
+      m = std::move(next);
+    }
+  }
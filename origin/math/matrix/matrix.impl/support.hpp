@@ -96,6 +96,28 @@ namespace matrix_impl
     }
 
 
+  // The unroll template calls f(I), f(I + 1), ..., f(N - 1). Because the
+  // bounds are constants, the recursion is flattened by the compiler into
+  // a straight-line sequence of calls; there is no loop counter.
+  template <std::size_t I, std::size_t N>
+    struct unroll
+    {
+      template <typename F>
+        static void apply(F f)
+        {
+          f(I);
+          unroll<I + 1, N>::apply(f);
+        }
+    };
+
+  template <std::size_t N>
+    struct unroll<N, N>
+    {
+      template <typename F>
+        static void apply(F) { }
+    };
+
+
   // ------------------------------------------------------------------------ //
   //                          Derive Extents
 
@@ -0,0 +1,145 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+
+// -------------------------------------------------------------------------- //
+// Matrix views                                                   [matrix.view]
+//
+// A view is a matrix_ref whose descriptor has been rewritten by one of the
+// slice transformations. Views refer to the elements of the original matrix;
+// creating a view never copies or moves elements. Modifying the elements of
+// a view modifies the viewed matrix.
+//
+// Each view is provided for matrices, constant matrices, and matrix
+// references. Note that a matrix_ref is taken by value since it already has
+// reference semantics.
+//
+//    transpose(m)        -- exchange rows and columns of a 2D matrix
+//    permute(m, axes)    -- reorder the dimensions of an N-D matrix
+//    diagonal(m)         -- the main diagonal of a 2D matrix
+//    strided(m, steps)   -- every kth element in each dimension
+//    broadcast(m, exts)  -- repeat elements to fill larger extents
+
+
+// Transpose
+
+template <typename T, typename A>
+  inline matrix_ref<T, 2>
+  transpose(matrix<T, 2, A>& m)
+  {
+    return {transpose(m.descriptor()), m.data()};
+  }
+
+template <typename T, typename A>
+  inline matrix_ref<const T, 2>
+  transpose(const matrix<T, 2, A>& m)
+  {
+    return {transpose(m.descriptor()), m.data()};
+  }
+
+template <typename T>
+  inline matrix_ref<T, 2>
+  transpose(matrix_ref<T, 2> m)
+  {
+    return {transpose(m.descriptor()), m.data()};
+  }
+
+
+// Permute
+
+template <typename T, std::size_t N, typename A>
+  inline matrix_ref<T, N>
+  permute(matrix<T, N, A>& m, const std::array<std::size_t, N>& axes)
+  {
+    return {permute(m.descriptor(), axes), m.data()};
+  }
+
+template <typename T, std::size_t N, typename A>
+  inline matrix_ref<const T, N>
+  permute(const matrix<T, N, A>& m, const std::array<std::size_t, N>& axes)
+  {
+    return {permute(m.descriptor(), axes), m.data()};
+  }
+
+template <typename T, std::size_t N>
+  inline matrix_ref<T, N>
+  permute(matrix_ref<T, N> m, const std::array<std::size_t, N>& axes)
+  {
+    return {permute(m.descriptor(), axes), m.data()};
+  }
+
+
+// Diagonal
+
+template <typename T, typename A>
+  inline matrix_ref<T, 1>
+  diagonal(matrix<T, 2, A>& m)
+  {
+    return {diagonal(m.descriptor()), m.data()};
+  }
+
+template <typename T, typename A>
+  inline matrix_ref<const T, 1>
+  diagonal(const matrix<T, 2, A>& m)
+  {
+    return {diagonal(m.descriptor()), m.data()};
+  }
+
+template <typename T>
+  inline matrix_ref<T, 1>
+  diagonal(matrix_ref<T, 2> m)
+  {
+    return {diagonal(m.descriptor()), m.data()};
+  }
+
+
+// Strided
+
+template <typename T, std::size_t N, typename A>
+  inline matrix_ref<T, N>
+  strided(matrix<T, N, A>& m, const std::array<std::size_t, N>& steps)
+  {
+    return {strided(m.descriptor(), steps), m.data()};
+  }
+
+template <typename T, std::size_t N, typename A>
+  inline matrix_ref<const T, N>
+  strided(const matrix<T, N, A>& m, const std::array<std::size_t, N>& steps)
+  {
+    return {strided(m.descriptor(), steps), m.data()};
+  }
+
+template <typename T, std::size_t N>
+  inline matrix_ref<T, N>
+  strided(matrix_ref<T, N> m, const std::array<std::size_t, N>& steps)
+  {
+    return {strided(m.descriptor(), steps), m.data()};
+  }
+
+
+// Broadcast
+//
+// A broadcast view repeats elements, so distinct positions in the view may
+// refer to the same element. Broadcast views are therefore always constant.
+
+template <typename T, std::size_t N, std::size_t M, typename A>
+  inline matrix_ref<const T, N>
+  broadcast(const matrix<T, M, A>& m, const std::array<std::size_t, N>& exts)
+  {
+    return {broadcast(m.descriptor(), exts), m.data()};
+  }
+
+template <typename T, std::size_t N, std::size_t M>
+  inline matrix_ref<const T, N>
+  broadcast(matrix_ref<T, M> m, const std::array<std::size_t, N>& exts)
+  {
+    return {broadcast(m.descriptor(), exts), m.data()};
+  }
@@ -0,0 +1,78 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <origin/math/matrix/matrix.hpp>
+
+#include "harness.hpp"
+
+using namespace std;
+using namespace origin;
+
+// Compares the cost of accessing the elements of a matrix by indexing, by
+// a cursor, and by a raw pointer, in a naive matrix product (i-k-j order).
+// For each size, reports the time per inner iteration in nanoseconds.
+
+void indexed(const matrix<double, 2>& a, const matrix<double, 2>& b, matrix<double, 2>& c)
+{
+  const size_t n = a.rows();
+  for (size_t i = 0; i < n; ++i)
+    for (size_t k = 0; k < n; ++k) {
+      const double x = a(i, k);
+      for (size_t j = 0; j < n; ++j)
+        c(i, j) += x * b(k, j);
+    }
+}
+
+void cursors(const matrix<double, 2>& a, const matrix<double, 2>& b, matrix<double, 2>& c)
+{
+  const size_t n = a.rows();
+  auto ai = cursor(a);
+  auto ci = cursor(c);
+  for (size_t i = 0; i < n; ++i, ai.move(0), ci.move(0)) {
+    auto bk = cursor(b);
+    auto crow = ci.line(1);
+    for (size_t k = 0; k < n; ++k, bk.move(0)) {
+      const double x = ai[k];
+      auto brow = bk.line(1);
+      for (size_t j = 0; j < n; ++j)
+        crow[j] += x * brow[j];
+    }
+  }
+}
+
+void pointers(const matrix<double, 2>& a, const matrix<double, 2>& b, matrix<double, 2>& c)
+{
+  const size_t n = a.rows();
+  const double* pa = a.data();
+  const double* pb = b.data();
+  double* pc = c.data();
+  for (size_t i = 0; i < n; ++i)
+    for (size_t k = 0; k < n; ++k) {
+      const double x = pa[i * n + k];
+      for (size_t j = 0; j < n; ++j)
+        pc[i * n + j] += x * pb[k * n + j];
+    }
+}
+
+int main(int argc, char* argv[])
+{
+  const int repeat = repetitions(argc, argv);
+  csv_header();
+  for (size_t n = 32; n <= 512; n *= 2) {
+    matrix<double, 2> a(n, n), b(n, n), c(n, n);
+    fill_uniform(a, 1);
+    fill_uniform(b, 2);
+
+    const double iters = double(n) * n * n * 1e-9;
+    double t = seconds([&]() { indexed(a, b, c); }, repeat);
+    csv_row("access", "indexed", n, "ns", t / iters);
+    t = seconds([&]() { cursors(a, b, c); }, repeat);
+    csv_row("access", "cursor", n, "ns", t / iters);
+    t = seconds([&]() { pointers(a, b, c); }, repeat);
+    csv_row("access", "pointer", n, "ns", t / iters);
+  }
+}
@@ -0,0 +1,65 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <origin/math/matrix/matrix.hpp>
+
+#include "harness.hpp"
+
+using namespace std;
+using namespace origin;
+
+// Measures the bandwidth of elementwise operations in GB/s (counting each
+// element read and written once) on an n x n matrix of doubles:
+//
+//    matrix     -- a += b on matrices
+//    ref        -- a += b on matrix_refs of the whole matrices
+//    submatrix  -- a += b on matrix_refs of the interior of larger matrices,
+//                  whose rows are not contiguous
+//    pointer    -- the same loop over raw pointers, for reference
+//
+// and likewise for scaling (a *= 2), which reads and writes one matrix.
+
+int main(int argc, char* argv[])
+{
+  const int repeat = repetitions(argc, argv);
+  csv_header();
+  for (size_t n = 128; n <= 4096; n *= 2) {
+    matrix<double, 2> a(n, n), b(n, n);
+    matrix<double, 2> x(n + 2, n + 2), y(n + 2, n + 2);
+    fill_uniform(a, 1);
+    fill_uniform(b, 2);
+    fill_uniform(x, 3);
+    fill_uniform(y, 4);
+    matrix_ref<double, 2> ar = a(slice(0, n), slice(0, n));
+    matrix_ref<double, 2> br = b(slice(0, n), slice(0, n));
+    matrix_ref<double, 2> xs = x(slice(1, n), slice(1, n));
+    matrix_ref<double, 2> ys = y(slice(1, n), slice(1, n));
+    const double add = 3.0 * n * n * sizeof(double) * 1e-9;
+    const double scale = 2.0 * n * n * sizeof(double) * 1e-9;
+
+    double t = seconds([&]() { a += b; }, repeat);
+    csv_row("add", "matrix", n, "gbps", add / t);
+    t = seconds([&]() { ar += br; }, repeat);
+    csv_row("add", "ref", n, "gbps", add / t);
+    t = seconds([&]() { xs += ys; }, repeat);
+    csv_row("add", "submatrix", n, "gbps", add / t);
+    t = seconds([&]() {
+      double* p = a.data();
+      const double* q = b.data();
+      for (size_t i = 0; i < n * n; ++i)
+        p[i] += q[i];
+    }, repeat);
+    csv_row("add", "pointer", n, "gbps", add / t);
+
+    t = seconds([&]() { a *= 2.0; }, repeat);
+    csv_row("scale", "matrix", n, "gbps", scale / t);
+    t = seconds([&]() { ar *= 2.0; }, repeat);
+    csv_row("scale", "ref", n, "gbps", scale / t);
+    t = seconds([&]() { xs *= 2.0; }, repeat);
+    csv_row("scale", "submatrix", n, "gbps", scale / t);
+  }
+}
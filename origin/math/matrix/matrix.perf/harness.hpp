@@ -0,0 +1,67 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_PERF_HARNESS_HPP
+#define ORIGIN_MATH_MATRIX_PERF_HARNESS_HPP
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+// Support for the matrix benchmarks. Each benchmark is run as
+//
+//    program [repeat]
+//
+// and writes its results to the standard output as CSV, with one row per
+// measurement and the columns
+//
+//    benchmark,variant,n,metric,value
+//
+// where n is the problem size and metric names the unit of the value (e.g.,
+// gflops, gbps or ns). The rows of different runs can be compared directly
+// to track regressions.
+
+using clock_type = std::chrono::steady_clock;
+
+// Returns the number of repetitions given on the command line.
+inline int
+repetitions(int argc, char* argv[])
+{
+  int r = argc > 1 ? std::atoi(argv[1]) : 1;
+  return r > 0 ? r : 1;
+}
+
+// Returns the average time in seconds of repeat calls to f. One untimed call
+// is made first to warm the caches.
+template <typename F>
+  double
+  seconds(F f, int repeat)
+  {
+    f();
+    auto start = clock_type::now();
+    for (int r = 0; r < repeat; ++r)
+      f();
+    auto stop = clock_type::now();
+    std::chrono::duration<double> d = stop - start;
+    return d.count() / repeat;
+  }
+
+inline void
+csv_header()
+{
+  std::cout << "benchmark,variant,n,metric,value\n";
+}
+
+inline void
+csv_row(const char* benchmark, const char* variant, std::size_t n,
+        const char* metric, double value)
+{
+  std::cout << benchmark << ',' << variant << ',' << n << ','
+            << metric << ',' << value << '\n';
+}
+
+#endif
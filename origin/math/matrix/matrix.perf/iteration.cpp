@@ -0,0 +1,74 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <numeric>
+
+#include <origin/math/matrix/matrix.hpp>
+
+#include "harness.hpp"
+
+using namespace std;
+using namespace origin;
+
+// Measures the cost of visiting each element of an n x n submatrix (the
+// interior of an (n + 2) x (n + 2) matrix) to sum its elements, in
+// nanoseconds per element:
+//
+//    slice_iterator  -- std::accumulate over the submatrix's iterators
+//    indexed         -- nested loops calling operator()(i, j)
+//    cursor          -- nested loops over a matrix_cursor
+//    pointer         -- nested loops over raw pointers, for reference
+//
+// The sums are printed to the standard error so the loops are not removed.
+
+int main(int argc, char* argv[])
+{
+  const int repeat = repetitions(argc, argv);
+  csv_header();
+  double total = 0;
+  for (size_t n = 64; n <= 4096; n *= 4) {
+    matrix<double, 2> m(n + 2, n + 2);
+    fill_uniform(m, 1);
+    matrix_ref<double, 2> s = m(slice(1, n), slice(1, n));
+    const double elems = double(n) * n * 1e-9;
+
+    double t = seconds([&]() { total += accumulate(s.begin(), s.end(), 0.0); }, repeat);
+    csv_row("iterate", "slice_iterator", n, "ns", t / elems);
+
+    t = seconds([&]() {
+      double sum = 0;
+      for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < n; ++j)
+          sum += s(i, j);
+      total += sum;
+    }, repeat);
+    csv_row("iterate", "indexed", n, "ns", t / elems);
+
+    t = seconds([&]() {
+      double sum = 0;
+      auto c = cursor(s);
+      for (size_t i = 0; i < n; ++i, c.move(0)) {
+        auto r = c.line(1);
+        for (size_t j = 0; j < n; ++j)
+          sum += r[j];
+      }
+      total += sum;
+    }, repeat);
+    csv_row("iterate", "cursor", n, "ns", t / elems);
+
+    t = seconds([&]() {
+      double sum = 0;
+      const double* p = m.data() + (n + 2) + 1;
+      for (size_t i = 0; i < n; ++i, p += n + 2)
+        for (size_t j = 0; j < n; ++j)
+          sum += p[j];
+      total += sum;
+    }, repeat);
+    csv_row("iterate", "pointer", n, "ns", t / elems);
+  }
+  cerr << total << '\n';
+}
@@ -0,0 +1,50 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <origin/math/matrix/matrix.hpp>
+
+#include "harness.hpp"
+
+using namespace std;
+using namespace origin;
+
+// Measures the throughput of solving linear systems with n unknowns:
+//
+//    factor   -- lu_factorization::factor, in GFLOP/s (2/3 n^3 flops)
+//    solve    -- lu_factorization::solve with one right-hand side, in
+//                solves per second
+//    batch    -- batch_solve of 64 systems, in GFLOP/s
+
+int main(int argc, char* argv[])
+{
+  const int repeat = repetitions(argc, argv);
+  csv_header();
+  for (size_t n = 32; n <= 1024; n *= 2) {
+    matrix<double, 2> a = random_diagonally_dominant<double>(n, 1);
+    matrix<double, 1> b(n);
+    fill_uniform(b, 2);
+    lu_factorization<double> lu;
+
+    double t = seconds([&]() { lu.factor(a); }, repeat);
+    csv_row("lu", "factor", n, "gflops", 2.0 / 3.0 * n * n * n * 1e-9 / t);
+
+    matrix<double, 1> x = b;
+    t = seconds([&]() { x = b; lu.solve(x); }, repeat);
+    csv_row("lu", "solve", n, "per_second", 1.0 / t);
+
+    if (n <= 256) {
+      const size_t k = 64;
+      matrix<double, 3> as(k, n, n);
+      matrix<double, 2> bs(k, n), xs(k, n);
+      for (size_t q = 0; q < k; ++q)
+        as[q] = random_diagonally_dominant<double>(n, q);
+      fill_uniform(bs, 3);
+      t = seconds([&]() { xs = bs; batch_solve(as, xs); }, repeat);
+      csv_row("lu", "batch", n, "gflops", k * 2.0 / 3.0 * n * n * n * 1e-9 / t);
+    }
+  }
+}
@@ -0,0 +1,62 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <origin/math/matrix/matrix.hpp>
+
+#include "harness.hpp"
+
+using namespace std;
+using namespace origin;
+
+// Measures the throughput of matrix products in GFLOP/s for square matrices
+// of increasing size:
+//
+//    classical   -- matrix_product
+//    strassen    -- matrix_product with the Strassen-Winograd algorithm
+//    transposed  -- matrix_product with a transposed left operand
+//    naive       -- an i-j-k loop over raw pointers, for reference
+
+void naive(const matrix<double, 2>& a, const matrix<double, 2>& b, matrix<double, 2>& c)
+{
+  const size_t n = a.rows();
+  const double* pa = a.data();
+  const double* pb = b.data();
+  double* pc = c.data();
+  for (size_t i = 0; i < n; ++i)
+    for (size_t j = 0; j < n; ++j) {
+      double s = 0;
+      for (size_t k = 0; k < n; ++k)
+        s += pa[i * n + k] * pb[k * n + j];
+      pc[i * n + j] += s;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+  const int repeat = repetitions(argc, argv);
+  csv_header();
+  for (size_t n = 64; n <= 1024; n *= 2) {
+    matrix<double, 2> a(n, n), b(n, n), c(n, n);
+    fill_uniform(a, 1);
+    fill_uniform(b, 2);
+    const double flops = 2.0 * n * n * n * 1e-9;
+
+    double t = seconds([&]() { matrix_product(a, b, c); }, repeat);
+    csv_row("product", "classical", n, "gflops", flops / t);
+
+    t = seconds([&]() { matrix_product(a, b, c, strassen_mode()); }, repeat);
+    csv_row("product", "strassen", n, "gflops", flops / t);
+
+    t = seconds([&]() { matrix_product(transpose(a), b, c); }, repeat);
+    csv_row("product", "transposed", n, "gflops", flops / t);
+
+    if (n <= 512) {
+      t = seconds([&]() { naive(a, b, c); }, repeat);
+      csv_row("product", "naive", n, "gflops", flops / t);
+    }
+  }
+}
@@ -0,0 +1,147 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cmath>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Tests for batched operations.
+
+// Fill the batch with a deterministic sequence of small values.
+template <typename M>
+  void fill(M& m, int seed)
+  {
+    int x = seed;
+    for (auto& e : m) {
+      x = (x * 31 + 7) % 17;
+      e = x - 8;
+    }
+  }
+
+// Compare each batched product against the product of the 2D slices.
+void test_product(size_t b, size_t m, size_t p, size_t n)
+{
+  matrix<double, 3> x(b, m, p);
+  matrix<double, 3> y(b, p, n);
+  fill(x, 1);
+  fill(y, 2);
+
+  matrix<double, 3> z = batch_product(x, y);
+  for (size_t k = 0; k < b; ++k) {
+    matrix<double, 2> xk = x[k];
+    matrix<double, 2> yk = y[k];
+    matrix<double, 2> zk = z[k];
+    assert(zk == xk * yk);
+  }
+}
+
+void test_transform()
+{
+  matrix<int, 3> a(1000, 3, 3);
+  matrix<int, 3> b(1000, 3, 3);
+  matrix<int, 3> c(1000, 3, 3);
+  fill(a, 3);
+  fill(b, 4);
+  batch_transform(a, b, c, [](int x, int y) { return x + y; });
+  assert(c == a + b);
+
+  batch_for_each(c, [](matrix_ref<int, 2> m) { m *= 2; });
+  assert(c == (a + b) * 2);
+}
+
+void test_solve()
+{
+  const size_t b = 5000, n = 4;
+  matrix<double, 3> a(b, n, n);
+  fill(a, 5);
+  for (size_t k = 0; k < b; ++k)
+    for (size_t i = 0; i < n; ++i)
+      a(k, i, i) += 40; // Make each system well-conditioned.
+
+  matrix<double, 2> x(b, n);
+  fill(x, 6);
+
+  // Compute the right-hand sides b[k] = a[k] * x[k].
+  matrix<double, 2> rhs(b, n);
+  for (size_t k = 0; k < b; ++k)
+    for (size_t i = 0; i < n; ++i)
+      for (size_t j = 0; j < n; ++j)
+        rhs(k, i) += a(k, i, j) * x(k, j);
+
+  assert(batch_solve(a, rhs));
+  for (size_t k = 0; k < b; ++k)
+    for (size_t i = 0; i < n; ++i)
+      assert(abs(rhs(k, i) - x(k, i)) < 1e-9);
+
+  // Multiple right-hand sides per system.
+  matrix<double, 3> id(b, n, n);
+  for (size_t k = 0; k < b; ++k)
+    for (size_t i = 0; i < n; ++i)
+      id(k, i, i) = 1;
+  matrix<double, 3> inv = id;
+  assert(batch_solve(a, inv));
+  matrix<double, 3> r = batch_product(a, inv);
+  for (auto i = r.begin(), j = id.begin(); i != r.end(); ++i, ++j)
+    assert(abs(*i - *j) < 1e-9);
+
+  // Singular systems are reported.
+  matrix<double, 3> s(2, 2, 2);
+  matrix<double, 2> sb(2, 2);
+  s(0, 0, 0) = s(0, 1, 1) = 1;
+  assert(!batch_solve(s, sb));
+}
+
+void test_parallel_for()
+{
+  using matrix_impl::parallel_for;
+
+  // Nested loops run on the shared pool, so they use no more threads than
+  // it has.
+  mutex lock;
+  set<thread::id> ids;
+  size_t count = 0;
+  parallel_for(64, 1, [&](size_t first, size_t last) {
+    for (size_t i = first; i != last; ++i)
+      parallel_for(64, 1, [&](size_t lo, size_t hi) {
+        lock_guard<mutex> g(lock);
+        ids.insert(this_thread::get_id());
+        count += hi - lo;
+      });
+  });
+  assert(count == 64 * 64);
+  assert(ids.size() <= matrix_impl::concurrency());
+
+  // Exceptions are rethrown on the calling thread.
+  bool caught = false;
+  try {
+    parallel_for(1000, 1, [](size_t, size_t last) {
+      if (last == 1000)
+        throw runtime_error("last chunk");
+    });
+  } catch (runtime_error&) {
+    caught = true;
+  }
+  assert(caught);
+}
+
+int main()
+{
+  for (size_t p = 1; p <= 6; ++p)
+    test_product(3000, 3, p, 4);
+  test_product(7, 9, 11, 5);
+  test_transform();
+  test_solve();
+  test_parallel_for();
+}
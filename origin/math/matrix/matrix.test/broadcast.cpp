@@ -0,0 +1,107 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <iostream>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Tests for broadcasting elementwise operations.
+
+void test_slice()
+{
+  matrix_slice<1> s(0, {3});
+  matrix_slice<2> b = broadcast(s, array<size_t, 2>{{4, 3}});
+  assert(b.extents[0] == 4 && b.extents[1] == 3);
+  assert(b.strides[0] == 0 && b.strides[1] == 1);
+  assert(b.size == 12);
+
+  matrix_slice<2> c(0, {4, 1});
+  matrix_slice<2> d = broadcast(c, array<size_t, 2>{{4, 3}});
+  assert(d.strides[0] == 1 && d.strides[1] == 0);
+}
+
+void test_assign_ops()
+{
+  matrix<int, 2> m {
+    {0, 1, 2},
+    {3, 4, 5}
+  };
+  matrix<int, 1> bias {10, 20, 30};
+
+  // Adding a row adds it to every row.
+  m += bias;
+  matrix<int, 2> expect {
+    {10, 21, 32},
+    {13, 24, 35}
+  };
+  assert(m == expect);
+  m -= bias;
+
+  // Adding a column adds it to every column.
+  matrix<int, 2> col {
+    {100},
+    {200}
+  };
+  m += col;
+  assert(m(0, 2) == 102 && m(1, 0) == 203);
+
+  // Broadcasting also applies to references.
+  m.row(0) -= matrix<int, 1>{100, 100, 100};
+  assert(m(0, 0) == 0);
+
+  // Scalar assignment fills the matrix.
+  m = 7;
+  assert(all_match(m, 7));
+}
+
+void test_transform()
+{
+  matrix<int, 2> a {
+    {1},
+    {2},
+    {3}
+  };
+  matrix<int, 1> b {10, 20};
+
+  // (3 x 1) op (2) -> (3 x 2)
+  auto c = broadcast_transform(a, b, [](int x, int y) { return x * y; });
+  matrix<int, 2> expect {
+    {10, 20},
+    {20, 40},
+    {30, 60}
+  };
+  assert(c == expect);
+
+  matrix<int, 2> h(3, 2);
+  hadamard_product(a, b, h);
+  assert(h == expect);
+
+  // A broadcast view can be copied into a matrix.
+  matrix<int, 2> r = broadcast(b, array<size_t, 2>{{3, 2}});
+  matrix<int, 2> rr {
+    {10, 20},
+    {10, 20},
+    {10, 20}
+  };
+  assert(r == rr);
+
+  // 3D broadcasting against a 2D operand.
+  matrix<int, 3> m(2, 3, 2);
+  auto s = broadcast_transform(m, expect, [](int x, int y) { return x + y; });
+  assert(s.extent(0) == 2);
+  assert(s[0] == expect && s[1] == expect);
+}
+
+int main()
+{
+  test_slice();
+  test_assign_ops();
+  test_transform();
+}
@@ -0,0 +1,182 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cmath>
+#include <iostream>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Tests for einsum contractions.
+
+static_assert(einsum_valid("ik,kj->ij", 2, 2, 2), "");
+static_assert(einsum_valid("bik,bkj->bij", 3, 3, 3), "");
+static_assert(einsum_valid("ijk,jkl->il", 3, 3, 2), "");
+static_assert(!einsum_valid("ik,kj->ij", 3, 2, 2), "");  // Wrong order
+static_assert(!einsum_valid("ik,kj->iz", 2, 2, 2), "");  // Unknown label
+static_assert(!einsum_valid("ii,ij->ij", 2, 2, 2), "");  // Repeated label
+static_assert(!einsum_valid("ik,jl->ij", 2, 2, 2), "");  // l is not used
+static_assert(!einsum_valid("ik;kj->ij", 2, 2, 2), "");  // Bad separator
+
+// Returns the value stored at the given indexes of a test tensor.
+double value(size_t i, size_t j, size_t k = 0)
+{
+  return std::sin(double(i * i + 3 * j + 5 * k * j + 1));
+}
+
+matrix<double, 2> make_matrix(size_t m, size_t n)
+{
+  matrix<double, 2> a(m, n);
+  for (size_t i = 0; i < m; ++i)
+    for (size_t j = 0; j < n; ++j)
+      a(i, j) = value(i, j);
+  return a;
+}
+
+matrix<double, 3> make_tensor(size_t l, size_t m, size_t n)
+{
+  matrix<double, 3> a(l, m, n);
+  for (size_t i = 0; i < l; ++i)
+    for (size_t j = 0; j < m; ++j)
+      for (size_t k = 0; k < n; ++k)
+        a(i, j, k) = value(i, j, k);
+  return a;
+}
+
+bool close(double x, double y)
+{
+  return std::abs(x - y) < 1e-10;
+}
+
+void test_product()
+{
+  matrix<double, 2> a = make_matrix(7, 5);
+  matrix<double, 2> b = make_matrix(5, 9);
+  matrix<double, 2> c(7, 9);
+  einsum("ik,kj->ij", a, b, c);
+  matrix<double, 2> d(7, 9);
+  matrix_product(a, b, d);
+  assert(c == d);
+
+  // The transpose of the product, written into c^T.
+  matrix<double, 2> ct(9, 7);
+  einsum("ik,kj->ji", a, b, ct);
+  assert(transpose(ct) == d);
+
+  // A product with a transposed view.
+  matrix<double, 2> at = transpose(a);
+  matrix<double, 2> e(7, 9);
+  einsum("ki,kj->ij", at, b, e);
+  assert(e == d);
+
+  // Results are accumulated.
+  einsum("ik,kj->ij", a, b, c);
+  matrix<double, 2> dd = d + d;
+  for (size_t i = 0; i < 7; ++i)
+    for (size_t j = 0; j < 9; ++j)
+      assert(close(c(i, j), dd(i, j)));
+}
+
+void test_batched()
+{
+  matrix<double, 3> a = make_tensor(4, 6, 5);
+  matrix<double, 3> b = make_tensor(4, 5, 3);
+  matrix<double, 3> c(4, 6, 3);
+  einsum("bik,bkj->bij", a, b, c);
+  for (size_t q = 0; q < 4; ++q) {
+    matrix<double, 2> d(6, 3);
+    matrix_product(a[q], b[q], d);
+    assert(c[q] == d);
+  }
+
+  // Summing over the batch dimension.
+  matrix<double, 2> s(6, 3);
+  einsum("bik,bkj->ij", a, b, s);
+  for (size_t i = 0; i < 6; ++i)
+    for (size_t j = 0; j < 3; ++j)
+      assert(close(s(i, j), c(0, i, j) + c(1, i, j) + c(2, i, j) + c(3, i, j)));
+}
+
+void test_permuted()
+{
+  // Contract two dimensions, which are not adjacent in b.
+  matrix<double, 3> a = make_tensor(3, 4, 5);
+  matrix<double, 3> b = make_tensor(5, 6, 4);
+  matrix<double, 2> c(6, 3);
+  einsum("ijk,klj->li", a, b, c);
+  for (size_t i = 0; i < 3; ++i)
+    for (size_t l = 0; l < 6; ++l) {
+      double x = 0;
+      for (size_t j = 0; j < 4; ++j)
+        for (size_t k = 0; k < 5; ++k)
+          x += a(i, j, k) * b(k, l, j);
+      assert(close(c(l, i), x));
+    }
+
+  // An outer product with interleaved result dimensions.
+  matrix<double, 2> x = make_matrix(2, 3);
+  matrix<double, 2> y = make_matrix(4, 5);
+  matrix<double, 4> z(2, 4, 3, 5);
+  einsum("ij,kl->ikjl", x, y, z);
+  for (size_t i = 0; i < 2; ++i)
+    for (size_t j = 0; j < 3; ++j)
+      for (size_t k = 0; k < 4; ++k)
+        for (size_t l = 0; l < 5; ++l)
+          assert(z(i, k, j, l) == x(i, j) * y(k, l));
+}
+
+void test_blocked()
+{
+  // Large contractions use the blocked kernel. The extents are not
+  // multiples of its tile, strip or panel sizes.
+  matrix<double, 3> a = make_tensor(2, 70, 260);
+  matrix<double, 3> b = make_tensor(2, 260, 1030);
+  matrix<double, 3> c(2, 70, 1030);
+  einsum("bik,bkj->bij", a, b, c);
+  for (size_t q = 0; q < 2; ++q) {
+    matrix<double, 2> d(70, 1030);
+    matrix_product(a[q], b[q], d);
+    for (size_t i = 0; i < 70; ++i)
+      for (size_t j = 0; j < 1030; ++j)
+        assert(close(c(q, i, j), d(i, j)));
+  }
+
+  // A column-major result and a transposed operand.
+  matrix<double, 2> x = make_matrix(90, 300);
+  matrix<double, 2> y = make_matrix(300, 45);
+  matrix<double, 2> xy(90, 45);
+  matrix_product(x, y, xy);
+  matrix<double, 2> e(matrix_layout::column_major, 90, 45);
+  matrix<double, 2> xt = transpose(x);
+  einsum("ki,kj->ij", xt, y, e);
+  for (size_t i = 0; i < 90; ++i)
+    for (size_t j = 0; j < 45; ++j)
+      assert(close(e(i, j), xy(i, j)));
+
+  // Integer products are exact.
+  matrix<int, 2> u(65, 130), v(130, 70);
+  for (size_t i = 0; i < 130; ++i) {
+    for (size_t j = 0; j < 65; ++j)
+      u(j, i) = int((i * 7 + j * 3) % 11) - 5;
+    for (size_t j = 0; j < 70; ++j)
+      v(i, j) = int((i * 5 + j) % 13) - 6;
+  }
+  matrix<int, 2> w(65, 70), z(65, 70);
+  einsum("ik,kj->ij", u, v, w);
+  matrix_product(u, v, z);
+  assert(w == z);
+}
+
+int main()
+{
+  test_product();
+  test_batched();
+  test_permuted();
+  test_blocked();
+}
@@ -0,0 +1,87 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <iostream>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Tests for matrix cursors.
+
+void test_2d()
+{
+  matrix<int, 2> m {
+    {0, 1, 2},
+    {3, 4, 5},
+    {6, 7, 8}
+  };
+
+  auto c = cursor(m);
+  assert(*c == 0);
+  assert(c(1, 2) == 5);
+  c.move(0).move(1);
+  assert(*c == 4);
+  assert(c(-1, -1) == 0 && c(1, 1) == 8 && c(1, -1) == 6);
+  assert(c[1] == 5 && c[-1] == 3);
+
+  // Lines along each dimension.
+  auto row = c.line(1);
+  auto col = c.line(0);
+  assert(row[1] == 5 && col[1] == 7);
+  col[-1] = 10;
+  assert(m(0, 1) == 10);
+
+  // Increment every element, row by row.
+  auto r = cursor(m);
+  for (size_t i = 0; i != m.rows(); ++i, r.move(0)) {
+    auto x = r.line(1);
+    for (size_t j = 0; j != m.cols(); ++j)
+      x[j] += 1;
+  }
+  assert(m(0, 0) == 1 && m(0, 1) == 11 && m(2, 2) == 9);
+
+  // A cursor over a const matrix refers to const elements.
+  const matrix<int, 2>& cm = m;
+  auto k = cursor(cm);
+  static_assert(std::is_same<decltype(*k), const int&>::value, "");
+  assert(k(2, 0) == 7);
+}
+
+void test_views()
+{
+  matrix<int, 2> m {
+    {0, 1, 2},
+    {3, 4, 5}
+  };
+
+  // A cursor over a transposed view moves along the columns of m.
+  auto t = cursor(transpose(m));
+  assert(t.stride(0) == 1 && t.stride(1) == 3);
+  assert(t(2, 1) == 5);
+
+  // A cursor over a row.
+  auto r = cursor(m.row(1));
+  assert(*r == 3 && r[2] == 5);
+
+  // A 3D cursor.
+  matrix<int, 3> a(2, 3, 4);
+  int n = 0;
+  for (auto& x : a)
+    x = n++;
+  auto c = cursor(a);
+  assert(c(1, 2, 3) == 23);
+  c.move(2, 3).move(0);
+  assert(*c == a(1, 0, 3));
+}
+
+int main()
+{
+  test_2d();
+  test_views();
+}
@@ -0,0 +1,120 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cmath>
+#include <iostream>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Tests for matrix-vector products and rank-1 updates.
+
+// The reference product, computed one element at a time.
+template <typename M, typename V>
+  matrix<double, 1> naive_product(const M& a, const V& x)
+  {
+    matrix<double, 1> r(a.extent(0));
+    for (size_t i = 0; i < a.extent(0); ++i)
+      for (size_t j = 0; j < a.extent(1); ++j)
+        r(i) += a(i, j) * x(j);
+    return r;
+  }
+
+void test_gemv()
+{
+  matrix<double, 2> a {
+    {1, 2, 3},
+    {4, 5, 6}
+  };
+  matrix<double, 1> x {1.0, 0.0, -1.0};
+  matrix<double, 1> ax {-2.0, -2.0};
+  assert(a * x == ax);
+
+  // The transposed product.
+  matrix<double, 1> y {1.0, 2.0};
+  matrix<double, 1> aty {9.0, 12.0, 15.0};
+  assert(transpose(a) * y == aty);
+
+  // y = 2 a x + 3 y
+  matrix<double, 1> z {1.0, 1.0};
+  gemv(2.0, a, x, 3.0, z);
+  matrix<double, 1> expect {-1.0, -1.0};
+  assert(z == expect);
+
+  // A zero beta ignores the contents of y.
+  matrix<double, 1> n {double(NAN), double(NAN)};
+  gemv(1.0, a, x, 0.0, n);
+  assert(n == ax);
+
+  // Strided operands: a column of a matrix as x, a row of a view as y.
+  matrix<double, 2> b {
+    {1, 10},
+    {0, 20},
+    {-1, 30}
+  };
+  matrix<double, 1> r(2);
+  gemv(1.0, a, b.col(0), 0.0, r);
+  assert(r == ax);
+}
+
+// Large products are computed by several threads.
+void test_large()
+{
+  const size_t m = 700, n = 900;
+  matrix<double, 2> a(m, n);
+  for (size_t i = 0; i < m; ++i)
+    for (size_t j = 0; j < n; ++j)
+      a(i, j) = double((i * 7 + j * 3) % 11) - 5;
+  matrix<double, 1> x(n);
+  for (size_t j = 0; j < n; ++j)
+    x(j) = double(j % 5);
+  matrix<double, 1> y(m);
+  for (size_t i = 0; i < m; ++i)
+    y(i) = double(i % 3);
+
+  assert(a * x == naive_product(a, x));
+  assert(transpose(a) * y == naive_product(transpose(a), y));
+}
+
+void test_ger()
+{
+  matrix<double, 2> a(2, 3);
+  matrix<double, 1> x {1.0, 2.0};
+  matrix<double, 1> y {1.0, 0.0, -1.0};
+  ger(2.0, x, y, a);
+  matrix<double, 2> expect {
+    {2, 0, -2},
+    {4, 0, -4}
+  };
+  assert(a == expect);
+
+  // Updating a transposed view updates the transpose.
+  matrix<double, 2> b(3, 2);
+  auto bt = transpose(b);
+  ger(2.0, x, y, bt);
+  assert(transpose(b) == expect);
+
+  // Large updates.
+  const size_t m = 500, n = 600;
+  matrix<double, 2> c(m, n);
+  matrix<double, 1> u(m), v(n);
+  iota(u.begin(), u.end(), 0.0);
+  iota(v.begin(), v.end(), 1.0);
+  ger(0.5, u, v, c);
+  for (size_t i = 0; i < m; i += 37)
+    for (size_t j = 0; j < n; j += 41)
+      assert(c(i, j) == 0.5 * u(i) * v(j));
+}
+
+int main()
+{
+  test_gemv();
+  test_large();
+  test_ger();
+}
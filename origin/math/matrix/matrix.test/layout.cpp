@@ -0,0 +1,212 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+#include <origin/math/matrix/io.hpp>
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Tests for row-major and column-major matrix layouts.
+
+void test_slice()
+{
+  matrix_slice<3> r(0, {2, 3, 4});
+  assert(r.strides[0] == 12 && r.strides[1] == 4 && r.strides[2] == 1);
+  assert(layout(r) == matrix_layout::row_major);
+
+  matrix_slice<3> c(0, {2, 3, 4}, matrix_layout::column_major);
+  assert(c.strides[0] == 1 && c.strides[1] == 2 && c.strides[2] == 6);
+  assert(c.size == 24);
+  assert(layout(c) == matrix_layout::column_major);
+  assert(c(1, 2, 3) == 1 + 2 * 2 + 3 * 6);
+
+  assert(layout(reverse_axes(c)) == matrix_layout::row_major);
+}
+
+void test_column_major()
+{
+  matrix<int, 2> m(matrix_layout::column_major, 3, 2);
+  assert(m.layout() == matrix_layout::column_major);
+  assert(m.descriptor().strides[0] == 1);
+  assert(m.descriptor().strides[1] == 3);
+
+  for (size_t i = 0; i < 3; ++i)
+    for (size_t j = 0; j < 2; ++j)
+      m(i, j) = int(i * 10 + j);
+
+  // Elements are stored column by column.
+  int expect[] {0, 10, 20, 1, 11, 21};
+  assert(equal(m.begin(), m.end(), expect));
+
+  // Columns are contiguous.
+  assert(m.col(1).descriptor().strides[0] == 1);
+
+  // Comparison and conversion respect indexes rather than memory order.
+  matrix<int, 2> r {
+    {0, 1},
+    {10, 11},
+    {20, 21}
+  };
+  assert(r.layout() == matrix_layout::row_major);
+  assert(m == r);
+  assert(r == m);
+
+  matrix<int, 2> x = m(slice::all, slice::all);
+  assert(x.layout() == matrix_layout::row_major);
+  assert(x == r);
+  assert(equal(x.begin(), x.end(), r.begin()));
+
+  matrix<int, 2> y(r, matrix_layout::column_major);
+  assert(y.layout() == matrix_layout::column_major);
+  assert(equal(y.begin(), y.end(), m.begin()));
+
+  // Copies preserve the layout.
+  matrix<int, 2> z = m;
+  assert(z.layout() == matrix_layout::column_major);
+
+  // Printing is independent of the layout.
+  ostringstream s1, s2;
+  s1 << m;
+  s2 << r;
+  assert(s1.str() == s2.str());
+}
+
+void test_static()
+{
+  matrix<double, 2> r {
+    {1, 2, 3},
+    {4, 5, 6}
+  };
+  matrix<double, 2> c(r, matrix_layout::column_major);
+
+  // Conversion to a static matrix copies by index.
+  static_matrix<double, 2, 3> s(c);
+  assert(s == r);
+  assert(s(0, 1) == 2 && s(1, 0) == 4);
+
+  static_matrix<double, 3, 2> t(transpose(c));
+  assert(t == transpose(r));
+}
+
+void test_io()
+{
+  matrix<int, 2> r {
+    {1, 2, 3},
+    {4, 5, 6}
+  };
+  matrix<int, 2> c(r, matrix_layout::column_major);
+
+  // The binary formats store the elements in row-major order.
+  stringstream ss;
+  assert(write_matrix(ss, c));
+  matrix<int, 2> x;
+  assert(read_matrix(ss, x));
+  assert(x == r);
+}
+
+void test_inverse()
+{
+  matrix<double, 2> a {
+    {2, 1, 0},
+    {0, 1, 0},
+    {5, 0, 1}
+  };
+  matrix<double, 2> e {
+    {0.5, -0.5, 0},
+    {0, 1, 0},
+    {-2.5, 2.5, 1}
+  };
+
+  // The small inverses read the operand by index.
+  matrix<double, 2> c(a, matrix_layout::column_major);
+  matrix<double, 2> x;
+  assert(inverse(c, x));
+  for (size_t i = 0; i < 3; ++i)
+    for (size_t j = 0; j < 3; ++j)
+      assert(std::abs(x(i, j) - e(i, j)) < 1e-12);
+}
+
+void test_arithmetic()
+{
+  matrix<double, 2> a {
+    {1, 2, 3},
+    {4, 5, 6}
+  };
+  matrix<double, 2> b(a, matrix_layout::column_major);
+
+  matrix<double, 2> c = b;
+  c += a;
+  assert(c == a * 2.0);
+  assert(b + a == a * 2.0);
+  assert((a - b == matrix<double, 2>(2, 3)));
+
+  // Broadcasting a row across a column-major matrix.
+  matrix<double, 1> v {10.0, 20.0, 30.0};
+  c = b;
+  c += v;
+  matrix<double, 2> expect {
+    {11, 22, 33},
+    {14, 25, 36}
+  };
+  assert(c == expect);
+
+  assert(sum(b) == 21);
+  assert(max(b) == 6);
+  assert(argmax(b) == 5);
+}
+
+void test_product()
+{
+  matrix<double, 2> a(7, 5);
+  matrix<double, 2> b(5, 6);
+  iota(a.begin(), a.end(), 1.0);
+  iota(b.begin(), b.end(), -10.0);
+
+  matrix<double, 2> expect(7, 6);
+  matrix_product(a, b, expect);
+
+  // Column-major result.
+  matrix<double, 2> c(matrix_layout::column_major, 7, 6);
+  matrix_product(a, b, c);
+  assert(c == expect);
+
+  // Column-major operands.
+  matrix<double, 2> ac(a, matrix_layout::column_major);
+  matrix<double, 2> bc(b, matrix_layout::column_major);
+  matrix<double, 2> d(7, 6);
+  matrix_product(ac, bc, d);
+  assert(d == expect);
+
+  matrix<double, 2> e(matrix_layout::column_major, 7, 6);
+  matrix_product(ac, bc, e);
+  assert(e == expect);
+  assert(ac * bc == expect);
+
+  matrix<double, 2> f(matrix_layout::column_major, 7, 6);
+  matrix_product(ac, bc, f, strassen_mode(1));
+  assert(f == expect);
+
+  // Matrix-vector products.
+  matrix<double, 1> x {1.0, 0.0, -1.0, 0.0, 2.0};
+  assert(ac * x == a * x);
+}
+
+int main()
+{
+  test_slice();
+  test_column_major();
+  test_static();
+  test_io();
+  test_inverse();
+  test_arithmetic();
+  test_product();
+}
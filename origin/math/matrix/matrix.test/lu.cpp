@@ -0,0 +1,227 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cmath>
+#include <iostream>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Tests for the inverse, determinant and condition estimate.
+
+// Returns an n x n test matrix that is well conditioned but not symmetric
+// or diagonally dominant.
+matrix<double, 2> test_matrix(size_t n)
+{
+  matrix<double, 2> a(n, n);
+  for (size_t i = 0; i < n; ++i)
+    for (size_t j = 0; j < n; ++j)
+      a(i, j) = sin(i * i + 3 * j * j + i * j + 1);
+  for (size_t i = 0; i < n; ++i)
+    a(i, i) += 2 * sqrt(double(n));
+  return a;
+}
+
+// Returns the largest absolute difference between a x and the identity.
+double identity_error(const matrix<double, 2>& a, const matrix<double, 2>& x)
+{
+  const size_t n = a.rows();
+  matrix<double, 2> p(n, n);
+  matrix_product(a, x, p);
+  double e = 0;
+  for (size_t i = 0; i < n; ++i)
+    for (size_t j = 0; j < n; ++j)
+      e = std::max(e, std::abs(p(i, j) - (i == j ? 1.0 : 0.0)));
+  return e;
+}
+
+// Returns the 1-norm of a.
+double norm1(const matrix<double, 2>& a)
+{
+  double r = 0;
+  for (size_t j = 0; j < a.cols(); ++j) {
+    double c = 0;
+    for (size_t i = 0; i < a.rows(); ++i)
+      c += std::abs(a(i, j));
+    r = std::max(r, c);
+  }
+  return r;
+}
+
+void test_blocked_factor()
+{
+  // The blocked factorization computes the same factors as the unblocked
+  // one, up to rounding.
+  for (size_t n : {10, 64, 65, 200}) {
+    matrix<double, 2> a = test_matrix(n);
+    matrix<double, 2> b = a;
+    vector<size_t> pa(n), pb(n);
+    vector<double> ws(matrix_impl::lu_workspace(n));
+    assert(matrix_impl::lu_factor(n, matrix_impl::block<double>{a.data(), n, 1}, pa.data()));
+    assert(matrix_impl::blocked_lu_factor(n, matrix_impl::block<double>{b.data(), n, 1},
+                                          pb.data(), ws.data()));
+    assert(pa == pb);
+    for (size_t i = 0; i < n; ++i)
+      for (size_t j = 0; j < n; ++j)
+        assert(std::abs(a(i, j) - b(i, j)) < 1e-10);
+  }
+}
+
+void test_inverse()
+{
+  for (size_t n : {1, 2, 3, 4, 5, 70, 150}) {
+    matrix<double, 2> a = test_matrix(n);
+    matrix<double, 2> x;
+    assert(inverse(a, x));
+    assert(x.rows() == n && x.cols() == n);
+    assert(identity_error(a, x) < 1e-10);
+
+    // The operand may have any layout.
+    matrix<double, 2> c(a, matrix_layout::column_major);
+    assert(inverse(c, x));
+    assert(identity_error(a, x) < 1e-10);
+    assert(inverse(transpose(a), x));
+    assert(identity_error(matrix<double, 2>(transpose(a)), x) < 1e-10);
+  }
+
+  // Singular matrices.
+  matrix<double, 2> s2 {
+    {1, 2},
+    {2, 4}
+  };
+  matrix<double, 2> x;
+  assert(!inverse(s2, x));
+  matrix<double, 2> s = test_matrix(100);
+  s[7] = s[3];
+  assert(!inverse(s, x));
+}
+
+void test_determinant()
+{
+  matrix<double, 2> a {
+    {2, 0, 1},
+    {1, 3, 2},
+    {1, 1, 2}
+  };
+  assert(std::abs(determinant(a) - 6.0) < 1e-12);
+
+  // The determinant of a permuted diagonal matrix.
+  for (size_t n : {5, 100}) {
+    matrix<double, 2> d(n, n);
+    double expected = 1;
+    for (size_t i = 0; i < n; ++i) {
+      d(i, (i + 1) % n) = 1 + i % 3 * 0.5;
+      expected *= 1 + i % 3 * 0.5;
+    }
+    // The cyclic shift has sign (-1)^(n - 1).
+    if (n % 2 == 0)
+      expected = -expected;
+    assert(std::abs(determinant(d) - expected) < 1e-9 * std::abs(expected));
+
+    int sign;
+    double ld = log_determinant(d, sign);
+    assert(sign == (expected < 0 ? -1 : 1));
+    assert(std::abs(ld - std::log(std::abs(expected))) < 1e-9);
+  }
+
+  // The log determinant of a matrix whose determinant overflows.
+  matrix<double, 2> big(400, 400);
+  for (size_t i = 0; i < 400; ++i)
+    big(i, i) = 1e3;
+  assert(std::isinf(determinant(big)));
+  int sign;
+  assert(std::abs(log_determinant(big, sign) - 400 * std::log(1e3)) < 1e-9);
+  assert(sign == 1);
+
+  // Singular.
+  big(5, 5) = 0;
+  assert(determinant(big) == 0);
+  assert(std::isinf(log_determinant(big, sign)) && sign == 0);
+
+  // Small matrices agree with the factorization.
+  matrix<double, 2> t = test_matrix(4);
+  lu_factorization<double> lu;
+  assert(lu.factor(t));
+  assert(std::abs(determinant(t) - lu.determinant()) < 1e-10 * std::abs(lu.determinant()));
+}
+
+void test_condition()
+{
+  for (size_t n : {3, 30, 120}) {
+    matrix<double, 2> a = test_matrix(n);
+    matrix<double, 2> x;
+    assert(inverse(a, x));
+    const double exact = norm1(a) * norm1(x);
+    const double est = condition_estimate(a);
+    assert(est <= exact * (1 + 1e-10));
+    assert(est >= exact / 3);
+  }
+
+  // Small orders are exact, for operands of any layout.
+  for (size_t n : {2, 3, 4}) {
+    matrix<double, 2> a = test_matrix(n);
+    matrix<double, 2> x;
+    assert(inverse(a, x));
+    const double exact = norm1(a) * norm1(x);
+    matrix<double, 2> c(a, matrix_layout::column_major);
+    assert(std::abs(condition_estimate(c) - exact) < 1e-10 * exact);
+
+    matrix<double, 2> t = transpose(a);
+    assert(inverse(t, x));
+    const double exact_t = norm1(t) * norm1(x);
+    assert(std::abs(condition_estimate(transpose(a)) - exact_t) < 1e-10 * exact_t);
+  }
+
+  // An ill-conditioned matrix: the Hilbert matrix of order 8 has a
+  // condition number of about 3.4e10.
+  matrix<double, 2> h(8, 8);
+  for (size_t i = 0; i < 8; ++i)
+    for (size_t j = 0; j < 8; ++j)
+      h(i, j) = 1.0 / (i + j + 1);
+  const double c = condition_estimate(h);
+  assert(c > 1e10 && c < 1e11);
+
+  matrix<double, 2> s(6, 6);
+  assert(std::isinf(condition_estimate(s)));
+}
+
+void test_reuse()
+{
+  // A factorization object reuses its storage for matrices of the same
+  // size, and solves systems with vectors and matrices.
+  lu_factorization<double> lu;
+  for (size_t k = 0; k < 3; ++k) {
+    matrix<double, 2> a = test_matrix(90);
+    a(0, 0) += k;
+    assert(lu.factor(a));
+    assert(lu.size() == 90 && !lu.singular());
+
+    matrix<double, 1> b(90);
+    for (size_t i = 0; i < 90; ++i)
+      b(i) = i;
+    matrix<double, 1> x = b;
+    lu.solve(x);
+    matrix<double, 1> r = a * x;
+    for (size_t i = 0; i < 90; ++i)
+      assert(std::abs(r(i) - b(i)) < 1e-9);
+
+    matrix<double, 2> inv;
+    lu.inverse(inv);
+    assert(identity_error(a, inv) < 1e-10);
+  }
+}
+
+int main()
+{
+  test_blocked_factor();
+  test_inverse();
+  test_determinant();
+  test_condition();
+  test_reuse();
+}
@@ -0,0 +1,209 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Tests for packed symmetric, triangular and banded matrices.
+
+// Returns the largest absolute difference between the vectors a and b.
+template <typename M1, typename M2>
+  double max_error(const M1& a, const M2& b)
+  {
+    double e = 0;
+    for (size_t i = 0; i < a.size(); ++i)
+      e = std::max(e, std::abs(a(i) - b(i)));
+    return e;
+  }
+
+// Returns a vector of n distinct values.
+matrix<double, 1> make_vector(size_t n)
+{
+  matrix<double, 1> v(n);
+  for (size_t i = 0; i < n; ++i)
+    v(i) = double(i % 7) - 2.5;
+  return v;
+}
+
+void test_symmetric()
+{
+  static_assert(Matrix<symmetric_matrix<double>>(), "");
+
+  matrix<double, 2> d {
+    {4, 1, 2},
+    {1, 5, 3},
+    {2, 3, 6}
+  };
+  symmetric_matrix<double> s(d);
+  assert(s.packed_size() == 6);
+  assert(s(0, 2) == 2 && s(2, 0) == 2);
+  assert(dense(s) == d);
+
+  // Both indexes refer to the same element.
+  s(0, 1) = 7;
+  assert(s(1, 0) == 7);
+  s(0, 1) = 1;
+
+  matrix<double, 1> x {1.0, -1.0, 2.0};
+  assert(s * x == d * x);
+
+  // A positive definite system.
+  matrix<double, 1> b = d * x;
+  assert(solve(s, b));
+  assert(max_error(b, x) < 1e-12);
+
+  // Cholesky factor.
+  triangular_matrix<double> l;
+  assert(cholesky(s, l));
+  matrix<double, 2> ll(3, 3);
+  matrix_product(dense(l), transpose(dense(l)), ll);
+  for (size_t i = 0; i < 3; ++i)
+    assert(max_error(ll.row(i), d.row(i)) < 1e-12);
+
+  // Not positive definite.
+  symmetric_matrix<double> z(2);
+  z(0, 0) = 1;
+  z(1, 0) = 2;
+  z(1, 1) = 1;
+  matrix<double, 1> y {1.0, 1.0};
+  assert(!solve(z, y));
+
+  ostringstream s1, s2;
+  s1 << s;
+  s2 << d;
+  assert(s1.str() == s2.str());
+}
+
+void test_triangular()
+{
+  matrix<double, 2> d {
+    {2, 1, 3, 4},
+    {5, 3, 2, 1},
+    {1, 4, 4, 2},
+    {3, 1, 2, 5}
+  };
+  triangular_matrix<double> lo(d, matrix_triangle::lower);
+  triangular_matrix<double> up(d, matrix_triangle::upper);
+  assert(lo.packed_size() == 10);
+  const auto& clo = lo;
+  const auto& cup = up;
+  assert(clo(3, 0) == 3 && clo(0, 3) == 0);
+  assert(cup(0, 3) == 4 && cup(3, 0) == 0);
+  assert(lo != triangular_matrix<double>(d, matrix_triangle::upper));
+
+  matrix<double, 2> dl = dense(lo);
+  matrix<double, 2> du = dense(up);
+  assert(dl(1, 0) == 5 && dl(0, 1) == 0);
+  assert(du(0, 1) == 1 && du(1, 0) == 0);
+
+  matrix<double, 1> x {1.0, 2.0, -1.0, 0.5};
+  assert(lo * x == dl * x);
+  assert(up * x == du * x);
+
+  matrix<double, 1> b = dl * x;
+  assert(solve(lo, b));
+  assert(max_error(b, x) < 1e-12);
+  b = du * x;
+  assert(solve(up, b));
+  assert(max_error(b, x) < 1e-12);
+
+  // Several right-hand sides, one per column.
+  matrix<double, 2> xs {
+    {1, 2},
+    {0, -1},
+    {3, 1},
+    {2, 2}
+  };
+  matrix<double, 2> bs(4, 2);
+  matrix_product(du, xs, bs);
+  assert(solve(up, bs));
+  for (size_t i = 0; i < 4; ++i)
+    assert(max_error(bs.row(i), xs.row(i)) < 1e-12);
+
+  // A zero on the diagonal.
+  triangular_matrix<double> s(2);
+  s(0, 0) = 1;
+  s(1, 0) = 1;
+  s(1, 1) = 0;
+  matrix<double, 1> y {1.0, 1.0};
+  assert(!solve(s, y));
+}
+
+void test_banded()
+{
+  const size_t n = 9;
+  banded_matrix<double> a(n, 2, 1);
+  assert(a.width() == 4);
+  for (size_t i = 0; i < n; ++i)
+    for (size_t j = 0; j < n; ++j)
+      if (a.stored(i, j))
+        a(i, j) = i == j ? 10.0 : double(i + 2 * j) / 10;
+
+  matrix<double, 2> d = dense(a);
+  assert(d(0, 2) == 0 && d(3, 0) == 0 && d(2, 0) != 0);
+  assert(banded_matrix<double>(d, 2, 1) == a);
+
+  matrix<double, 1> x = make_vector(n);
+  assert(max_error(a * x, d * x) < 1e-12);
+
+  matrix<double, 1> b = d * x;
+  assert(solve(a, b));
+  assert(max_error(b, x) < 1e-12);
+
+  // The matrix is not modified by the solve.
+  assert(dense(a) == d);
+}
+
+void test_tridiagonal()
+{
+  // The second difference matrix is positive definite.
+  const size_t n = 1000;
+  banded_matrix<double> t(n, 1, 1);
+  matrix<double, 1> lower(n - 1), diag(n), upper(n - 1);
+  for (size_t i = 0; i < n; ++i) {
+    t(i, i) = diag(i) = 2;
+    if (i > 0)
+      t(i, i - 1) = lower(i - 1) = -1;
+    if (i + 1 < n)
+      t(i, i + 1) = upper(i) = -1;
+  }
+
+  matrix<double, 1> x = make_vector(n);
+  matrix<double, 1> b = t * x;
+  matrix<double, 1> c = b;
+  assert(solve(t, b));
+  assert(max_error(b, x) < 1e-8);
+
+  assert(tridiagonal_solve(lower, diag, upper, c));
+  assert(max_error(c, x) < 1e-8);
+
+  // A strided right-hand side.
+  matrix<double, 2> m(n, 2);
+  m.col(1) = t * x;
+  auto col = m.col(1);
+  assert(tridiagonal_solve(lower, diag, upper, col));
+  assert(max_error(m.col(1), x) < 1e-8);
+
+  // A zero pivot.
+  matrix<double, 1> l1 {1.0}, d1 {1.0, 1.0}, u1 {1.0};
+  matrix<double, 1> r1 {1.0, 2.0};
+  assert(!tridiagonal_solve(l1, d1, u1, r1));
+}
+
+int main()
+{
+  test_symmetric();
+  test_triangular();
+  test_banded();
+  test_tridiagonal();
+}
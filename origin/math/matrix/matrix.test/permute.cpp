@@ -0,0 +1,116 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <iostream>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Tests for row and column exchanges and permutations.
+
+// Returns an m x n matrix whose (i, j)th element is 100 i + j, in the
+// layout l.
+matrix<int, 2> numbered(size_t m, size_t n, matrix_layout l = matrix_layout::row_major)
+{
+  matrix<int, 2> a(l, m, n);
+  for (size_t i = 0; i < m; ++i)
+    for (size_t j = 0; j < n; ++j)
+      a(i, j) = 100 * i + j;
+  return a;
+}
+
+// Returns true if row i of a is the original row r[i] and column j is the
+// original column c[j] of a numbered matrix.
+template <typename M>
+  bool permuted(const M& a, const vector<size_t>& r, const vector<size_t>& c)
+  {
+    for (size_t i = 0; i < a.rows(); ++i)
+      for (size_t j = 0; j < a.cols(); ++j)
+        if (a(i, j) != int(100 * r[i] + c[j]))
+          return false;
+    return true;
+  }
+
+vector<size_t> identity(size_t n)
+{
+  vector<size_t> p(n);
+  for (size_t i = 0; i < n; ++i)
+    p[i] = i;
+  return p;
+}
+
+void test_swap()
+{
+  for (auto l : {matrix_layout::row_major, matrix_layout::column_major}) {
+    matrix<int, 2> a = numbered(4, 5, l);
+    a.swap_rows(1, 3);
+    a.swap_cols(0, 4);
+    a.swap_rows(2, 2);
+    assert(permuted(a, {0, 3, 2, 1}, {4, 1, 2, 3, 0}));
+  }
+
+  // Rows of a 3D matrix.
+  matrix<int, 3> b(3, 2, 2);
+  iota(b.begin(), b.end(), 0);
+  b.swap_rows(0, 2);
+  assert(b(0, 0, 0) == 8 && b(0, 1, 1) == 11);
+  assert(b(2, 0, 0) == 0 && b(2, 1, 1) == 3);
+
+  // A submatrix.
+  matrix<int, 2> c = numbered(6, 6);
+  auto s = c(slice(1, 4), slice(2, 3));
+  s.swap_rows(0, 3);
+  s.swap_cols(0, 2);
+  assert(c(1, 2) == 404 && c(4, 4) == 102);
+  assert(c(1, 4) == 402 && c(4, 2) == 104);
+  assert(c(0, 2) == 2 && c(5, 5) == 505);
+}
+
+void test_permute()
+{
+  // A permutation with cycles of length 1, 2 and 3.
+  const vector<size_t> p {2, 0, 1, 3, 5, 4};
+  const vector<size_t> q {1, 2, 3, 4, 5, 6, 0};
+  for (auto l : {matrix_layout::row_major, matrix_layout::column_major}) {
+    matrix<int, 2> a = numbered(6, 7, l);
+    a.permute_rows(p);
+    assert(permuted(a, p, identity(7)));
+    a.permute_cols(q);
+    assert(permuted(a, p, q));
+
+    matrix<int, 2> b = numbered(6, 7, l);
+    b.permute_rows(identity(6));
+    assert(permuted(b, identity(6), identity(7)));
+  }
+
+  // Permuting a submatrix does not change the rest of the matrix.
+  matrix<int, 2> c = numbered(8, 8);
+  auto s = c(slice(1, 6), slice(1, 7));
+  s.permute_rows(p);
+  s.permute_cols(q);
+  for (size_t i = 0; i < 6; ++i)
+    for (size_t j = 0; j < 7; ++j)
+      assert(c(i + 1, j + 1) == int(100 * (p[i] + 1) + q[j] + 1));
+  for (size_t k = 0; k < 8; ++k) {
+    assert(c(0, k) == int(k) && c(k, 0) == int(100 * k));
+    assert(c(7, k) == int(700 + k));
+  }
+
+  // A transposed view permutes the other dimension.
+  matrix<int, 2> d = numbered(6, 7);
+  auto t = transpose(d);
+  t.permute_cols(p);
+  assert(permuted(d, p, identity(7)));
+}
+
+int main()
+{
+  test_swap();
+  test_permute();
+}
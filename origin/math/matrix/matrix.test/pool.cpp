@@ -0,0 +1,110 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <iostream>
+#include <thread>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Tests for the matrix buffer pool.
+
+// A static pooled matrix is destroyed after the pool of the main thread.
+pooled_matrix<double, 2> global(100, 100);
+
+void test_size_classes()
+{
+  using pool = matrix_impl::buffer_pool;
+  assert(pool::size_class(100) == 0);
+  assert(pool::size_class(4096) == 12);
+  assert(pool::size_class(4097) == 13);
+  assert(pool::size_class(1 << 20) == 20);
+}
+
+void test_reuse()
+{
+  matrix_pool_release();
+  const matrix_pool_stats s0 = matrix_pool_statistics();
+  assert(s0.buffers_retained == 0 && s0.bytes_retained == 0);
+
+  pooled_matrix<double, 2> a(500, 500);
+  a = 1.0;
+  for (int i = 0; i < 10; ++i) {
+    pooled_matrix<double, 2> t = a * 2.0;
+    static_assert(std::is_same<decltype(a * 2.0), pooled_matrix<double, 2>>::value, "");
+    assert(t(3, 4) == 2.0);
+  }
+
+  // The first temporary allocates, and the others reuse its buffer.
+  const matrix_pool_stats s1 = matrix_pool_statistics();
+  assert(s1.allocations - s0.allocations == 11);
+  assert(s1.hits - s0.hits == 9);
+  assert(s1.buffers_retained == 1);
+  assert(s1.bytes_retained == (1 << 21));
+  assert(s1.hit_rate() > 0);
+
+  // Pooled matrices mix with ordinary matrices and views.
+  matrix<double, 2> b(500, 500);
+  b = 3.0;
+  pooled_matrix<double, 2> c = a + b;
+  assert(c(499, 499) == 4.0);
+  matrix<double, 2> d = transpose(c);
+  assert(d == c);
+  pooled_matrix<double, 2> f = c - 1.5;
+  assert(f(0, 0) == 2.5 && f(499, 499) == 2.5);
+
+  // Broadcast views of pooled matrices.
+  pooled_matrix<double, 1> r(500);
+  r = 2.0;
+  matrix_ref<const double, 2> g = broadcast(r, std::array<std::size_t, 2>{{3, 500}});
+  assert(g(2, 499) == 2.0);
+
+  // Small matrices are not pooled.
+  const std::size_t n = matrix_pool_statistics().allocations;
+  pooled_matrix<double, 2> e(4, 4);
+  assert(matrix_pool_statistics().allocations == n);
+
+  matrix_pool_release();
+  assert(matrix_pool_statistics().bytes_retained == 0);
+}
+
+void test_limit()
+{
+  matrix_pool_release();
+  matrix_pool_limit(1 << 20);
+  {
+    pooled_matrix<double, 2> a(500, 500);  // 2 MiB, over the limit
+  }
+  assert(matrix_pool_statistics().buffers_retained == 0);
+  matrix_pool_limit(std::size_t(1) << 28);
+}
+
+void test_threads()
+{
+  // Each thread has its own pool.
+  {
+    pooled_matrix<float, 1> a(10000);
+  }
+  const std::size_t n = matrix_pool_statistics().buffers_retained;
+  std::thread t([]() {
+    assert(matrix_pool_statistics().allocations == 0);
+    pooled_matrix<float, 1> b(10000);
+    assert(matrix_pool_statistics().allocations == 1);
+  });
+  t.join();
+  assert(matrix_pool_statistics().buffers_retained == n);
+}
+
+int main()
+{
+  test_size_classes();
+  test_reuse();
+  test_limit();
+  test_threads();
+}
@@ -0,0 +1,171 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Tests for reduced precision element types and widening products.
+
+void test_bfloat16()
+{
+  assert(float(bfloat16(1.0f)) == 1.0f);
+  assert(float(bfloat16(-2.5f)) == -2.5f);
+  assert(bfloat16(1.0f).to_bits() == 0x3f80);
+  assert(float(bfloat16()) == 0.0f);
+
+  // Rounding to nearest, ties to even: 1 + 2^-8 is halfway between 1 and
+  // 1 + 2^-7.
+  assert(float(bfloat16(1.0f + 1.0f / 256)) == 1.0f);
+  assert(float(bfloat16(1.0f + 3.0f / 256)) == 1.0f + 4.0f / 256);
+  assert(float(bfloat16(1.0f + 1.0f / 200)) == 1.0f + 1.0f / 128);
+
+  const float inf = numeric_limits<float>::infinity();
+  assert(float(bfloat16(inf)) == inf);
+  assert(float(bfloat16(numeric_limits<float>::max())) == inf);
+  assert(std::isnan(float(bfloat16(numeric_limits<float>::quiet_NaN()))));
+}
+
+void test_half()
+{
+  assert(float(half(1.0f)) == 1.0f);
+  assert(half(1.0f).to_bits() == 0x3c00);
+  assert(half(-2.0f).to_bits() == 0xc000);
+  assert(float(half(65504.0f)) == 65504.0f);
+  assert(half(65504.0f).to_bits() == 0x7bff);
+
+  // Overflow.
+  const float inf = numeric_limits<float>::infinity();
+  assert(float(half(65520.0f)) == inf);
+  assert(float(half(-1e6f)) == -inf);
+  assert(float(half(65519.0f)) == 65504.0f);
+  assert(std::isnan(float(half(numeric_limits<float>::quiet_NaN()))));
+
+  // Ties to even: 1 + 2^-11 is halfway between 1 and 1 + 2^-10.
+  assert(float(half(1.0f + 1.0f / 2048)) == 1.0f);
+  assert(float(half(1.0f + 3.0f / 2048)) == 1.0f + 4.0f / 2048);
+
+  // Subnormals.
+  const float tiny = std::ldexp(1.0f, -24);
+  assert(half(tiny).to_bits() == 0x0001);
+  assert(float(half(tiny * 3)) == tiny * 3);
+  assert(float(half(-tiny * 1023)) == -tiny * 1023);
+  assert(half(tiny / 2).to_bits() == 0x0000);
+  assert(half(std::ldexp(1.0f, -14)).to_bits() == 0x0400);
+
+  // Every finite half converts to float and back exactly.
+  for (unsigned b = 0; b != 0x10000; ++b) {
+    if ((b & 0x7c00) == 0x7c00)
+      continue;
+    half h = half::from_bits(b);
+    assert(half(float(h)).to_bits() == b || (b == 0x8000 && float(h) == 0));
+  }
+}
+
+// Fill m with the values f(0), f(1), ... converted to its element type.
+template <typename M, typename F>
+  void fill(M& m, F f)
+  {
+    using T = Value_type<M>;
+    unsigned x = 0;
+    for (auto& e : m)
+      e = T(f(x++));
+  }
+
+// Returns a copy of m whose elements are converted to T.
+template <typename T, typename M>
+  matrix<T, 2> widen(const M& m)
+  {
+    matrix<T, 2> r(m.extent(0), m.extent(1));
+    for (size_t i = 0; i < m.extent(0); ++i)
+      for (size_t j = 0; j < m.extent(1); ++j)
+        r(i, j) = T(m(i, j));
+    return r;
+  }
+
+template <typename T>
+  void test_float_product()
+  {
+    auto f = [](unsigned x) { return float(int(x * 37 % 101) - 50) / 16.0f; };
+    matrix<T, 2> a(70, 300);
+    matrix<T, 2> b(300, 90);
+    fill(a, f);
+    fill(b, [&](unsigned x) { return f(x * 3 + 1); });
+
+    // The widening product equals the single precision product of the
+    // converted operands.
+    matrix<float, 2> c(70, 90);
+    matrix_product(a, b, c);
+    matrix<float, 2> expect(70, 90);
+    matrix_product(widen<float>(a), widen<float>(b), expect);
+    assert(c == expect);
+
+    // Transposed operands.
+    matrix<float, 2> ct(90, 70);
+    matrix_product(transpose(b), transpose(a), ct);
+    assert(ct == transpose(expect));
+
+    // Narrow results are rounded once, after accumulation.
+    matrix<T, 2> n(70, 90);
+    matrix_product(a, b, n);
+    for (size_t i = 0; i < 70; ++i)
+      for (size_t j = 0; j < 90; ++j)
+        assert(float(n(i, j)) == float(T(expect(i, j))));
+  }
+
+void test_int8_product()
+{
+  matrix<int8_t, 2> a(40, 1000);
+  matrix<int8_t, 2> b(1000, 50);
+  fill(a, [](unsigned x) { return int(x * 97 % 256) - 128; });
+  fill(b, [](unsigned x) { return int(x * 61 % 255) - 127; });
+
+  matrix<int32_t, 2> c(40, 50);
+  matrix_product(a, b, c);
+  matrix<int32_t, 2> expect(40, 50);
+  matrix_product(widen<int32_t>(a), widen<int32_t>(b), expect);
+  assert(c == expect);
+
+  // The products of extreme values would overflow 16 bits.
+  matrix<int8_t, 2> x(1, 1000);
+  matrix<int8_t, 2> y(1000, 1);
+  fill(x, [](unsigned) { return -128; });
+  fill(y, [](unsigned) { return -128; });
+  matrix<int32_t, 2> z(1, 1);
+  matrix_product(x, y, z);
+  assert(z(0, 0) == 16384000);
+
+  // Unsigned operands.
+  matrix<uint8_t, 2> u(3, 400);
+  matrix<uint8_t, 2> v(400, 2);
+  fill(u, [](unsigned) { return 255; });
+  fill(v, [](unsigned) { return 255; });
+  matrix<uint32_t, 2> w(3, 2);
+  matrix_product(u, v, w);
+  assert(w(2, 1) == 255u * 255u * 400u);
+}
+
+int main()
+{
+  static_assert(sizeof(bfloat16) == 2, "");
+  static_assert(sizeof(half) == 2, "");
+  static_assert(Same<Accumulator_type<half>, float>(), "");
+  static_assert(Same<Accumulator_type<const int8_t>, int32_t>(), "");
+  static_assert(Same<Accumulator_type<double>, double>(), "");
+
+  test_bfloat16();
+  test_half();
+  test_float_product<bfloat16>();
+  test_float_product<half>();
+  test_int8_product();
+}
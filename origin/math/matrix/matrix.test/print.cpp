@@ -0,0 +1,100 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Tests for matrix output.
+
+template <typename T>
+  string str(const T& x)
+  {
+    ostringstream ss;
+    ss << x;
+    return ss.str();
+  }
+
+void test_nested()
+{
+  matrix<int, 2> m {
+    {1, -2, 3},
+    {4, 5, -6}
+  };
+  assert(str(m) == "[[1,-2,3],[4,5,-6]]");
+  assert(str(m[1]) == "[4,5,-6]");
+  assert(str(transpose(m)) == "[[1,4],[-2,5],[3,-6]]");
+
+  matrix<double, 1> d {0.5, 1.0 / 3, 1e20, -0.0};
+  assert(str(d) == "[0.5,0.333333,1e+20,-0]");
+
+  matrix<unsigned long long, 1> u {18446744073709551615ull, 0};
+  assert(str(u) == "[18446744073709551615,0]");
+
+  matrix<long long, 1> l {-9223372036854775807ll - 1};
+  assert(str(l) == "[-9223372036854775808]");
+
+  matrix<int, 3> e(2, 0, 3);
+  assert(str(e) == "[[],[]]");
+}
+
+void test_pretty()
+{
+  matrix<int, 2> m {
+    {1, 2},
+    {3, 4}
+  };
+  assert(str(pretty(m)) == "[\n [1,2],\n [3,4]\n]");
+
+  matrix<int, 3> c(2, 1, 2);
+  iota(c.begin(), c.end(), 0);
+  assert(str(pretty(c)) == "[\n [\n  [0,1]\n],\n [\n  [2,3]\n]\n]");
+}
+
+// Streams with non-default formatting insert each element.
+void test_formatted()
+{
+  matrix<double, 1> d {0.5, 2};
+  ostringstream ss;
+  ss << fixed << setprecision(2) << d;
+  assert(ss.str() == "[0.50,2.00]");
+
+  ostringstream sp;
+  sp << setprecision(3) << matrix<double, 1> {3.14159, 2};
+  assert(sp.str() == "[3.14,2]");
+
+  matrix<char, 1> c {'a', 'b'};
+  assert(str(c) == "[a,b]");
+
+  wostringstream ws;
+  ws << matrix<int, 1> {1, 2};
+  assert(ws.str() == L"[1,2]");
+}
+
+// Large matrices are written in several blocks.
+void test_large()
+{
+  matrix<int, 2> m(1000, 100);
+  iota(m.begin(), m.end(), 0);
+  string s = str(m);
+  assert(s.size() > (1 << 14));
+  assert(s.compare(0, 10, "[[0,1,2,3,") == 0);
+  assert(s.compare(s.size() - 8, 8, ",99999]]") == 0);
+}
+
+int main()
+{
+  test_nested();
+  test_pretty();
+  test_formatted();
+  test_large();
+}
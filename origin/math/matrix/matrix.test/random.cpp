@@ -0,0 +1,152 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cmath>
+#include <iostream>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Tests for the random fills.
+
+void test_uniform()
+{
+  matrix<double, 2> a(300, 400);
+  fill_uniform(a, 42);
+  double sum = 0;
+  for (double x : a) {
+    assert(0 <= x && x < 1);
+    sum += x;
+  }
+  assert(std::abs(sum / a.size() - 0.5) < 0.01);
+
+  // The kth element in row-major order is the kth value of the generator.
+  for (size_t k : {0, 1, 399, 400, 119999})
+    assert(a(k / 400, k % 400) == matrix_impl::counter_uniform(42, k));
+
+  // The same seed gives the same matrix, and another seed another matrix.
+  matrix<double, 2> b(300, 400);
+  fill_uniform(b, 42);
+  assert(a == b);
+  fill_uniform(b, 43);
+  assert(a != b);
+
+  // The interval is respected.
+  matrix<float, 1> c(1000);
+  fill_uniform(c, 1, -2.0f, -1.0f);
+  for (float x : c)
+    assert(-2 <= x && x < -1);
+
+  // Values that round up to hi are replaced by the largest value below it.
+  // The floats near 1e8 are 8 apart, so about half of the values would
+  // otherwise be hi.
+  fill_uniform(c, 1, 1e8f, 1e8f + 8);
+  for (float x : c)
+    assert(x == 1e8f);
+}
+
+void test_deterministic()
+{
+  // Filling in chunks of any size gives the same result as filling the
+  // whole matrix, so the result does not depend on the number of threads.
+  matrix<double, 3> a(7, 11, 13);
+  fill_uniform(a, 5);
+  auto f = [](size_t k) { return matrix_impl::counter_uniform(5, k); };
+  for (size_t chunk : {1, 10, 97, 1001}) {
+    matrix<double, 3> b(7, 11, 13);
+    for (size_t k = 0; k < b.size(); k += chunk)
+      matrix_impl::random_fill(b.data(), b.descriptor(), k, std::min(k + chunk, b.size()), f);
+    assert(a == b);
+  }
+
+  // The layout does not change the values.
+  matrix<double, 2> r(50, 60);
+  matrix<double, 2> c(matrix_layout::column_major, 50, 60);
+  fill_normal(r, 9);
+  fill_normal(c, 9);
+  for (size_t i = 0; i < 50; ++i)
+    for (size_t j = 0; j < 60; ++j)
+      assert(r(i, j) == c(i, j));
+
+  // Neither does filling a submatrix, whose elements are indexed from 0.
+  matrix<double, 2> big(100, 100);
+  auto s = big(slice(10, 50), slice(20, 60));
+  fill_normal(s, 9);
+  for (size_t i = 0; i < 50; ++i)
+    for (size_t j = 0; j < 60; ++j)
+      assert(s(i, j) == r(i, j));
+  assert(big(0, 0) == 0 && big(99, 99) == 0);
+}
+
+void test_normal()
+{
+  matrix<double, 1> a(200000);
+  fill_normal(a, 3, 1.0, 2.0);
+  double sum = 0, sq = 0;
+  for (double x : a) {
+    sum += x;
+    sq += x * x;
+  }
+  const double mean = sum / a.size();
+  const double var = sq / a.size() - mean * mean;
+  assert(std::abs(mean - 1.0) < 0.02);
+  assert(std::abs(var - 4.0) < 0.05);
+}
+
+void test_sparse()
+{
+  matrix<double, 2> a(500, 500);
+  fill_sparse(a, 11, 0.1);
+  size_t nz = 0;
+  for (double x : a)
+    if (x != 0) {
+      assert(-1 <= x && x < 1);
+      ++nz;
+    }
+  assert(std::abs(nz / 250000.0 - 0.1) < 0.005);
+
+  fill_sparse(a, 11, 0.0);
+  for (double x : a)
+    assert(x == 0);
+}
+
+void test_generators()
+{
+  const size_t n = 120;
+  matrix<double, 2> d = random_diagonally_dominant<double>(n, 4);
+  matrix<double, 2> s = random_spd<double>(n, 4);
+  for (size_t i = 0; i < n; ++i) {
+    double rd = 0, rs = 0;
+    for (size_t j = 0; j < n; ++j) {
+      if (i != j) {
+        rd += std::abs(d(i, j));
+        rs += std::abs(s(i, j));
+        assert(s(i, j) == s(j, i));
+      }
+    }
+    assert(d(i, i) > rd && s(i, i) > rs);
+  }
+  assert(d != transpose(d));
+
+  // The eigenvalues of the symmetric matrix are positive.
+  matrix<double, 1> w;
+  assert(symmetric_eigenvalues(s, w));
+  assert(w(0) > 0);
+
+  assert(random_spd<double>(n, 4) == s);
+}
+
+int main()
+{
+  test_uniform();
+  test_deterministic();
+  test_normal();
+  test_sparse();
+  test_generators();
+}
@@ -0,0 +1,139 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cmath>
+#include <iostream>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Tests for reductions.
+
+void test_sum()
+{
+  matrix<int, 2> m {
+    {1, 2, 3},
+    {4, 5, 6}
+  };
+  assert(sum(m) == 21);
+  assert(mean(m) == 3);
+
+  matrix<int, 1> cols {5, 7, 9};
+  matrix<int, 1> rows {6, 15};
+  assert(sum(m, 0) == cols);
+  assert(sum(m, 1) == rows);
+
+  // Views are reduced in their logical order.
+  assert(sum(transpose(m), 0) == rows);
+  assert(sum(transpose(m), 1) == cols);
+  assert(sum(m[1]) == 15);
+  assert(sum(m(slice::all, 1)) == 7);
+
+  matrix<double, 2> d {
+    {1, 2},
+    {3, 5}
+  };
+  matrix<double, 1> means {2, 3.5};
+  assert(mean(d, 0) == means);
+  assert(norm2(d) == sqrt(39.0));
+  matrix<double, 1> norms {sqrt(5.0), sqrt(34.0)};
+  assert(norm2(d, 1) == norms);
+}
+
+void test_sum_3d()
+{
+  matrix<int, 3> m(3, 4, 5);
+  iota(m.begin(), m.end(), 0);
+  for (size_t axis = 0; axis < 3; ++axis) {
+    matrix<int, 2> s = sum(m, axis);
+    assert(s.size() == m.size() / m.extent(axis));
+    for (size_t i = 0; i < 3; ++i)
+      for (size_t j = 0; j < 4; ++j)
+        for (size_t k = 0; k < 5; ++k) {
+          size_t idx[] {i, j, k};
+          if (idx[axis] != 0)
+            continue;
+          int expect = 0;
+          for (size_t n = 0; n < m.extent(axis); ++n) {
+            idx[axis] = n;
+            expect += m(idx[0], idx[1], idx[2]);
+          }
+          size_t a = axis == 0 ? j : i;
+          size_t b = axis == 2 ? j : k;
+          assert(s(a, b) == expect);
+        }
+  }
+  assert(sum(m) == 59 * 60 / 2);
+}
+
+// A compensated sum recovers values that a naive sum loses entirely.
+void test_accuracy()
+{
+  const size_t n = 1 << 20;
+  matrix<double, 1> v(n + 1);
+  v(0) = 1.0;
+  for (size_t i = 1; i <= n; ++i)
+    v(i) = 1e-16;
+
+  double naive = accumulate(v.begin(), v.end(), 0.0);
+  assert(naive == 1.0);
+
+  double s = sum(v);
+  double expect = 1.0 + n * 1e-16;
+  assert(abs(s - expect) < 1e-14);
+
+  // The same elements as the columns of a matrix, reduced along rows.
+  matrix<double, 2> m(n / 1024, 1024);
+  fill(m.begin(), m.end(), 0.1);
+  matrix<double, 1> c = sum(m, 0);
+  for (double x : c)
+    assert(abs(x - 0.1 * (n / 1024)) < 1e-12);
+  assert(abs(sum(m) - 0.1 * n) < 1e-9);
+}
+
+void test_extrema()
+{
+  matrix<int, 2> m {
+    {3, 9, 1, 9},
+    {7, 2, 8, 0},
+    {5, 9, 4, 6}
+  };
+  const matrix<int, 2>& cm = m;
+  assert(min(m) == 0);
+  assert(max(cm) == 9);
+  assert(argmin(m) == 7);
+  assert(argmax(m) == 1);
+
+  matrix<int, 1> cmax {7, 9, 8, 9};
+  assert(max(m, 0) == cmax);
+  matrix<size_t, 1> carg = argmax(m, 0);
+  assert(carg(0) == 1 && carg(1) == 0 && carg(2) == 1 && carg(3) == 0);
+
+  matrix<int, 1> rmin {1, 0, 4};
+  assert(min(m, 1) == rmin);
+  matrix<size_t, 1> rarg = argmin(m, 1);
+  assert(rarg(0) == 2 && rarg(1) == 3 && rarg(2) == 2);
+
+  // Large reductions are split across threads. Ties select the first.
+  matrix<double, 1> v(1 << 20);
+  for (size_t i = 0; i < v.size(); ++i)
+    v(i) = double(i % 1000);
+  assert(max(v) == 999);
+  assert(argmax(v) == 999);
+  v(123456) = -1;
+  assert(argmin(v) == 123456);
+}
+
+int main()
+{
+  test_sum();
+  test_sum_3d();
+  test_accuracy();
+  test_extrema();
+}
@@ -5,7 +5,7 @@
 // LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
 // and conditions.
 
-#include <random>
+#include <ctime>
 #include <stdexcept>
 #include <chrono>
 
@@ -19,23 +19,21 @@ using Mat = matrix<double, 2>;
 using Vec = matrix<double, 1>;
 
 // Random numbers
-default_random_engine eng(time(0));
-// default_random_engine eng;
-uniform_real_distribution<> dist;
-auto rng = bind(ref(dist), ref(eng));
+uint64_t seed = time(0);
+// uint64_t seed = 0;
 
 
 Mat random_matrix(size_t n)
 {
   Mat r(n, n);
-  generate(r.begin(), r.end(), rng);
+  fill_uniform(r, seed++);
   return r;
 }
 
 Vec random_vector(size_t n)
 {
   Vec r(n);
-  generate(r.begin(), r.end(), rng);
+  fill_uniform(r, seed++);
   return r;
 }
 
@@ -63,11 +61,7 @@ dot_product(const M1& a, const M2& b)
 Vec 
 multiply(const Mat& A, const Vec& x)
 {
-  const size_t n = A.rows();
-  Vec r(n);
-  for (size_t i = 0; i < n; ++i)
-    r(i) = dot_product(A[i], x);
-  return r;
+  return A * x;
 }
 
 
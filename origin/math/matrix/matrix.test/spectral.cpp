@@ -0,0 +1,184 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cmath>
+#include <iostream>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Tests for the symmetric eigendecomposition and the SVD.
+
+// Returns the largest absolute difference between the 2D matrices a and b.
+template <typename M1, typename M2>
+  double max_error(const M1& a, const M2& b)
+  {
+    double e = 0;
+    for (size_t i = 0; i < a.rows(); ++i)
+      for (size_t j = 0; j < a.cols(); ++j)
+        e = std::max(e, std::abs(a(i, j) - b(i, j)));
+    return e;
+  }
+
+// Returns true if the columns of q are orthonormal.
+bool orthonormal(const matrix<double, 2>& q)
+{
+  matrix<double, 2> qtq(q.cols(), q.cols());
+  matrix_product(transpose(q), q, qtq);
+  matrix<double, 2> id(q.cols(), q.cols());
+  for (size_t i = 0; i < q.cols(); ++i)
+    id(i, i) = 1;
+  return max_error(qtq, id) < 1e-10;
+}
+
+// Returns the product u diag(s) v^T.
+matrix<double, 2> reconstruct(const matrix<double, 2>& u,
+                              const matrix<double, 1>& s,
+                              const matrix<double, 2>& v)
+{
+  matrix<double, 2> us = u;
+  for (size_t i = 0; i < us.rows(); ++i)
+    for (size_t j = 0; j < us.cols(); ++j)
+      us(i, j) *= s(j);
+  matrix<double, 2> a(u.rows(), v.rows());
+  matrix_product(us, transpose(v), a);
+  return a;
+}
+
+// Returns an m x n matrix of arbitrary values.
+matrix<double, 2> make_matrix(size_t m, size_t n)
+{
+  matrix<double, 2> a(m, n);
+  for (size_t i = 0; i < m; ++i)
+    for (size_t j = 0; j < n; ++j)
+      a(i, j) = std::sin(double(i * i + 3 * j * j + i * j + 1));
+  return a;
+}
+
+void test_eigen()
+{
+  // The eigenvalues of this matrix are 2, 2 and 4.
+  matrix<double, 2> a {
+    {2.0, 0.0, 0.0},
+    {0.0, 3.0, 1.0},
+    {0.0, 1.0, 3.0}
+  };
+  matrix<double, 1> w;
+  matrix<double, 2> v;
+  assert(symmetric_eigen(a, w, v));
+  assert(std::abs(w(0) - 2) < 1e-12);
+  assert(std::abs(w(1) - 2) < 1e-12);
+  assert(std::abs(w(2) - 4) < 1e-12);
+  assert(orthonormal(v));
+
+  // A larger symmetric matrix: a v = v diag(w).
+  const size_t n = 40;
+  matrix<double, 2> b = make_matrix(n, n);
+  matrix<double, 2> s(n, n);
+  for (size_t i = 0; i < n; ++i)
+    for (size_t j = 0; j < n; ++j)
+      s(i, j) = b(i, j) + b(j, i);
+  assert(symmetric_eigen(s, w, v));
+  assert(orthonormal(v));
+  for (size_t i = 1; i < n; ++i)
+    assert(w(i - 1) <= w(i));
+  matrix<double, 2> sv(n, n);
+  matrix_product(s, v, sv);
+  matrix<double, 2> vw = v;
+  for (size_t i = 0; i < n; ++i)
+    for (size_t j = 0; j < n; ++j)
+      vw(i, j) *= w(j);
+  assert(max_error(sv, vw) < 1e-10);
+
+  // The eigenvalues alone, and from a packed symmetric matrix.
+  matrix<double, 1> w2;
+  assert(symmetric_eigenvalues(symmetric_matrix<double>(s), w2));
+  for (size_t i = 0; i < n; ++i)
+    assert(std::abs(w(i) - w2(i)) < 1e-10);
+
+  // Degenerate sizes.
+  assert(symmetric_eigen(matrix<double, 2>(0, 0), w, v));
+  assert(w.size() == 0);
+  assert(symmetric_eigen(matrix<double, 2>{{5.0}}, w, v));
+  assert(w(0) == 5 && v(0, 0) == 1);
+}
+
+void test_svd()
+{
+  // Tall, wide and square matrices.
+  for (auto ext : {make_pair(30, 12), make_pair(12, 30), make_pair(20, 20)}) {
+    matrix<double, 2> a = make_matrix(ext.first, ext.second);
+    matrix<double, 2> u, v;
+    matrix<double, 1> s;
+    assert(svd(a, u, s, v));
+    const size_t k = std::min(ext.first, ext.second);
+    assert(u.rows() == a.rows() && u.cols() == k);
+    assert(v.rows() == a.cols() && v.cols() == k);
+    for (size_t i = 1; i < k; ++i)
+      assert(s(i - 1) >= s(i));
+    assert(orthonormal(u));
+    assert(orthonormal(v));
+    assert(max_error(reconstruct(u, s, v), a) < 1e-10);
+  }
+
+  // A rank-1 matrix has one nonzero singular value.
+  matrix<double, 2> r(4, 3);
+  for (size_t i = 0; i < 4; ++i)
+    for (size_t j = 0; j < 3; ++j)
+      r(i, j) = double(i + 1) * double(j + 1);
+  matrix<double, 2> u, v;
+  matrix<double, 1> s;
+  assert(svd(r, u, s, v));
+  assert(std::abs(s(0) - std::sqrt(30.0 * 14.0)) < 1e-10);
+  assert(s(1) < 1e-10 && s(2) < 1e-10);
+  assert(max_error(reconstruct(u, s, v), r) < 1e-10);
+}
+
+void test_randomized_svd()
+{
+  // A tall matrix of rank 5: its top 5 singular values and the matrix
+  // itself are recovered exactly.
+  const size_t m = 300, n = 60, rank = 5;
+  matrix<double, 2> x = make_matrix(m, rank);
+  matrix<double, 2> y = make_matrix(rank, n);
+  matrix<double, 2> a(m, n);
+  matrix_product(x, y, a);
+
+  matrix<double, 2> u, v, ue, ve;
+  matrix<double, 1> s, se;
+  assert(randomized_svd(a, rank, u, s, v));
+  assert(svd(a, ue, se, ve));
+  assert(u.rows() == m && u.cols() == rank);
+  assert(v.rows() == n && v.cols() == rank);
+  for (size_t i = 0; i < rank; ++i)
+    assert(std::abs(s(i) - se(i)) < 1e-8 * se(0));
+  assert(orthonormal(u));
+  assert(orthonormal(v));
+  assert(max_error(reconstruct(u, s, v), a) < 1e-8 * se(0));
+
+  // For a matrix whose singular values decay, the leading singular values
+  // are approximated.
+  matrix<double, 2> xd = make_matrix(m, n);
+  for (size_t i = 0; i < m; ++i)
+    for (size_t j = 0; j < n; ++j)
+      xd(i, j) *= std::pow(0.5, double(j));
+  matrix<double, 2> b(m, n);
+  matrix_product(xd, make_matrix(n, n), b);
+  assert(svd(b, ue, se, ve));
+  assert(randomized_svd(b, 3, u, s, v, 10, 4));
+  for (size_t i = 0; i < 3; ++i)
+    assert(std::abs(s(i) - se(i)) < 1e-6 * se(0));
+}
+
+int main()
+{
+  test_eigen();
+  test_svd();
+  test_randomized_svd();
+}
@@ -0,0 +1,126 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cmath>
+#include <iostream>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Tests for fixed-size matrices.
+
+template <typename M1, typename M2>
+  bool approx_equal(const M1& a, const M2& b, double eps = 1e-9)
+  {
+    return equal(a.begin(), a.end(), b.begin(), [&](double x, double y) {
+      return abs(x - y) < eps;
+    });
+  }
+
+void test_init()
+{
+  static_matrix<int, 2, 3> m {
+    {0, 1, 2},
+    {3, 4, 5}
+  };
+  static_assert(Matrix<static_matrix<int, 2, 3>>(), "");
+  static_assert(sizeof(m) == 6 * sizeof(int), "");
+  assert(m.rows() == 2);
+  assert(m.cols() == 3);
+  assert(m.size() == 6);
+  assert(m(1, 2) == 5);
+  cout << m << '\n';
+  cout << pretty(m) << '\n';
+
+  static_matrix<int, 2, 2> z;
+  assert(all_match(z, 0));
+
+  // Interoperability with dynamic matrices.
+  matrix<int, 2> d = m;
+  assert(d == m);
+  static_matrix<int, 2, 3> s(d);
+  assert(s == m);
+
+  matrix_ref<int, 2> r = m;
+  r(0, 0) = 10;
+  assert(m(0, 0) == 10);
+  assert(m.row(1) == d.row(1));
+  assert(m.col(2) == d.col(2));
+}
+
+void test_ops()
+{
+  static_matrix<int, 2, 3> a {
+    {1, 2, 3},
+    {4, 5, 6}
+  };
+  static_matrix<int, 3, 2> b {
+    {7, 8},
+    {9, 10},
+    {11, 12}
+  };
+
+  // Compare against the dynamic product.
+  matrix<int, 2> da = a, db = b;
+  matrix<int, 2> dc = da * db;
+  static_matrix<int, 2, 2> c = a * b;
+  assert(c == dc);
+
+  assert(transpose(a) == b - b + transpose(a));
+  assert(transpose(transpose(a)) == a);
+
+  static_matrix<int, 2, 3> a2 = a + a;
+  assert(a2 == a * 2);
+  assert(a2 / 2 == a);
+}
+
+void test_inverse()
+{
+  static_matrix<double, 2, 2> m2 {
+    {4, 7},
+    {2, 6}
+  };
+  assert(abs(determinant(m2) - 10) < 1e-12);
+  assert(approx_equal(m2 * inverse(m2), identity_matrix<double, 2>()));
+
+  static_matrix<double, 3, 3> m3 {
+    {2, -1, 0},
+    {-1, 2, -1},
+    {0, -1, 2}
+  };
+  assert(abs(determinant(m3) - 4) < 1e-12);
+  assert(approx_equal(m3 * inverse(m3), identity_matrix<double, 3>()));
+
+  static_matrix<double, 4, 4> m4 {
+    {4, 1, 0, 2},
+    {1, 3, 1, 0},
+    {0, 1, 5, 1},
+    {2, 0, 1, 6}
+  };
+  static_matrix<double, 4, 4> t4 = m4;
+  static_matrix<double, 4, 1> v4;
+  double d4 = matrix_impl::static_eliminate(t4, v4);
+  assert(abs(determinant(m4) - d4) < 1e-9);
+  assert(approx_equal(m4 * inverse(m4), identity_matrix<double, 4>()));
+
+  // The general path is used for larger matrices.
+  static_matrix<double, 5, 5> m5;
+  for (size_t i = 0; i < 5; ++i)
+    for (size_t j = 0; j < 5; ++j)
+      m5(i, j) = i == j ? 10 : double(i + j) / 4;
+  assert(approx_equal(m5 * inverse(m5), identity_matrix<double, 5>()));
+  assert(abs(determinant(identity_matrix<double, 5>()) - 1) < 1e-12);
+}
+
+int main()
+{
+  test_init();
+  test_ops();
+  test_inverse();
+}
@@ -0,0 +1,203 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cmath>
+#include <iostream>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Tests for stencils.
+
+const stencil_boundary boundaries[] = {
+  stencil_boundary::zero,
+  stencil_boundary::clamp,
+  stencil_boundary::wrap,
+  stencil_boundary::reflect
+};
+
+bool close(double x, double y)
+{
+  return std::abs(x - y) < 1e-9;
+}
+
+// Returns the element x(i, j), or its boundary value.
+double at(const matrix<double, 2>& x, ptrdiff_t i, ptrdiff_t j, stencil_boundary b)
+{
+  ptrdiff_t m = x.rows(), n = x.cols();
+  auto fix = [b](ptrdiff_t k, ptrdiff_t n) -> ptrdiff_t {
+    if (0 <= k && k < n)
+      return k;
+    switch (b) {
+    case stencil_boundary::zero: return -1;
+    case stencil_boundary::clamp: return k < 0 ? 0 : n - 1;
+    case stencil_boundary::wrap: return (k + 4 * n) % n;
+    case stencil_boundary::reflect:
+      while (k < 0 || k >= n)
+        k = k < 0 ? -k - 1 : 2 * n - k - 1;
+      return k;
+    }
+    return -1;
+  };
+  i = fix(i, m);
+  j = fix(j, n);
+  return i < 0 || j < 0 ? 0.0 : x(i, j);
+}
+
+// Apply s to x using the definition.
+template <size_t R>
+  matrix<double, 2> naive(const stencil<double, 2, R>& s,
+                          const matrix<double, 2>& x, stencil_boundary b)
+  {
+    const ptrdiff_t r = R;
+    matrix<double, 2> y(x.rows(), x.cols());
+    for (ptrdiff_t i = 0; i < ptrdiff_t(x.rows()); ++i)
+      for (ptrdiff_t j = 0; j < ptrdiff_t(x.cols()); ++j)
+        for (ptrdiff_t p = -r; p <= r; ++p)
+          for (ptrdiff_t q = -r; q <= r; ++q)
+            y(i, j) += s(p, q) * at(x, i + p, j + q, b);
+    return y;
+  }
+
+template <typename M1, typename M2>
+  bool all_close(const M1& a, const M2& b)
+  {
+    auto i = a.begin();
+    auto j = b.begin();
+    for ( ; i != a.end(); ++i, ++j)
+      if (!close(*i, *j))
+        return false;
+    return true;
+  }
+
+matrix<double, 2> make_matrix(size_t m, size_t n)
+{
+  matrix<double, 2> a(m, n);
+  for (size_t i = 0; i < m; ++i)
+    for (size_t j = 0; j < n; ++j)
+      a(i, j) = std::sin(double(i * i + 3 * j + 1));
+  return a;
+}
+
+void test_shapes()
+{
+  stencil<double, 2, 1> s;
+  s(0, 0) = -4;
+  s(-1, 0) = s(1, 0) = s(0, -1) = s(0, 1) = 1;
+  stencil<double, 2, 1> l = laplacian_stencil<double, 2>();
+  for (size_t k = 0; k < 9; ++k)
+    assert(s.data()[k] == l.data()[k]);
+
+  stencil<double, 2, 1> t {1, 2, 3, 4, 5, 6, 7, 8, 9};
+  assert(t(-1, -1) == 1 && t(0, 1) == 6 && t(1, 0) == 8);
+  assert(t.reflected()(-1, -1) == 9);
+
+  stencil<double, 3, 1> l3 = laplacian_stencil<double, 3>();
+  assert(l3(0, 0, 0) == -6 && l3(1, 0, 0) == 1 && l3(0, 0, -1) == 1);
+  assert(l3(1, 1, 0) == 0);
+  static_assert(stencil<double, 3, 2>::size == 125, "");
+}
+
+void test_apply()
+{
+  stencil<double, 2, 1> s {0.5, 1, -1, 2, -3, 0.25, 0, 1.5, -2};
+  stencil<double, 2, 2> big = box_stencil<double, 2, 2>();
+  big(-2, 1) = 3;
+  for (auto b : boundaries) {
+    for (auto ext : {make_pair(1, 1), make_pair(5, 7), make_pair(40, 600)}) {
+      matrix<double, 2> x = make_matrix(ext.first, ext.second);
+      matrix<double, 2> y(x.rows(), x.cols());
+      apply_stencil(s, x, y, b);
+      assert(all_close(y, naive(s, x, b)));
+      apply_stencil(big, x, y, b);
+      assert(all_close(y, naive(big, x, b)));
+
+      // Convolution applies the reflected stencil.
+      convolve(s, x, y, b);
+      assert(all_close(y, naive(s.reflected(), x, b)));
+
+      // In place.
+      matrix<double, 2> z = x;
+      apply_stencil(s, z, z, b);
+      assert(all_close(z, naive(s, x, b)));
+    }
+  }
+
+  // A transposed result.
+  matrix<double, 2> x = make_matrix(9, 12);
+  matrix<double, 2> y(12, 9);
+  auto yt = transpose(y);
+  apply_stencil(s, x, yt, stencil_boundary::clamp);
+  assert(all_close(transpose(y), naive(s, x, stencil_boundary::clamp)));
+}
+
+void test_dimensions()
+{
+  // 1D: a centered difference.
+  stencil<double, 1, 1> d {-0.5, 0, 0.5};
+  matrix<double, 1> v {1.0, 4.0, 9.0, 16.0, 25.0};
+  matrix<double, 1> dv(5);
+  apply_stencil(d, v, dv, stencil_boundary::clamp);
+  assert(dv(0) == 1.5 && dv(1) == 4 && dv(2) == 6 && dv(4) == 4.5);
+
+  // 3D: the Laplacian of a quadratic is constant in the interior.
+  matrix<double, 3> u(6, 7, 8);
+  for (size_t i = 0; i < 6; ++i)
+    for (size_t j = 0; j < 7; ++j)
+      for (size_t k = 0; k < 8; ++k)
+        u(i, j, k) = double(i * i + 2 * j * j + 3 * k * k);
+  matrix<double, 3> lu(6, 7, 8);
+  apply_stencil(laplacian_stencil<double, 3>(), u, lu);
+  for (size_t i = 1; i < 5; ++i)
+    for (size_t j = 1; j < 6; ++j)
+      for (size_t k = 1; k < 7; ++k)
+        assert(lu(i, j, k) == 12);
+  assert(lu(0, 0, 0) == -6 * u(0, 0, 0) + u(1, 0, 0) + u(0, 1, 0) + u(0, 0, 1));
+}
+
+void test_iterate()
+{
+  stencil<double, 2, 1> s {0.05, 0.1, 0.05, 0.1, 0.4, 0.1, 0.05, 0.1, 0.05};
+  for (auto b : boundaries) {
+    matrix<double, 2> x = make_matrix(300, 40);
+    matrix<double, 2> y = x;
+    iterate_stencil(s, x, 7, b);
+    iterate_stencil(s, y, 7, b, 3);
+    assert(all_close(x, y));
+
+    matrix<double, 2> z = make_matrix(300, 40);
+    for (int k = 0; k < 7; ++k)
+      z = naive(s, z, b);
+    assert(all_close(x, z));
+  }
+
+  // Temporal blocking with bands narrower than the halo, and in 1D.
+  matrix<double, 2> x = make_matrix(3000, 2000);
+  matrix<double, 2> y = x;
+  iterate_stencil(s, x, 5, stencil_boundary::wrap);
+  iterate_stencil(s, y, 5, stencil_boundary::wrap, 5);
+  assert(all_close(x, y));
+
+  stencil<double, 1, 2> d {0.1, 0.2, 0.4, 0.2, 0.1};
+  matrix<double, 1> v(1000);
+  for (size_t i = 0; i < 1000; ++i)
+    v(i) = std::sin(double(i * i));
+  matrix<double, 1> w = v;
+  iterate_stencil(d, v, 10, stencil_boundary::reflect);
+  iterate_stencil(d, w, 10, stencil_boundary::reflect, 4);
+  assert(all_close(v, w));
+}
+
+int main()
+{
+  test_shapes();
+  test_apply();
+  test_dimensions();
+  test_iterate();
+}
@@ -0,0 +1,140 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cmath>
+#include <iostream>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Tests for the Strassen-Winograd matrix product.
+
+// Fill m with a deterministic sequence of values in [-1, 1).
+template <typename M>
+  void fill(M& m, unsigned seed)
+  {
+    unsigned x = seed;
+    for (auto& e : m) {
+      x = x * 1103515245u + 12345u;
+      e = double((x >> 8) % 2048) / 1024.0 - 1.0;
+    }
+  }
+
+// Returns the largest absolute difference between elements of a and b.
+template <typename M1, typename M2>
+  double max_error(const M1& a, const M2& b)
+  {
+    double e = 0;
+    for (size_t i = 0; i < a.extent(0); ++i)
+      for (size_t j = 0; j < a.extent(1); ++j)
+        e = std::max(e, std::abs(a(i, j) - b(i, j)));
+    return e;
+  }
+
+// Compare the Strassen and classical products of an m x p and a p x n
+// matrix for a range of crossovers.
+void check(size_t m, size_t n, size_t p)
+{
+  matrix<double, 2> a(m, p);
+  matrix<double, 2> b(p, n);
+  fill(a, m * 7 + p);
+  fill(b, p * 11 + n);
+
+  matrix<double, 2> c(m, n);
+  matrix_product(a, b, c);
+
+  for (size_t k : {1, 2, 3, 8, 16}) {
+    matrix<double, 2> s(m, n);
+    matrix_product(a, b, s, strassen_mode(k));
+    assert(max_error(s, c) < 1e-12 * p);
+  }
+}
+
+void test_exact()
+{
+  // Integer products are exact.
+  matrix<int, 2> a {
+    {1, 2, 3, 4},
+    {5, 6, 7, 8},
+    {9, 10, 11, 12},
+    {13, 14, 15, 16}
+  };
+  matrix<int, 2> b {
+    {1, 0, 2, 0},
+    {0, 1, 0, 2},
+    {3, 0, 1, 0},
+    {0, 3, 0, 1}
+  };
+  matrix<int, 2> c(4, 4);
+  matrix_product(a, b, c);
+  matrix<int, 2> s(4, 4);
+  matrix_product(a, b, s, strassen_mode(1));
+  assert(s == c);
+
+  // The product is accumulated into the result.
+  matrix_product(a, b, s, strassen_mode(1));
+  assert(s == c * 2);
+}
+
+void test_shapes()
+{
+  check(16, 16, 16);
+  check(17, 17, 17);
+  check(31, 20, 9);
+  check(9, 33, 18);
+  check(40, 7, 65);
+}
+
+void test_views()
+{
+  // Transposed operands and a submatrix result.
+  matrix<double, 2> a(24, 19);
+  matrix<double, 2> b(21, 24);
+  fill(a, 1);
+  fill(b, 2);
+
+  matrix<double, 2> c(19, 21);
+  matrix_product(transpose(a), transpose(b), c);
+
+  matrix<double, 2> r(20, 22);
+  auto s = r(slice(1, 19), slice(0, 21));
+  matrix_product(transpose(a), transpose(b), s, strassen_mode(4));
+  assert(max_error(s, c) < 1e-12 * 24);
+  assert(r(0, 0) == 0 && r(19, 21) == 0);
+}
+
+void test_accuracy()
+{
+  // The error of a large product with several levels of recursion remains
+  // close to that of the classical product.
+  const size_t n = 300;
+  matrix<double, 2> a(n, n);
+  matrix<double, 2> b(n, n);
+  fill(a, 3);
+  fill(b, 4);
+
+  matrix<double, 2> c(n, n);
+  matrix_product(a, b, c);
+  matrix<double, 2> s(n, n);
+  matrix_product(a, b, s, strassen_mode(32));
+  assert(max_error(s, c) < 1e-11);
+
+  // The default crossover does not recurse for small products.
+  matrix<double, 2> d(n, n);
+  matrix_product(a, b, d, strassen_mode());
+  assert(max_error(d, c) < 1e-11);
+}
+
+int main()
+{
+  test_exact();
+  test_shapes();
+  test_views();
+  test_accuracy();
+}
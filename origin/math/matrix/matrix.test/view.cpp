@@ -0,0 +1,138 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <iostream>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Tests for transposed, permuted, diagonal and strided views.
+
+void test_transpose()
+{
+  matrix<int, 2> m {
+    {0, 1, 2},
+    {3, 4, 5}
+  };
+
+  auto t = transpose(m);
+  assert(t.rows() == 3);
+  assert(t.cols() == 2);
+  assert(t.data() == m.data());
+  for (size_t i = 0; i < m.rows(); ++i)
+    for (size_t j = 0; j < m.cols(); ++j)
+      assert(t(j, i) == m(i, j));
+  cout << t << '\n';
+
+  // Writing through the view writes the original.
+  t(2, 1) = 50;
+  assert(m(1, 2) == 50);
+
+  // Copying a view produces a row-major matrix.
+  matrix<int, 2> c = t;
+  assert(c == t);
+  assert(c.descriptor().strides[1] == 1);
+
+  assert(transpose(transpose(m)) == m);
+
+  const matrix<int, 2>& cm = m;
+  matrix_ref<const int, 2> ct = transpose(cm);
+  assert(ct(0, 1) == 3);
+}
+
+void test_permute()
+{
+  matrix<int, 3> m(2, 3, 4);
+  iota(m.begin(), m.end(), 0);
+
+  auto p = permute(m, {{2, 0, 1}});
+  assert(p.extent(0) == 4);
+  assert(p.extent(1) == 2);
+  assert(p.extent(2) == 3);
+  for (size_t i = 0; i < 2; ++i)
+    for (size_t j = 0; j < 3; ++j)
+      for (size_t k = 0; k < 4; ++k)
+        assert(p(k, i, j) == m(i, j, k));
+}
+
+void test_diagonal()
+{
+  matrix<int, 2> m {
+    {0, 1, 2, 3},
+    {4, 5, 6, 7},
+    {8, 9, 10, 11}
+  };
+  auto d = diagonal(m);
+  assert(d.size() == 3);
+  assert(d(0) == 0 && d(1) == 5 && d(2) == 10);
+  d += 100;
+  assert(m(1, 1) == 105);
+
+  // The diagonal of a submatrix starts at the submatrix.
+  auto s = diagonal(m(slice(1), slice(1)));
+  assert(s.size() == 2);
+  assert(s(0) == 105 && s(1) == 110);
+}
+
+void test_strided()
+{
+  matrix<int, 2> m {
+    {0, 1, 2, 3, 4},
+    {5, 6, 7, 8, 9},
+    {10, 11, 12, 13, 14}
+  };
+  auto s = strided(m, {{2, 2}});
+  matrix<int, 2> expect {
+    {0, 2, 4},
+    {10, 12, 14}
+  };
+  assert(same_extents(s, expect));
+  assert(s == expect);
+}
+
+void test_product()
+{
+  matrix<double, 2> a {
+    {1, 2, 3},
+    {4, 5, 6}
+  };
+  matrix<double, 2> b {
+    {1, 4},
+    {2, 5},
+    {3, 6}
+  };
+  matrix<double, 2> bt {
+    {1, 2, 3},
+    {4, 5, 6}
+  };
+  matrix<double, 2> expect = a * b;
+
+  // Multiplying by a transposed view uses the dot product kernel.
+  matrix<double, 2> r1(2, 2);
+  matrix_product(a, transpose(bt), r1);
+  assert(r1 == expect);
+
+  matrix<double, 2> r2 = a * transpose(bt);
+  assert(r2 == expect);
+
+  // Products of transposed left operands.
+  matrix<double, 2> r3(2, 2);
+  matrix_product(transpose(b), b, r3);
+  matrix<double, 2> at = transpose(b);
+  assert(r3 == at * b);
+}
+
+int main()
+{
+  test_transpose();
+  test_permute();
+  test_diagonal();
+  test_strided();
+  test_product();
+}
@@ -8,12 +8,32 @@
 #ifndef ORIGIN_SEQUENCE_ALGORITHM_HPP
 #define ORIGIN_SEQUENCE_ALGORITHM_HPP
 
+#include <cstdint>
+#include <cstring>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 #include "concepts.hpp"
 
 namespace origin
 {
+// Thread pool and execution policies
+#include "algorithm.impl/execution.hpp"
+
+// Vectorized kernels
+#include "algorithm.impl/simd.hpp"
+
   // ------------------------------------------------------------------------ //
   //                                                                [algo.quant]
   //                              Quantifiers
@@ -237,7 +257,7 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      std::for_each(begin(range), end(range), f);
+      return std::for_each(begin(range), end(range), f);
     }
 
 
@@ -254,7 +274,9 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      return std::find(begin(range), end(range), value);
+      using I = Iterator_of<R>;
+      return sequence_impl::find(sequence_impl::Simd_tag<I, T>(), 
+                                 begin(range), end(range), value);
     }
 
 
@@ -394,7 +416,9 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      return std::count(begin(range), end(range), value);
+      using I = Iterator_of<const R>;
+      return sequence_impl::count(sequence_impl::Simd_tag<I, T>(),
+                                  begin(range), end(range), value);
     }
 
   template <typename R, typename P>
@@ -418,11 +442,14 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      return std::mismatch(begin(range1), end(range1), begin(range2));
+      using I1 = Iterator_of<R1>;
+      using I2 = Iterator_of<R2>;
+      return sequence_impl::mismatch(sequence_impl::Simd_mismatch_tag<I1, I2>(),
+                                     begin(range1), end(range1), begin(range2));
     }
 
   template <typename R1, typename R2, typename C>
-    inline std::pair<Iterator_of<R1>, Iterator_of<R2>>
+    inline Requires<!Execution_policy<R1>(), std::pair<Iterator_of<R1>, Iterator_of<R2>>>
     range_mismatch(R1&& range1, R2&& range2, C comp)
     {
       using std::begin;
@@ -443,11 +470,14 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      return std::equal(begin(range1), end(range1), begin(range2));
+      using I1 = Iterator_of<const R1>;
+      using I2 = Iterator_of<const R2>;
+      return sequence_impl::equal(sequence_impl::Simd_equal_tag<I1, I2>(),
+                                  begin(range1), end(range1), begin(range2));
     }
 
   template <typename R1, typename R2, typename C>
-    inline bool
+    inline Requires<!Execution_policy<R1>(), bool>
     range_equal(const R1& range1, const R2& range2, C comp)
     {
       using std::begin;
@@ -610,7 +640,7 @@ namespace origin
     }
 
   template <typename R1, typename R2, typename R3, typename Op>
-    inline Iterator_of<R3>
+    inline Requires<!Execution_policy<R1>(), Iterator_of<R3>>
     range_transform(const R1& range1, const R2& range2, R3&& range3, Op op)
     {
       using std::begin;
@@ -888,7 +918,7 @@ namespace origin
   // that iterators must the same, then this won't work without a lot of
   // enable-if'ing.
   template <typename R, typename C>
-    inline void
+    inline Requires<!Execution_policy<R>(), void>
     sort(R&& range, C comp)
     {
       using std::begin;
@@ -906,7 +936,7 @@ namespace origin
     }
 
   template <typename R, typename C>
-    inline void
+    inline Requires<!Execution_policy<R>(), void>
     stable_sort(R&& range, C comp)
     {
       using std::begin;
@@ -1323,7 +1353,9 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      return std::min_element(begin(range), end(range));
+      using I = Iterator_of<R>;
+      return sequence_impl::min_element(sequence_impl::Simd_minmax_tag<I>(),
+                                        begin(range), end(range));
     }
 
   template <typename R, typename C>
@@ -1341,7 +1373,9 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      return std::max_element(begin(range), end(range));
+      using I = Iterator_of<R>;
+      return sequence_impl::max_element(sequence_impl::Simd_minmax_tag<I>(),
+                                        begin(range), end(range));
     }
 
   template <typename R, typename C>
@@ -1359,7 +1393,9 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      return std::minmax_element(begin(range), end(range));
+      using I = Iterator_of<R>;
+      return sequence_impl::minmax_element(sequence_impl::Simd_minmax_tag<I>(),
+                                           begin(range), end(range));
     }
 
   template <typename R, typename C>
@@ -1386,7 +1422,8 @@ namespace origin
       return *min_element(range);
     }
 
-  template <typename R, typename C>
+  template <typename R, typename C,
+            typename = Requires<Relation<C, Value_type<Iterator_of<R>>>()>>
     inline auto
     min(R&& range, C comp) -> decltype(*min_element(range, comp))
     {
@@ -1400,11 +1437,12 @@ namespace origin
       return *max_element(range);
     }
 
-  template <typename R, typename C>
+  template <typename R, typename C,
+            typename = Requires<Relation<C, Value_type<Iterator_of<R>>>()>>
     inline auto
     max(R&& range, C comp) -> decltype(*max_element(range, comp))
     {
-      return *max_element(range);
+      return *max_element(range, comp);
     }
 
   template <typename R>
@@ -1490,6 +1528,12 @@ namespace origin
       return std::prev_permutation(begin(range), end(range), comp);
     }
 
+
+// Algorithms with execution policies
+#include "algorithm.impl/parallel.hpp"
+#include "algorithm.impl/sort.hpp"
+#include "algorithm.impl/radix.hpp"
+
 } // namespace origin
 
 #endif
@@ -0,0 +1,465 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_SEQUENCE_ALGORITHM_HPP
+#  error Do not include this file directly. Include sequence/algorithm.hpp.
+#endif
+
+  // ------------------------------------------------------------------------ //
+  //                                                                 [algo.pool]
+  //                              Thread Pool
+  //
+  // The thread pool runs the tasks of the parallel algorithms. Each worker
+  // thread owns a queue of tasks. A worker takes tasks from the back of its
+  // own queue and, when that is empty, steals them from the front of the
+  // queues of the other workers. Tasks submitted by a worker are pushed onto
+  // its own queue; tasks submitted by any other thread are dealt to the
+  // queues in turn.
+  //
+  // A pool without workers runs each task as soon as it is submitted.
+  class thread_pool
+  {
+    using task = std::function<void()>;
+
+    struct task_queue
+    {
+      std::mutex lock;
+      std::deque<task> tasks;
+    };
+
+    // Identifies the pool and queue of the calling worker thread.
+    struct worker_id
+    {
+      const thread_pool* pool;
+      std::size_t index;
+    };
+
+  public:
+    // Construct a pool with n worker threads.
+    explicit thread_pool(std::size_t n)
+      : queues_(n), pending_(0), next_(0), done_(false)
+    {
+      for (auto& q : queues_)
+        q.reset(new task_queue);
+      workers_.reserve(n);
+      for (std::size_t i = 0; i < n; ++i)
+        workers_.emplace_back([this, i]() { work(i); });
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    // Run the remaining tasks and join the workers.
+    ~thread_pool()
+    {
+      {
+        std::lock_guard<std::mutex> g(lock_);
+        done_ = true;
+      }
+      ready_.notify_all();
+      for (auto& w : workers_)
+        w.join();
+    }
+
+    // Returns the number of worker threads.
+    std::size_t size() const { return workers_.size(); }
+
+    // Queue the function f to be run by some thread of the pool.
+    template <typename F>
+      void
+      submit(F f)
+      {
+        if (queues_.empty()) {
+          f();
+          return;
+        }
+        const worker_id& self = current();
+        const std::size_t i = self.pool == this ? self.index
+                                                : next_++ % queues_.size();
+
+        // Count the task before it can be taken, so that the count never
+        // falls below the number of queued tasks.
+        ++pending_;
+        {
+          std::lock_guard<std::mutex> g(queues_[i]->lock);
+          queues_[i]->tasks.emplace_back(std::move(f));
+        }
+        {
+          std::lock_guard<std::mutex> g(lock_);
+        }
+        ready_.notify_one();
+      }
+
+    // Run one queued task on the calling thread, if there is one. Returns
+    // false if no task was found. Threads waiting for the completion of
+    // tasks call this to help rather than block.
+    bool
+    run_one()
+    {
+      const worker_id& self = current();
+      task t;
+      if (!take(self.pool == this ? self.index : 0, t))
+        return false;
+      t();
+      return true;
+    }
+
+  private:
+    static worker_id&
+    current()
+    {
+      static thread_local worker_id id {nullptr, 0};
+      return id;
+    }
+
+    // Take a task from the back of the ith queue or, failing that, from the
+    // front of another queue.
+    bool
+    take(std::size_t i, task& t)
+    {
+      if (pending_.load() == 0)
+        return false;
+      const std::size_t n = queues_.size();
+      for (std::size_t k = 0; k < n; ++k) {
+        task_queue& q = *queues_[(i + k) % n];
+        std::lock_guard<std::mutex> g(q.lock);
+        if (q.tasks.empty())
+          continue;
+        if (k == 0) {
+          t = std::move(q.tasks.back());
+          q.tasks.pop_back();
+        } else {
+          t = std::move(q.tasks.front());
+          q.tasks.pop_front();
+        }
+        --pending_;
+        return true;
+      }
+      return false;
+    }
+
+    void
+    work(std::size_t i)
+    {
+      current() = worker_id {this, i};
+      task t;
+      for (;;) {
+        if (take(i, t)) {
+          t();
+          t = nullptr;
+          continue;
+        }
+        std::unique_lock<std::mutex> g(lock_);
+        ready_.wait(g, [this]() { return done_ || pending_.load() != 0; });
+        if (done_ && pending_.load() == 0)
+          return;
+      }
+    }
+
+    std::vector<std::unique_ptr<task_queue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<std::size_t> pending_;
+    std::atomic<std::size_t> next_;
+    std::mutex lock_;
+    std::condition_variable ready_;
+    bool done_;
+  };
+
+
+  // Returns the pool shared by the parallel algorithms. The calling thread
+  // takes part in each parallel algorithm, so the pool has one worker fewer
+  // than the number of hardware threads.
+  inline thread_pool&
+  default_thread_pool()
+  {
+    static thread_pool pool([]() -> std::size_t {
+      std::size_t n = std::thread::hardware_concurrency();
+      return n > 1 ? n - 1 : 0;
+    }());
+    return pool;
+  }
+
+
+  // A task group runs functions on a thread pool and waits for all of them
+  // to finish. If any function throws, the first such exception is rethrown
+  // by wait. The destructor waits for unfinished functions, but does not
+  // rethrow.
+  //
+  // A waiting thread runs queued tasks of the pool. When there are none, it
+  // blocks until a function of the group finishes. The wait is bounded so
+  // that tasks queued in the meantime, on which the unfinished functions may
+  // depend, are still run by the waiting thread.
+  class task_group
+  {
+  public:
+    explicit task_group(thread_pool& p)
+      : pool_(p), count_(0)
+    { }
+
+    task_group(const task_group&) = delete;
+    task_group& operator=(const task_group&) = delete;
+
+    ~task_group() { join(); }
+
+    template <typename F>
+      void
+      run(F f)
+      {
+        {
+          std::lock_guard<std::mutex> g(lock_);
+          ++count_;
+        }
+        pool_.submit([this, f]() {
+          std::exception_ptr e;
+          try {
+            f();
+          } catch (...) {
+            e = std::current_exception();
+          }
+          finish(e);
+        });
+      }
+
+    void
+    wait()
+    {
+      join();
+      if (error_) {
+        std::exception_ptr e = error_;
+        error_ = nullptr;
+        std::rethrow_exception(e);
+      }
+    }
+
+  private:
+    // Record that a function has finished, having thrown e if e is not null.
+    // The waiting thread is notified with the lock held, so that it cannot
+    // destroy the group before the notification is complete.
+    void
+    finish(std::exception_ptr e)
+    {
+      std::lock_guard<std::mutex> g(lock_);
+      if (e && !error_)
+        error_ = e;
+      if (--count_ == 0)
+        finished_.notify_all();
+    }
+
+    // Run queued tasks until the functions of the group have finished.
+    void
+    join()
+    {
+      std::unique_lock<std::mutex> g(lock_);
+      while (count_ != 0) {
+        g.unlock();
+        const bool ran = pool_.run_one();
+        g.lock();
+        if (!ran && count_ != 0)
+          finished_.wait_for(g, std::chrono::milliseconds(1));
+      }
+    }
+
+    thread_pool& pool_;
+    std::size_t count_;
+    std::mutex lock_;
+    std::condition_variable finished_;
+    std::exception_ptr error_;
+  };
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                            [algo.execution]
+  //                           Execution Policies
+  //
+  // An execution policy is passed as the first argument of an algorithm to
+  // select how it runs:
+  //
+  //    seq        -- Sequentially, on the calling thread
+  //    par        -- In parallel, on the default thread pool
+  //    par_unseq  -- In parallel, and the calls to the argument functions
+  //                  within a thread may be interleaved or vectorized
+  //
+  // The parallel policies can be directed to another pool:
+  //
+  //    thread_pool pool(8);
+  //    count_if(par.on(pool), v, odd);
+  //
+  // Parallel execution requires random access ranges; other ranges are
+  // traversed sequentially. Functions passed to a parallel algorithm must not
+  // race with each other.
+  struct sequenced_policy
+  {
+  };
+
+  struct parallel_policy
+  {
+    constexpr parallel_policy(thread_pool* p = nullptr)
+      : pool(p)
+    { }
+
+    parallel_policy on(thread_pool& p) const { return parallel_policy(&p); }
+
+    thread_pool* pool;
+  };
+
+  struct parallel_unsequenced_policy
+  {
+    constexpr parallel_unsequenced_policy(thread_pool* p = nullptr)
+      : pool(p)
+    { }
+
+    parallel_unsequenced_policy 
+    on(thread_pool& p) const { return parallel_unsequenced_policy(&p); }
+
+    thread_pool* pool;
+  };
+
+  constexpr sequenced_policy seq {};
+  constexpr parallel_policy par {};
+  constexpr parallel_unsequenced_policy par_unseq {};
+
+
+  // Returns true if P is one of the execution policies.
+  template <typename P>
+    constexpr bool Execution_policy()
+    {
+      return Same<Decay<P>, sequenced_policy>()
+          || Same<Decay<P>, parallel_policy>()
+          || Same<Decay<P>, parallel_unsequenced_policy>();
+    }
+
+
+namespace sequence_impl
+{
+  // The smallest number of elements given to one task by the parallel
+  // algorithms.
+  constexpr std::size_t parallel_grain = 1 << 14;
+
+  // The number of elements examined by a search between checks for a
+  // result found by another thread.
+  constexpr std::size_t search_grain = 1 << 12;
+
+  // True when an algorithm with the policy P over the iterator I runs in
+  // parallel.
+  template <typename P, typename I>
+    using Parallel_tag = std::integral_constant<bool, 
+      !Same<Decay<P>, sequenced_policy>() && Random_access_iterator<I>()>;
+
+  template <typename P>
+    inline thread_pool&
+    pool_of(const P& policy)
+    {
+      return policy.pool ? *policy.pool : default_thread_pool();
+    }
+
+  // Returns the number of chunks into which n elements are partitioned for
+  // the pool p. Each chunk has at least grain elements, and there are a few
+  // chunks per thread so that stealing can even out the load.
+  inline std::size_t
+  chunk_count(const thread_pool& p, std::size_t n, std::size_t grain)
+  {
+    if (n == 0)
+      return 0;
+    const std::size_t k = std::min(n / std::max(grain, std::size_t(1)),
+                                   4 * (p.size() + 1));
+    return p.size() == 0 || k == 0 ? 1 : k;
+  }
+
+  // Partition [0, n) into k contiguous chunks of nearly equal size and call
+  // f(c, first, last) for each chunk c on the threads of the pool.
+  template <typename F>
+    void
+    parallel_split(thread_pool& p, std::size_t n, std::size_t k, F f)
+    {
+      if (n == 0 || k == 0)
+        return;
+      if (k == 1) {
+        f(std::size_t(0), std::size_t(0), n);
+        return;
+      }
+      task_group g(p);
+      for (std::size_t c = 1; c < k; ++c)
+        g.run([&f, c, n, k]() { f(c, n * c / k, n * (c + 1) / k); });
+      f(std::size_t(0), std::size_t(0), n / k);
+      g.wait();
+    }
+
+  // Partition [0, n) into the contiguous chunks given by chunk_count and
+  // call f(c, first, last) for each chunk c on the threads of the pool.
+  template <typename F>
+    inline void
+    parallel_chunks(thread_pool& p, std::size_t n, std::size_t grain, F f)
+    {
+      parallel_split(p, n, chunk_count(p, n, grain), f);
+    }
+
+  // Call f(first, last) for the contiguous chunks of [0, n).
+  template <typename F>
+    inline void
+    parallel_for(thread_pool& p, std::size_t n, std::size_t grain, F f)
+    {
+      parallel_chunks(p, n, grain, [&f](std::size_t, std::size_t i, std::size_t j) {
+        f(i, j);
+      });
+    }
+
+  // Returns the sum of f(first, last) over the chunks of [0, n).
+  template <typename T, typename F>
+    T
+    parallel_sum(thread_pool& p, std::size_t n, std::size_t grain, F f)
+    {
+      std::vector<T> partial(chunk_count(p, n, grain), T(0));
+      parallel_chunks(p, n, grain, [&](std::size_t c, std::size_t i, std::size_t j) {
+        partial[c] = f(i, j);
+      });
+      T sum = T(0);
+      for (const T& x : partial)
+        sum += x;
+      return sum;
+    }
+
+  // Returns the smallest index in [0, n) found by f, or n if there is none.
+  // The function f(first, last) searches [first, last) and returns the
+  // index of the first match or last.
+  //
+  // The threads claim chunks of grain indexes in increasing order. Once a
+  // match is found, chunks that start after it are not searched, so the
+  // search stops early without changing its result.
+  template <typename F>
+    std::size_t
+    parallel_search(thread_pool& p, std::size_t n, std::size_t grain, F f)
+    {
+      const std::size_t threads = std::min(p.size() + 1, (n + grain - 1) / grain);
+      if (threads < 2)
+        return f(std::size_t(0), n);
+
+      std::atomic<std::size_t> next(0);
+      std::atomic<std::size_t> found(n);
+      auto search = [&]() {
+        for (;;) {
+          const std::size_t first = next.fetch_add(grain);
+          if (first >= found.load())
+            return;
+          const std::size_t last = std::min(first + grain, n);
+          const std::size_t i = f(first, last);
+          if (i != last) {
+            std::size_t prev = found.load();
+            while (i < prev && !found.compare_exchange_weak(prev, i))
+              ;
+            return;
+          }
+        }
+      };
+      task_group g(p);
+      for (std::size_t t = 1; t < threads; ++t)
+        g.run(search);
+      search();
+      g.wait();
+      return found.load();
+    }
+
+} // namespace sequence_impl
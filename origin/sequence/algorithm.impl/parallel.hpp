@@ -0,0 +1,332 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_SEQUENCE_ALGORITHM_HPP
+#  error Do not include this file directly. Include sequence/algorithm.hpp.
+#endif
+
+// The implementations of the algorithms with execution policies. Each
+// algorithm is selected by a Parallel_tag: the false overloads call the
+// sequential algorithm, and the true overloads partition the range.
+namespace sequence_impl
+{
+  // The default comparison of the mismatch and equality algorithms.
+  struct equal_to
+  {
+    template <typename T, typename U>
+      bool operator()(const T& a, const U& b) const { return a == b; }
+  };
+
+  template <typename P, typename I, typename Pred>
+    inline I
+    find_if(std::false_type, const P&, I first, I last, Pred pred)
+    {
+      return std::find_if(first, last, pred);
+    }
+
+  template <typename P, typename I, typename Pred>
+    I
+    find_if(std::true_type, const P& policy, I first, I last, Pred pred)
+    {
+      const std::size_t n = last - first;
+      return first + parallel_search(pool_of(policy), n, search_grain,
+        [&](std::size_t i, std::size_t j) -> std::size_t {
+          return std::find_if(first + i, first + j, pred) - first;
+        });
+    }
+
+  template <typename P, typename I, typename F>
+    inline void
+    for_each(std::false_type, const P&, I first, I last, F f)
+    {
+      std::for_each(first, last, f);
+    }
+
+  template <typename P, typename I, typename F>
+    void
+    for_each(std::true_type, const P& policy, I first, I last, F f)
+    {
+      parallel_for(pool_of(policy), last - first, parallel_grain,
+        [&](std::size_t i, std::size_t j) {
+          std::for_each(first + i, first + j, f);
+        });
+    }
+
+  template <typename P, typename I, typename Pred>
+    inline Difference_type<I>
+    count_if(std::false_type, const P&, I first, I last, Pred pred)
+    {
+      return std::count_if(first, last, pred);
+    }
+
+  template <typename P, typename I, typename Pred>
+    Difference_type<I>
+    count_if(std::true_type, const P& policy, I first, I last, Pred pred)
+    {
+      using D = Difference_type<I>;
+      return parallel_sum<D>(pool_of(policy), last - first, parallel_grain,
+        [&](std::size_t i, std::size_t j) -> D {
+          return std::count_if(first + i, first + j, pred);
+        });
+    }
+
+  // Apply f(i, j, o) to the chunks [i, j) of [first, last), where o is the
+  // corresponding position in the output range starting at out, and return
+  // the end of the output range.
+  template <typename P, typename I, typename O, typename F>
+    inline O
+    parallel_copy(std::false_type, const P&, I first, I last, O out, F f)
+    {
+      return f(first, last, out);
+    }
+
+  template <typename P, typename I, typename O, typename F>
+    O
+    parallel_copy(std::true_type, const P& policy, I first, I last, O out, F f)
+    {
+      const std::size_t n = last - first;
+      parallel_for(pool_of(policy), n, parallel_grain,
+        [&](std::size_t i, std::size_t j) {
+          f(first + i, first + j, out + i);
+        });
+      return out + n;
+    }
+
+  template <typename P, typename I1, typename I2, typename C>
+    inline std::pair<I1, I2>
+    mismatch(std::false_type, const P&, I1 first1, I1 last1, I2 first2, C comp)
+    {
+      return std::mismatch(first1, last1, first2, comp);
+    }
+
+  template <typename P, typename I1, typename I2, typename C>
+    std::pair<I1, I2>
+    mismatch(std::true_type, const P& policy, I1 first1, I1 last1, I2 first2, C comp)
+    {
+      const std::size_t n = last1 - first1;
+      const std::size_t k = parallel_search(pool_of(policy), n, search_grain,
+        [&](std::size_t i, std::size_t j) -> std::size_t {
+          return std::mismatch(first1 + i, first1 + j, first2 + i, comp).first - first1;
+        });
+      return {first1 + k, first2 + k};
+    }
+
+  // Tag for algorithms that read one range and write another.
+  template <typename P, typename I, typename O>
+    using Parallel_copy_tag = std::integral_constant<bool,
+      Parallel_tag<P, I>::value && Random_access_iterator<O>()>;
+
+} // namespace sequence_impl
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                             [algo.parallel]
+  //                         Parallel Algorithms
+  //
+  // The following algorithms take an execution policy as their first
+  // argument (see [algo.execution]):
+  //
+  //    all_of(policy, range, pred)
+  //    any_of(policy, range, pred)
+  //    none_of(policy, range, pred)
+  //    for_each(policy, range, f)
+  //    find(policy, range, value)
+  //    find_if(policy, range, pred)
+  //    find_if_not(policy, range, pred)
+  //    count(policy, range, value)
+  //    count_if(policy, range, pred)
+  //    range_mismatch(policy, range1, range2[, comp])
+  //    range_equal(policy, range1, range2[, comp])
+  //    copy(policy, range1, range2)
+  //    fill(policy, range, value)
+  //    range_transform(policy, range1, range2, op)
+  //    range_transform(policy, range1, range2, range3, op)
+  //
+  // The searches (find, the quantifiers, mismatch and equal) stop examining
+  // elements after the first match once all elements before it have been
+  // examined. Their results are the same as those of the sequential
+  // algorithms.
+
+  template <typename P, typename R, typename Pred>
+    inline Requires<Execution_policy<P>(), Iterator_of<R>>
+    find_if(const P& policy, R&& range, Pred pred)
+    {
+      using std::begin;
+      using std::end;
+      using I = Iterator_of<R>;
+      return sequence_impl::find_if(sequence_impl::Parallel_tag<P, I>(), policy,
+                                    begin(range), end(range), pred);
+    }
+
+  template <typename P, typename R, typename Pred>
+    inline Requires<Execution_policy<P>(), Iterator_of<R>>
+    find_if_not(const P& policy, R&& range, Pred pred)
+    {
+      using Ref = decltype(*std::declval<Iterator_of<R>>());
+      return find_if(policy, range, [&pred](Ref x) { return !pred(x); });
+    }
+
+  template <typename P, typename R, typename T>
+    inline Requires<Execution_policy<P>(), Iterator_of<R>>
+    find(const P& policy, R&& range, const T& value)
+    {
+      using Ref = decltype(*std::declval<Iterator_of<R>>());
+      return find_if(policy, range, [&value](Ref x) { return x == value; });
+    }
+
+  template <typename P, typename R, typename Pred>
+    inline Requires<Execution_policy<P>(), bool>
+    any_of(const P& policy, const R& range, Pred pred)
+    {
+      using std::end;
+      return find_if(policy, range, pred) != end(range);
+    }
+
+  template <typename P, typename R, typename Pred>
+    inline Requires<Execution_policy<P>(), bool>
+    all_of(const P& policy, const R& range, Pred pred)
+    {
+      using std::end;
+      return find_if_not(policy, range, pred) == end(range);
+    }
+
+  template <typename P, typename R, typename Pred>
+    inline Requires<Execution_policy<P>(), bool>
+    none_of(const P& policy, const R& range, Pred pred)
+    {
+      using std::end;
+      return find_if(policy, range, pred) == end(range);
+    }
+
+  // Unlike for_each(range, f), the parallel for_each does not return f
+  // since each thread applies its own copy.
+  template <typename P, typename R, typename F>
+    inline Requires<Execution_policy<P>(), void>
+    for_each(const P& policy, R&& range, F f)
+    {
+      using std::begin;
+      using std::end;
+      using I = Iterator_of<R>;
+      sequence_impl::for_each(sequence_impl::Parallel_tag<P, I>(), policy,
+                              begin(range), end(range), f);
+    }
+
+  template <typename P, typename R, typename Pred>
+    inline Requires<Execution_policy<P>(), Difference_type<R>>
+    count_if(const P& policy, const R& range, Pred pred)
+    {
+      using std::begin;
+      using std::end;
+      using I = Iterator_of<const R>;
+      return sequence_impl::count_if(sequence_impl::Parallel_tag<P, I>(), policy,
+                                     begin(range), end(range), pred);
+    }
+
+  template <typename P, typename R, typename T>
+    inline Requires<Execution_policy<P>(), Difference_type<R>>
+    count(const P& policy, const R& range, const T& value)
+    {
+      using Ref = decltype(*std::declval<Iterator_of<const R>>());
+      return count_if(policy, range, [&value](Ref x) { return x == value; });
+    }
+
+  template <typename P, typename R1, typename R2, typename C>
+    inline Requires<Execution_policy<P>(), std::pair<Iterator_of<R1>, Iterator_of<R2>>>
+    range_mismatch(const P& policy, R1&& range1, R2&& range2, C comp)
+    {
+      using std::begin;
+      using std::end;
+      using I = Iterator_of<R1>;
+      using J = Iterator_of<R2>;
+      using Tag = std::integral_constant<bool,
+        sequence_impl::Parallel_tag<P, I>::value && Random_access_iterator<J>()>;
+      return sequence_impl::mismatch(Tag(), policy, begin(range1), end(range1),
+                                     begin(range2), comp);
+    }
+
+  template <typename P, typename R1, typename R2>
+    inline Requires<Execution_policy<P>(), std::pair<Iterator_of<R1>, Iterator_of<R2>>>
+    range_mismatch(const P& policy, R1&& range1, R2&& range2)
+    {
+      return range_mismatch(policy, range1, range2, sequence_impl::equal_to());
+    }
+
+  template <typename P, typename R1, typename R2, typename C>
+    inline Requires<Execution_policy<P>(), bool>
+    range_equal(const P& policy, const R1& range1, const R2& range2, C comp)
+    {
+      using std::end;
+      return range_mismatch(policy, range1, range2, comp).first == end(range1);
+    }
+
+  template <typename P, typename R1, typename R2>
+    inline Requires<Execution_policy<P>(), bool>
+    range_equal(const P& policy, const R1& range1, const R2& range2)
+    {
+      return range_equal(policy, range1, range2, sequence_impl::equal_to());
+    }
+
+  template <typename P, typename R1, typename R2>
+    inline Requires<Execution_policy<P>(), Iterator_of<R2>>
+    copy(const P& policy, const R1& range1, R2&& range2)
+    {
+      using std::begin;
+      using std::end;
+      using I = Iterator_of<const R1>;
+      using O = Iterator_of<R2>;
+      return sequence_impl::parallel_copy(
+        sequence_impl::Parallel_copy_tag<P, I, O>(), policy,
+        begin(range1), end(range1), begin(range2),
+        [](I i, I j, O o) { return std::copy(i, j, o); });
+    }
+
+  template <typename P, typename R, typename T>
+    inline Requires<Execution_policy<P>(), void>
+    fill(const P& policy, R&& range, const T& value)
+    {
+      using std::begin;
+      using std::end;
+      using I = Iterator_of<R>;
+      sequence_impl::parallel_copy(
+        sequence_impl::Parallel_copy_tag<P, I, I>(), policy,
+        begin(range), end(range), begin(range),
+        [&value](I i, I j, I o) { std::fill(i, j, value); return o; });
+    }
+
+  template <typename P, typename R1, typename R2, typename Op>
+    inline Requires<Execution_policy<P>(), Iterator_of<R2>>
+    range_transform(const P& policy, const R1& range1, R2&& range2, Op op)
+    {
+      using std::begin;
+      using std::end;
+      using I = Iterator_of<const R1>;
+      using O = Iterator_of<R2>;
+      return sequence_impl::parallel_copy(
+        sequence_impl::Parallel_copy_tag<P, I, O>(), policy,
+        begin(range1), end(range1), begin(range2),
+        [&op](I i, I j, O o) { return std::transform(i, j, o, op); });
+    }
+
+  template <typename P, typename R1, typename R2, typename R3, typename Op>
+    inline Requires<Execution_policy<P>(), Iterator_of<R3>>
+    range_transform(const P& policy, const R1& range1, const R2& range2, 
+                    R3&& range3, Op op)
+    {
+      using std::begin;
+      using std::end;
+      using I = Iterator_of<const R1>;
+      using J = Iterator_of<const R2>;
+      using O = Iterator_of<R3>;
+      using Tag = std::integral_constant<bool, 
+        sequence_impl::Parallel_copy_tag<P, I, O>::value && Random_access_iterator<J>()>;
+      I first = begin(range1);
+      J first2 = begin(range2);
+      return sequence_impl::parallel_copy(Tag(), policy, first, end(range1), begin(range3),
+        [&op, first, first2](I i, I j, O o) { 
+          return std::transform(i, j, std::next(first2, i - first), o, op); 
+        });
+    }
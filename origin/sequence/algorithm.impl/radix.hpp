@@ -0,0 +1,405 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_SEQUENCE_ALGORITHM_HPP
+#  error Do not include this file directly. Include sequence/algorithm.hpp.
+#endif
+
+namespace sequence_impl
+{
+  // The radix key traits describe a key as a sequence of bytes, most
+  // significant first, such that keys are ordered as their byte sequences
+  // are ordered lexicographically. The member valid is true for the types
+  // that can be used as radix keys:
+  //
+  //    - Integer types. The sign bit of signed types is flipped so that
+  //      negative values precede nonnegative ones.
+  //    - float and double. Negative values have all their bits flipped and
+  //      nonnegative values their sign bit, so that the order of the bytes
+  //      is the numeric order. -0.0 precedes 0.0, and NaNs are placed
+  //      before or after all other values depending on their sign bit.
+  //    - Pairs and tuples of radix keys, ordered lexicographically.
+  template <typename K, typename = void>
+    struct radix_key
+    {
+      static constexpr bool valid = false;
+    };
+
+  template <typename U>
+    inline unsigned
+    radix_byte(U u, std::size_t d)
+    {
+      return static_cast<unsigned>(u >> (8 * (sizeof(U) - 1 - d))) & 0xffu;
+    }
+
+  template <typename K>
+    struct radix_key<K, Requires<Integer<K>() && !Same<K, bool>()>>
+    {
+      using U = Make_unsigned<K>;
+      static constexpr bool valid = true;
+      static constexpr std::size_t bytes = sizeof(K);
+
+      static unsigned
+      byte(K k, std::size_t d)
+      {
+        U u = static_cast<U>(k);
+        if (Signed<K>())
+          u ^= U(U(1) << (8 * sizeof(U) - 1));
+        return radix_byte(u, d);
+      }
+    };
+
+  template <>
+    struct radix_key<bool>
+    {
+      static constexpr bool valid = true;
+      static constexpr std::size_t bytes = 1;
+
+      static unsigned byte(bool k, std::size_t) { return k; }
+    };
+
+  template <typename K>
+    struct radix_key<K, Requires<Same<K, float>() || Same<K, double>()>>
+    {
+      using U = typename std::conditional<sizeof(K) == 4, std::uint32_t, std::uint64_t>::type;
+      static_assert(sizeof(K) == sizeof(U), "");
+      static constexpr bool valid = true;
+      static constexpr std::size_t bytes = sizeof(K);
+
+      static unsigned
+      byte(K k, std::size_t d)
+      {
+        U u;
+        std::memcpy(&u, &k, sizeof(U));
+        const U sign = U(1) << (8 * sizeof(U) - 1);
+        u = (u & sign) ? ~u : (u | sign);
+        return radix_byte(u, d);
+      }
+    };
+
+  template <typename A, typename B>
+    struct radix_key<std::pair<A, B>>
+    {
+      using KA = radix_key<A>;
+      using KB = radix_key<B>;
+      static constexpr bool valid = KA::valid && KB::valid;
+      static constexpr std::size_t bytes = KA::bytes + KB::bytes;
+
+      static unsigned
+      byte(const std::pair<A, B>& k, std::size_t d)
+      {
+        return d < KA::bytes ? KA::byte(k.first, d) : KB::byte(k.second, d - KA::bytes);
+      }
+    };
+
+  // The radix key traits of the elements of the tuple T from the Ith on.
+  template <std::size_t I, typename T, bool = (I < std::tuple_size<T>::value)>
+    struct tuple_radix_key
+    {
+      using KE = radix_key<Decay<typename std::tuple_element<I, T>::type>>;
+      using Rest = tuple_radix_key<I + 1, T>;
+      static constexpr bool valid = KE::valid && Rest::valid;
+      static constexpr std::size_t bytes = KE::bytes + Rest::bytes;
+
+      static unsigned
+      byte(const T& k, std::size_t d)
+      {
+        return d < KE::bytes ? KE::byte(std::get<I>(k), d) : Rest::byte(k, d - KE::bytes);
+      }
+    };
+
+  template <std::size_t I, typename T>
+    struct tuple_radix_key<I, T, false>
+    {
+      static constexpr bool valid = true;
+      static constexpr std::size_t bytes = 0;
+
+      static unsigned byte(const T&, std::size_t) { return 0; }
+    };
+
+  template <typename... Args>
+    struct radix_key<std::tuple<Args...>> : tuple_radix_key<0, std::tuple<Args...>>
+    {
+    };
+
+
+  // The key function of the radix sorts without one.
+  struct radix_identity
+  {
+    template <typename T>
+      const T& operator()(const T& x) const { return x; }
+  };
+
+  template <typename I, typename Key>
+    using Radix_key_type = Decay<decltype(std::declval<Key&>()(*std::declval<I>()))>;
+
+  // Returns true if the key of a precedes that of b, comparing from the dth
+  // byte on.
+  template <typename Key, typename T>
+    inline bool
+    radix_less(Key& key, const T& a, const T& b, std::size_t d)
+    {
+      using K = Decay<decltype(key(a))>;
+      for (; d < radix_key<K>::bytes; ++d) {
+        const unsigned x = radix_key<K>::byte(key(a), d);
+        const unsigned y = radix_key<K>::byte(key(b), d);
+        if (x != y)
+          return x < y;
+      }
+      return false;
+    }
+
+  // Below this size, the in-place radix sort uses a comparison sort.
+  constexpr std::size_t radix_cutoff = 64;
+
+  // Sort [first, last) in place on the bytes of the keys from the dth on,
+  // by American flag sort: the elements are counted by their dth byte,
+  // permuted into place by following cycles, and each bucket is sorted on
+  // the following bytes.
+  template <typename I, typename Key>
+    void
+    msd_radix_sort(I first, I last, Key& key, std::size_t d)
+    {
+      using T = Value_type<I>;
+      using K = Radix_key_type<I, Key>;
+      using R = radix_key<K>;
+      for (;;) {
+        const std::size_t n = last - first;
+        if (d == R::bytes || n < 2)
+          return;
+        if (n < radix_cutoff) {
+          std::sort(first, last, [&key, d](const T& a, const T& b) {
+            return radix_less(key, a, b, d);
+          });
+          return;
+        }
+
+        std::size_t count[256] = {};
+        for (I i = first; i != last; ++i)
+          ++count[R::byte(key(*i), d)];
+        if (*std::max_element(count, count + 256) == n) {
+          ++d;
+          continue;
+        }
+
+        std::size_t next[256], end[256];
+        std::size_t off = 0;
+        for (unsigned b = 0; b < 256; ++b) {
+          next[b] = off;
+          off += count[b];
+          end[b] = off;
+        }
+        for (unsigned b = 0; b < 256; ++b) {
+          while (next[b] != end[b]) {
+            const unsigned v = R::byte(key(first[next[b]]), d);
+            if (v == b)
+              ++next[b];
+            else
+              std::iter_swap(first + next[b], first + next[v]++);
+          }
+        }
+
+        for (unsigned b = 0; b < 256; ++b)
+          if (count[b] > 1)
+            msd_radix_sort(first + (end[b] - count[b]), first + end[b], key, d + 1);
+        return;
+      }
+    }
+
+  // Move the n elements of src into dst, stably ordered by the dth byte of
+  // their keys. Each chunk of src is counted into its own histogram, and
+  // the chunks are scattered concurrently. If construct is true, dst is
+  // uninitialized storage in which the elements are move constructed.
+  // Returns false without moving anything if all the elements have the
+  // same dth byte.
+  template <typename I, typename O, typename Key>
+    bool
+    lsd_radix_pass(thread_pool& pool, I src, O dst, std::size_t n, Key& key, std::size_t d,
+                   bool construct)
+    {
+      using K = Radix_key_type<I, Key>;
+      using R = radix_key<K>;
+      const std::size_t k = chunk_count(pool, n, parallel_grain);
+      std::vector<std::size_t> count(k * 256, 0);
+      parallel_split(pool, n, k, [&](std::size_t c, std::size_t i, std::size_t j) {
+        std::size_t* cc = &count[c * 256];
+        for (std::size_t e = i; e != j; ++e)
+          ++cc[R::byte(key(src[e]), d)];
+      });
+
+      // Each chunk writes its elements of bucket b after those of the
+      // earlier buckets and of the earlier chunks.
+      std::size_t off = 0;
+      for (unsigned b = 0; b < 256; ++b) {
+        std::size_t total = 0;
+        for (std::size_t c = 0; c < k; ++c) {
+          const std::size_t x = count[c * 256 + b];
+          count[c * 256 + b] = off + total;
+          total += x;
+        }
+        if (total == n)
+          return false;
+        off += total;
+      }
+
+      using T = Value_type<I>;
+      parallel_split(pool, n, k, [&](std::size_t c, std::size_t i, std::size_t j) {
+        std::size_t* cc = &count[c * 256];
+        for (std::size_t e = i; e != j; ++e) {
+          auto& x = dst[cc[R::byte(key(src[e]), d)]++];
+          if (construct)
+            ::new (static_cast<void*>(std::addressof(x))) T(std::move(src[e]));
+          else
+            x = std::move(src[e]);
+        }
+      });
+      return true;
+    }
+
+  // Sort [first, last) by one stable pass per byte of the key, from the
+  // least significant, moving the elements between the range and a buffer.
+  // The objects of the buffer are constructed by the first pass that moves
+  // elements into it. If no buffer is available (see sort_buffer), the
+  // in-place sort is used instead.
+  template <typename I, typename Key>
+    void
+    lsd_radix_sort(thread_pool& pool, I first, I last, Key key)
+    {
+      using T = Value_type<I>;
+      using K = Radix_key_type<I, Key>;
+      static_assert(Random_access_iterator<I>(), "");
+      static_assert(radix_key<K>::valid, "The key type is not a radix key");
+
+      const std::size_t n = last - first;
+      if (n < 2)
+        return;
+      sort_buffer<T> buf(n);
+      if (buf.empty()) {
+        msd_radix_sort(first, last, key, 0);
+        return;
+      }
+
+      T* p = buf.data();
+      bool in_buffer = false;
+      bool constructed = false;
+      try {
+        for (std::size_t d = radix_key<K>::bytes; d-- != 0; ) {
+          bool moved = in_buffer ? lsd_radix_pass(pool, p, first, n, key, d, false)
+                                 : lsd_radix_pass(pool, first, p, n, key, d, !constructed);
+          if (moved) {
+            in_buffer = !in_buffer;
+            constructed = true;
+          }
+        }
+        if (in_buffer)
+          parallel_for(pool, n, parallel_grain, [&](std::size_t i, std::size_t j) {
+            std::move(p + i, p + j, first + i);
+          });
+      } catch (...) {
+        if (constructed)
+          destroy_range(p, p + n);
+        throw;
+      }
+      if (constructed)
+        destroy_range(p, p + n);
+    }
+
+  template <typename P, typename I, typename Key>
+    inline void
+    radix_sort(std::false_type, const P&, I first, I last, Key key)
+    {
+      thread_pool none(0);
+      lsd_radix_sort(none, first, last, key);
+    }
+
+  template <typename P, typename I, typename Key>
+    inline void
+    radix_sort(std::true_type, const P& policy, I first, I last, Key key)
+    {
+      lsd_radix_sort(pool_of(policy), first, last, key);
+    }
+
+} // namespace sequence_impl
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                                [algo.radix]
+  //                              Radix Sort
+  //
+  // The radix sorts order the elements of a random access range by a key
+  // that is an integer, a float or double, or a pair or tuple of such keys
+  // (see sequence_impl::radix_key). Without a key function, the elements are
+  // their own keys.
+  //
+  //    radix_sort(range)
+  //    radix_sort(range, key)
+  //    radix_sort(policy, range)
+  //    radix_sort(policy, range, key)
+  //    radix_sort_in_place(range)
+  //    radix_sort_in_place(range, key)
+  //
+  // radix_sort is a stable least significant digit sort that makes one pass
+  // per byte of the key, skipping bytes that are the same in all keys. It
+  // moves the elements through a buffer as large as the range; with a
+  // parallel policy, the passes are split among the threads, each chunk
+  // with its own histogram. radix_sort_in_place is an unstable most
+  // significant digit sort that needs no buffer.
+  //
+  // The key function is called several times for each element and should
+  // be cheap.
+
+  template <typename R, typename Key>
+    inline Requires<!Execution_policy<R>(), void>
+    radix_sort(R&& range, Key key)
+    {
+      radix_sort(seq, range, key);
+    }
+
+  template <typename R>
+    inline void
+    radix_sort(R&& range)
+    {
+      radix_sort(seq, range, sequence_impl::radix_identity());
+    }
+
+  template <typename P, typename R, typename Key>
+    inline Requires<Execution_policy<P>(), void>
+    radix_sort(const P& policy, R&& range, Key key)
+    {
+      using std::begin;
+      using std::end;
+      using I = Iterator_of<R>;
+      sequence_impl::radix_sort(sequence_impl::Parallel_tag<P, I>(), policy,
+                                begin(range), end(range), key);
+    }
+
+  template <typename P, typename R>
+    inline Requires<Execution_policy<P>(), void>
+    radix_sort(const P& policy, R&& range)
+    {
+      radix_sort(policy, range, sequence_impl::radix_identity());
+    }
+
+  template <typename R, typename Key>
+    inline void
+    radix_sort_in_place(R&& range, Key key)
+    {
+      using std::begin;
+      using std::end;
+      using I = Iterator_of<R>;
+      using K = sequence_impl::Radix_key_type<I, Key>;
+      static_assert(Random_access_iterator<I>(), "");
+      static_assert(sequence_impl::radix_key<K>::valid, "The key type is not a radix key");
+      sequence_impl::msd_radix_sort(begin(range), end(range), key, 0);
+    }
+
+  template <typename R>
+    inline void
+    radix_sort_in_place(R&& range)
+    {
+      radix_sort_in_place(range, sequence_impl::radix_identity());
+    }
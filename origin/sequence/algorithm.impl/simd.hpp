@@ -0,0 +1,397 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_SEQUENCE_ALGORITHM_HPP
+#  error Do not include this file directly. Include sequence/algorithm.hpp.
+#endif
+
+// Vectorized kernels for find, count, mismatch, equal and the min/max
+// element algorithms over contiguous ranges of arithmetic types.
+//
+// Each kernel examines the range in fixed-size blocks with branch-free
+// loops that the compiler turns into vector instructions, and branches at
+// most once per block. The searches locate the match within the first
+// block that has one.
+//
+// With GCC on x86, each kernel is also compiled for AVX2 and the AVX2 code
+// is selected at run time when the processor supports it. The default code
+// targets the baseline of the build, which on x86-64 (SSE2) has no 64-bit
+// integer compares: the AVX2 code is what vectorizes 64-bit elements.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#  define ORIGIN_SEQUENCE_SIMD_DISPATCH 1
+#  define ORIGIN_SEQUENCE_SIMD_INLINE __attribute__((always_inline))
+#else
+#  define ORIGIN_SEQUENCE_SIMD_INLINE
+#endif
+
+namespace sequence_impl
+{
+  // True if I is known to refer to contiguous storage: a pointer or an
+  // iterator of a vector whose elements are objects. Iterators that return
+  // proxies (e.g., those of vector<bool>) are excluded.
+  template <typename I>
+    struct is_contiguous_iterator : std::integral_constant<bool,
+      std::is_lvalue_reference<decltype(*std::declval<I>())>::value
+        && (std::is_pointer<I>::value
+          || Same<I, typename std::vector<Value_type<I>>::iterator>()
+          || Same<I, typename std::vector<Value_type<I>>::const_iterator>())>
+    { };
+
+  // True when the vectorized kernels apply to the elements of I compared
+  // with values of type T. The storage of I is only examined for arithmetic
+  // value types.
+  template <typename I, typename T>
+    using Simd_tag = typename std::conditional<
+      Arithmetic<Value_type<I>>() && Same<Value_type<I>, Decay<T>>(),
+      is_contiguous_iterator<I>, 
+      std::false_type
+    >::type;
+
+  // An unsigned integer type as wide as T. Comparisons of T are
+  // accumulated in it so that a block is processed in lanes of one width.
+  template <typename T>
+    using Simd_lane = typename std::conditional<sizeof(T) == 1, std::uint8_t,
+                      typename std::conditional<sizeof(T) == 2, std::uint16_t,
+                      typename std::conditional<sizeof(T) == 4, std::uint32_t,
+                                                std::uint64_t>::type>::type>::type;
+
+  // The number of elements of T in a block: 128 bytes, and at most 128
+  // elements so that a byte lane cannot overflow when counting.
+  template <typename T>
+    constexpr std::size_t simd_block()
+    {
+      return 128 / sizeof(T) < 128 ? 128 / sizeof(T) : 128;
+    }
+
+  struct simd_find_kernel
+  {
+    template <typename T>
+      ORIGIN_SEQUENCE_SIMD_INLINE std::size_t
+      operator()(const T* p, std::size_t n, T v) const
+      {
+        using L = Simd_lane<T>;
+        const std::size_t b = simd_block<T>();
+        std::size_t i = 0;
+        for (; i + b <= n; i += b) {
+          L hit = 0;
+          for (std::size_t j = 0; j < b; ++j)
+            hit |= L(p[i + j] == v);
+          if (hit)
+            break;
+        }
+        for (; i < n; ++i)
+          if (p[i] == v)
+            return i;
+        return n;
+      }
+  };
+
+  struct simd_count_kernel
+  {
+    template <typename T>
+      ORIGIN_SEQUENCE_SIMD_INLINE std::size_t
+      operator()(const T* p, std::size_t n, T v) const
+      {
+        using L = Simd_lane<T>;
+        const std::size_t b = simd_block<T>();
+        std::size_t c = 0;
+        std::size_t i = 0;
+        for (; i + b <= n; i += b) {
+          L s = 0;
+          for (std::size_t j = 0; j < b; ++j)
+            s += L(p[i + j] == v);
+          c += s;
+        }
+        for (; i < n; ++i)
+          c += p[i] == v;
+        return c;
+      }
+  };
+
+  struct simd_mismatch_kernel
+  {
+    template <typename T>
+      ORIGIN_SEQUENCE_SIMD_INLINE std::size_t
+      operator()(const T* p, const T* q, std::size_t n) const
+      {
+        using L = Simd_lane<T>;
+        const std::size_t b = simd_block<T>();
+        std::size_t i = 0;
+        for (; i + b <= n; i += b) {
+          L miss = 0;
+          for (std::size_t j = 0; j < b; ++j)
+            miss |= L(!(p[i + j] == q[i + j]));
+          if (miss)
+            break;
+        }
+        for (; i < n; ++i)
+          if (!(p[i] == q[i]))
+            return i;
+        return n;
+      }
+  };
+
+  // The positions of the first least, the first greatest and the last
+  // greatest of a sequence.
+  struct simd_extrema
+  {
+    std::size_t min;
+    std::size_t first_max;
+    std::size_t last_max;
+  };
+
+  // Finds the extrema of the n > 0 integers at p in one pass. The least and
+  // greatest values of each block are computed in vector lanes, and the
+  // blocks that hold the extrema are recorded. Those blocks are then
+  // searched for the positions of the extrema.
+  struct simd_extrema_kernel
+  {
+    template <typename T>
+      ORIGIN_SEQUENCE_SIMD_INLINE simd_extrema
+      operator()(const T* p, std::size_t n) const
+      {
+        const std::size_t b = simd_block<T>();
+        T lo = p[0];
+        T hi = p[0];
+        std::size_t lo_block = 0, first_hi_block = 0, last_hi_block = 0;
+        std::size_t i = 0;
+        for (; i + b <= n; i += b) {
+          T bl = p[i];
+          T bh = p[i];
+          for (std::size_t j = 0; j < b; ++j) {
+            bl = p[i + j] < bl ? p[i + j] : bl;
+            bh = bh < p[i + j] ? p[i + j] : bh;
+          }
+          if (bl < lo) {
+            lo = bl;
+            lo_block = i;
+          }
+          if (hi < bh) {
+            hi = bh;
+            first_hi_block = i;
+          }
+          if (!(bh < hi))
+            last_hi_block = i;
+        }
+
+        // The elements after the last block are examined one at a time.
+        const std::size_t tail = i;
+        simd_extrema r {n, n, n};
+        for (; i < n; ++i) {
+          if (p[i] < lo) {
+            lo = p[i];
+            r.min = i;
+          }
+          if (hi < p[i]) {
+            hi = p[i];
+            r.first_max = i;
+          }
+          if (!(p[i] < hi))
+            r.last_max = i;
+        }
+
+        if (r.min == n)
+          for (r.min = lo_block; !(p[r.min] == lo); ++r.min)
+            ;
+        if (r.first_max == n)
+          for (r.first_max = first_hi_block; !(p[r.first_max] == hi); ++r.first_max)
+            ;
+        if (r.last_max == n)
+          for (r.last_max = std::min(last_hi_block + b, tail); !(p[--r.last_max] == hi); )
+            ;
+        return r;
+      }
+  };
+
+#ifdef ORIGIN_SEQUENCE_SIMD_DISPATCH
+  inline bool
+  has_avx2()
+  {
+    static const bool avx2 = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+    return avx2;
+  }
+
+  template <typename K, typename... Args>
+    __attribute__((target("avx2"), noinline)) auto
+    simd_avx2(K k, Args... args) -> decltype(k(args...))
+    {
+      return k(args...);
+    }
+#endif
+
+  // Run the kernel k with the given arguments, using the best code for
+  // the processor.
+  template <typename K, typename... Args>
+    inline auto
+    simd_run(K k, Args... args) -> decltype(k(args...))
+    {
+#ifdef ORIGIN_SEQUENCE_SIMD_DISPATCH
+      if (has_avx2())
+        return simd_avx2(k, args...);
+#endif
+      return k(args...);
+    }
+
+  template <typename I>
+    inline auto
+    simd_pointer(I i) -> decltype(std::addressof(*i))
+    {
+      return std::addressof(*i);
+    }
+
+
+  // The algorithms below select the vectorized kernels by their Simd_tag.
+
+  template <typename I, typename T>
+    inline I
+    find(std::false_type, I first, I last, const T& value)
+    {
+      return std::find(first, last, value);
+    }
+
+  template <typename I, typename T>
+    inline I
+    find(std::true_type, I first, I last, const T& value)
+    {
+      if (first == last)
+        return last;
+      return first + simd_run(simd_find_kernel(), simd_pointer(first), 
+                              std::size_t(last - first), Value_type<I>(value));
+    }
+
+  template <typename I, typename T>
+    inline Difference_type<I>
+    count(std::false_type, I first, I last, const T& value)
+    {
+      return std::count(first, last, value);
+    }
+
+  template <typename I, typename T>
+    inline Difference_type<I>
+    count(std::true_type, I first, I last, const T& value)
+    {
+      if (first == last)
+        return 0;
+      return simd_run(simd_count_kernel(), simd_pointer(first), 
+                      std::size_t(last - first), Value_type<I>(value));
+    }
+
+  template <typename I1, typename I2>
+    inline std::pair<I1, I2>
+    mismatch(std::false_type, I1 first1, I1 last1, I2 first2)
+    {
+      return std::mismatch(first1, last1, first2);
+    }
+
+  template <typename I1, typename I2>
+    inline std::pair<I1, I2>
+    mismatch(std::true_type, I1 first1, I1 last1, I2 first2)
+    {
+      if (first1 == last1)
+        return {first1, first2};
+      const std::size_t k = simd_run(simd_mismatch_kernel(), simd_pointer(first1),
+                                     simd_pointer(first2), std::size_t(last1 - first1));
+      return {first1 + k, first2 + k};
+    }
+
+  template <typename I1, typename I2>
+    using Simd_mismatch_tag = std::integral_constant<bool,
+      Simd_tag<I1, Value_type<I2>>::value && Simd_tag<I2, Value_type<I1>>::value>;
+
+  // The standard equal compares ranges of integers with memcmp, which the
+  // mismatch kernel does not improve on.
+  template <typename I1, typename I2>
+    using Simd_equal_tag = std::integral_constant<bool,
+      Simd_mismatch_tag<I1, I2>::value && !Integer<Value_type<I1>>()>;
+
+  template <typename I1, typename I2>
+    inline bool
+    equal(std::false_type, I1 first1, I1 last1, I2 first2)
+    {
+      return std::equal(first1, last1, first2);
+    }
+
+  template <typename I1, typename I2>
+    inline bool
+    equal(std::true_type, I1 first1, I1 last1, I2 first2)
+    {
+      return mismatch(std::true_type(), first1, last1, first2).first == last1;
+    }
+
+  // The min and max kernels apply only to integers. The order of floating
+  // point values is not total, and the results of the standard algorithms
+  // in the presence of NaNs depend on the order of the comparisons.
+  template <typename I>
+    using Simd_minmax_tag = std::integral_constant<bool,
+      Simd_tag<I, Value_type<I>>::value && Integer<Value_type<I>>()>;
+
+  template <typename I>
+    inline simd_extrema
+    simd_extrema_of(I first, I last)
+    {
+      return simd_run(simd_extrema_kernel(), simd_pointer(first), 
+                      std::size_t(last - first));
+    }
+
+  template <typename I>
+    inline I
+    min_element(std::false_type, I first, I last)
+    {
+      return std::min_element(first, last);
+    }
+
+  // The first least element.
+  template <typename I>
+    inline I
+    min_element(std::true_type, I first, I last)
+    {
+      if (first == last)
+        return last;
+      return first + simd_extrema_of(first, last).min;
+    }
+
+  template <typename I>
+    inline I
+    max_element(std::false_type, I first, I last)
+    {
+      return std::max_element(first, last);
+    }
+
+  // The first greatest element.
+  template <typename I>
+    inline I
+    max_element(std::true_type, I first, I last)
+    {
+      if (first == last)
+        return last;
+      return first + simd_extrema_of(first, last).first_max;
+    }
+
+  template <typename I>
+    inline std::pair<I, I>
+    minmax_element(std::false_type, I first, I last)
+    {
+      return std::minmax_element(first, last);
+    }
+
+  // The first least and the last greatest element.
+  template <typename I>
+    inline std::pair<I, I>
+    minmax_element(std::true_type, I first, I last)
+    {
+      if (first == last)
+        return {last, last};
+      const simd_extrema e = simd_extrema_of(first, last);
+      return {first + e.min, first + e.last_max};
+    }
+
+} // namespace sequence_impl
+
+#undef ORIGIN_SEQUENCE_SIMD_INLINE
+#ifdef ORIGIN_SEQUENCE_SIMD_DISPATCH
+#  undef ORIGIN_SEQUENCE_SIMD_DISPATCH
+#endif
@@ -0,0 +1,452 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_SEQUENCE_ALGORITHM_HPP
+#  error Do not include this file directly. Include sequence/algorithm.hpp.
+#endif
+
+// The parallel sorts. Ranges of up to sort_cutoff elements, and the pieces
+// of larger ranges once they are that small, are sorted sequentially.
+//
+// The unstable sort is a sample sort: the elements are distributed into
+// buckets bounded by splitters drawn from a sorted sample of the range,
+// and the buckets are sorted concurrently. The stable sort is a merge sort:
+// chunks of the range are stable sorted concurrently and then merged
+// pairwise, with each merge split among the threads.
+//
+// The sorts move elements through uninitialized buffers. The sample sort
+// needs a buffer as large as the range, and the merges of the stable sort
+// one as large as the left runs of a round, about half the range. No
+// buffer larger than sort_buffer_limit bytes is allocated. If the buffer
+// is too large or cannot be allocated, the unstable sort falls back to an
+// in-place parallel quicksort and the stable sort to std::stable_sort.
+namespace sequence_impl
+{
+  // The default comparison of the sorts.
+  struct less_than
+  {
+    template <typename T, typename U>
+      bool operator()(const T& a, const U& b) const { return a < b; }
+  };
+
+  constexpr std::size_t sort_cutoff = 1 << 14;
+
+  // The number of samples drawn per bucket by the sample sort.
+  constexpr std::size_t sort_oversampling = 16;
+
+  // The size in bytes of the largest buffer allocated by a sort.
+  constexpr std::size_t sort_buffer_limit = std::size_t(1) << 28;
+
+  // Uninitialized storage for n objects of type T. The buffer is empty if
+  // it would be larger than sort_buffer_limit bytes or the memory is not
+  // available. The sorts construct objects in the buffer as they move
+  // elements into it, and destroy them before the buffer is released.
+  template <typename T>
+    class sort_buffer
+    {
+    public:
+      explicit sort_buffer(std::size_t n)
+        : ptr_(n != 0 && n <= sort_buffer_limit / sizeof(T)
+                 ? static_cast<T*>(::operator new(n * sizeof(T), std::nothrow))
+                 : nullptr)
+      { }
+
+      sort_buffer(const sort_buffer&) = delete;
+      sort_buffer& operator=(const sort_buffer&) = delete;
+
+      ~sort_buffer() { ::operator delete(ptr_); }
+
+      bool empty() const { return ptr_ == nullptr; }
+      T* data() const { return ptr_; }
+
+    private:
+      T* ptr_;
+    };
+
+  // Destroy the objects in [first, last).
+  template <typename T>
+    inline void
+    destroy_range(T* first, T* last)
+    {
+      for (; first != last; ++first)
+        first->~T();
+    }
+
+  // Sort [first, last) in place by recursive partitioning, running the
+  // right part of each partition as a task of g. The pivot is the median of
+  // the first, middle and last elements, and elements equivalent to the
+  // pivot are gathered next to it so that ranges with many equal elements
+  // are not partitioned over and over. Ranges that are still large after
+  // depth partitions are handed to std::sort.
+  template <typename I, typename C>
+    void
+    parallel_quicksort(task_group& g, I first, I last, C comp, std::size_t depth)
+    {
+      using T = Value_type<I>;
+      while (std::size_t(last - first) > sort_cutoff) {
+        if (depth-- == 0)
+          break;
+        I a = first;
+        I m = first + (last - first) / 2;
+        I b = last - 1;
+        if (comp(*m, *a))
+          std::iter_swap(m, a);
+        if (comp(*b, *m)) {
+          std::iter_swap(b, m);
+          if (comp(*m, *a))
+            std::iter_swap(m, a);
+        }
+        std::iter_swap(first, m);
+
+        I p = std::partition(first + 1, last, [&](const T& x) { return comp(x, *first); });
+        --p;
+        std::iter_swap(first, p);
+        I q = std::partition(p + 1, last, [&](const T& x) { return !comp(*p, x); });
+
+        // Now [first, p) precedes the pivot, [p, q) is equivalent to it,
+        // and [q, last) follows it.
+        g.run([&g, q, last, comp, depth]() {
+          parallel_quicksort(g, q, last, comp, depth);
+        });
+        last = p;
+      }
+      std::sort(first, last, comp);
+    }
+
+  template <typename I, typename C>
+    void
+    parallel_quicksort(thread_pool& pool, I first, I last, C comp)
+    {
+      std::size_t depth = 0;
+      for (std::size_t n = last - first; n > 1; n /= 2)
+        depth += 2;
+      task_group g(pool);
+      parallel_quicksort(g, first, last, comp, depth);
+      g.wait();
+    }
+
+  // Sort the n elements starting at first using the uninitialized buffer buf
+  // of n elements.
+  template <typename I, typename T, typename C>
+    void
+    sample_sort(thread_pool& pool, I first, std::size_t n, T* buf, C comp)
+    {
+      // One bucket and one chunk of the input per task, and at most 256 of
+      // them so that a bucket index fits in a byte. Both passes over the
+      // input use exactly k chunks, whatever the size of the pool.
+      const std::size_t k = std::min(chunk_count(pool, n, sort_cutoff), std::size_t(256));
+
+      // Splitters are chosen from a sorted sample of evenly spaced
+      // elements. They are referred to by position, since the elements are
+      // not moved until every element has been assigned a bucket.
+      const std::size_t s = k * sort_oversampling;
+      std::vector<std::size_t> sample(s);
+      for (std::size_t i = 0; i < s; ++i)
+        sample[i] = (2 * i + 1) * n / (2 * s);
+      std::sort(sample.begin(), sample.end(), [&](std::size_t i, std::size_t j) {
+        return comp(first[i], first[j]);
+      });
+      std::vector<std::size_t> split(k - 1);
+      for (std::size_t b = 1; b < k; ++b)
+        split[b - 1] = sample[b * sort_oversampling];
+
+      // Assign each element to a bucket: the number of splitters not after
+      // it. Count the elements of each bucket in each chunk.
+      std::vector<unsigned char> bucket(n);
+      std::vector<std::size_t> count(k * k, 0);
+      parallel_split(pool, n, k, [&](std::size_t c, std::size_t i, std::size_t j) {
+        std::size_t* cc = &count[c * k];
+        for (std::size_t e = i; e != j; ++e) {
+          auto u = std::upper_bound(split.begin(), split.end(), e, 
+            [&](std::size_t x, std::size_t y) { return comp(first[x], first[y]); });
+          const std::size_t b = u - split.begin();
+          bucket[e] = static_cast<unsigned char>(b);
+          ++cc[b];
+        }
+      });
+
+      // Each chunk writes its elements of bucket b after those of the
+      // earlier buckets and of the earlier chunks.
+      std::vector<std::size_t> start(k + 1);
+      std::size_t off = 0;
+      for (std::size_t b = 0; b < k; ++b) {
+        start[b] = off;
+        for (std::size_t c = 0; c < k; ++c) {
+          const std::size_t x = count[c * k + b];
+          count[c * k + b] = off;
+          off += x;
+        }
+      }
+      start[k] = n;
+
+      parallel_split(pool, n, k, [&](std::size_t c, std::size_t i, std::size_t j) {
+        std::size_t* cc = &count[c * k];
+        for (std::size_t e = i; e != j; ++e)
+          ::new (static_cast<void*>(buf + cc[bucket[e]]++)) T(std::move(first[e]));
+      });
+
+      // Move each bucket back into place and sort it. The buffer is emptied
+      // before the comparison is called again. A bucket that is much larger
+      // than the others (e.g., of many equal elements) is sorted by the
+      // parallel quicksort.
+      task_group g(pool);
+      for (std::size_t b = 0; b < k; ++b) {
+        g.run([&, b]() {
+          I f = first + start[b];
+          I l = first + start[b + 1];
+          std::move(buf + start[b], buf + start[b + 1], f);
+          destroy_range(buf + start[b], buf + start[b + 1]);
+          if (std::size_t(l - f) > 2 * n / k)
+            parallel_quicksort(pool, f, l, comp);
+          else
+            std::sort(f, l, comp);
+        });
+      }
+      g.wait();
+    }
+
+  template <typename P, typename I, typename C>
+    inline void
+    sort(std::false_type, const P&, I first, I last, C comp)
+    {
+      std::sort(first, last, comp);
+    }
+
+  template <typename P, typename I, typename C>
+    void
+    sort(std::true_type, const P& policy, I first, I last, C comp)
+    {
+      thread_pool& pool = pool_of(policy);
+      const std::size_t n = last - first;
+      if (chunk_count(pool, n, sort_cutoff) < 2) {
+        std::sort(first, last, comp);
+        return;
+      }
+      sort_buffer<Value_type<I>> buf(n);
+      if (buf.empty())
+        parallel_quicksort(pool, first, last, comp);
+      else
+        sample_sort(pool, first, n, buf.data(), comp);
+    }
+
+  // Returns the number of elements of the sorted range [a, a + na) that
+  // precede the dth element of their stable merge with [b, b + nb).
+  template <typename I1, typename I2, typename C>
+    std::size_t
+    merge_split(I1 a, std::size_t na, I2 b, std::size_t nb, std::size_t d, C comp)
+    {
+      std::size_t lo = d > nb ? d - nb : 0;
+      std::size_t hi = std::min(d, na);
+      while (lo < hi) {
+        const std::size_t mid = lo + (hi - lo) / 2;
+        if (comp(b[d - mid - 1], a[mid]))
+          hi = mid;
+        else
+          lo = mid + 1;
+      }
+      return lo;
+    }
+
+  // Move the elements of the sorted ranges [a, a_last) and [b, b_last) to
+  // out in merged order, taking the element of [a, a_last) first when they
+  // are equivalent. The output may precede [b, b_last) in the same sequence:
+  // it never overtakes b, and if it reaches b when [a, a_last) is exhausted,
+  // the rest of [b, b_last) is already in place.
+  template <typename T, typename I, typename C>
+    void
+    merge_move(T* a, T* a_last, I b, I b_last, I out, C comp)
+    {
+      for (; a != a_last && b != b_last; ++out) {
+        if (comp(*b, *a)) {
+          *out = std::move(*b);
+          ++b;
+        } else {
+          *out = std::move(*a);
+          ++a;
+        }
+      }
+      out = std::move(a, a_last, out);
+      if (out != b)
+        std::move(b, b_last, out);
+    }
+
+  // Merge the adjacent sorted runs [first, first + na) and [first + na,
+  // first + na + nb) in place, using buf as uninitialized storage for the
+  // na elements of the left run.
+  //
+  // The left run is moved into the buffer, which leaves na free positions
+  // in front of the right run. Each step fills the free positions with the
+  // next elements of the merge, split into pieces that run as separate
+  // tasks. The elements taken from the right run free as many positions
+  // for the next step as remain in the buffer. Once fewer than sort_cutoff
+  // elements remain in the buffer, the rest is merged sequentially.
+  template <typename I, typename T, typename C>
+    void
+    buffered_merge(thread_pool& pool, I first, std::size_t na, std::size_t nb,
+                   T* buf, C comp)
+    {
+      parallel_for(pool, na, parallel_grain, [&](std::size_t i, std::size_t j) {
+        std::uninitialized_copy(std::make_move_iterator(first + i),
+                                std::make_move_iterator(first + j), buf + i);
+      });
+      try {
+        const I b = first + na;
+        std::size_t ia = 0;
+        std::size_t ib = 0;
+        while (ia != na && ib != nb) {
+          const std::size_t room = na - ia;
+          const I out = first + (ia + ib);
+          if (room < sort_cutoff) {
+            merge_move(buf + ia, buf + na, b + ib, b + nb, out, comp);
+            ia = na;
+            break;
+          }
+          const std::size_t pieces = room / sort_cutoff;
+          std::vector<std::size_t> split(pieces + 1);
+          for (std::size_t q = 0; q <= pieces; ++q)
+            split[q] = merge_split(buf + ia, na - ia, b + ib, nb - ib, 
+                                   room * q / pieces, comp);
+          parallel_split(pool, room, pieces, [&](std::size_t q, std::size_t d0, std::size_t d1) {
+            const std::size_t i0 = split[q];
+            const std::size_t i1 = split[q + 1];
+            merge_move(buf + ia + i0, buf + ia + i1, 
+                       b + ib + (d0 - i0), b + ib + (d1 - i1), out + d0, comp);
+          });
+          ia += split[pieces];
+          ib += room - split[pieces];
+        }
+
+        // If the right run is exhausted, the rest of the buffer follows it.
+        if (ia != na) {
+          const I out = first + (ia + ib);
+          parallel_for(pool, na - ia, parallel_grain, [&](std::size_t i, std::size_t j) {
+            std::move(buf + ia + i, buf + ia + j, out + i);
+          });
+        }
+      } catch (...) {
+        destroy_range(buf, buf + na);
+        throw;
+      }
+      destroy_range(buf, buf + na);
+    }
+
+  template <typename P, typename I, typename C>
+    inline void
+    stable_sort(std::false_type, const P&, I first, I last, C comp)
+    {
+      std::stable_sort(first, last, comp);
+    }
+
+  template <typename P, typename I, typename C>
+    void
+    stable_sort(std::true_type, const P& policy, I first, I last, C comp)
+    {
+      thread_pool& pool = pool_of(policy);
+      const std::size_t n = last - first;
+      std::size_t k = chunk_count(pool, n, sort_cutoff);
+      if (k < 2) {
+        std::stable_sort(first, last, comp);
+        return;
+      }
+
+      // With a power of two chunks, every run of a round is paired, and the
+      // left runs of a round hold about half the elements. The buffer is
+      // as large as the left runs of any round.
+      while (k & (k - 1))
+        k &= k - 1;
+      std::vector<std::size_t> bounds(k + 1);
+      for (std::size_t c = 0; c <= k; ++c)
+        bounds[c] = n * c / k;
+      std::size_t size = 0;
+      for (std::size_t w = 1; w < k; w *= 2) {
+        std::size_t left = 0;
+        for (std::size_t c = 0; c < k; c += 2 * w)
+          left += bounds[c + w] - bounds[c];
+        size = std::max(size, left);
+      }
+      sort_buffer<Value_type<I>> buf(size);
+      if (buf.empty()) {
+        std::stable_sort(first, last, comp);
+        return;
+      }
+
+      parallel_split(pool, n, k, [&](std::size_t, std::size_t i, std::size_t j) {
+        std::stable_sort(first + i, first + j, comp);
+      });
+
+      // Merge the pairs of runs of each round concurrently, each with its
+      // own part of the buffer.
+      for (std::size_t w = 1; w < k; w *= 2) {
+        task_group g(pool);
+        std::size_t offset = 0;
+        for (std::size_t c = 0; c < k; c += 2 * w) {
+          const std::size_t lo = bounds[c];
+          const std::size_t na = bounds[c + w] - lo;
+          const std::size_t nb = bounds[c + 2 * w] - bounds[c + w];
+          auto* p = buf.data() + offset;
+          offset += na;
+          g.run([&pool, first, lo, na, nb, p, comp]() {
+            buffered_merge(pool, first + lo, na, nb, p, comp);
+          });
+        }
+        g.wait();
+      }
+    }
+
+} // namespace sequence_impl
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                        [algo.parallel.sort]
+  //                           Parallel Sorting
+  //
+  //    sort(policy, range)
+  //    sort(policy, range, comp)
+  //    stable_sort(policy, range)
+  //    stable_sort(policy, range, comp)
+  //
+  // With a parallel policy, sort is a sample sort and stable_sort is a merge
+  // sort. The sample sort uses a temporary buffer as large as the range, and
+  // the merge sort one about half as large, when it can be allocated and
+  // takes at most 256 MiB. If comp throws, the order of the elements is
+  // unspecified.
+
+  template <typename P, typename R, typename C>
+    inline Requires<Execution_policy<P>(), void>
+    sort(const P& policy, R&& range, C comp)
+    {
+      using std::begin;
+      using std::end;
+      using I = Iterator_of<R>;
+      sequence_impl::sort(sequence_impl::Parallel_tag<P, I>(), policy, 
+                          begin(range), end(range), comp);
+    }
+
+  template <typename P, typename R>
+    inline Requires<Execution_policy<P>(), void>
+    sort(const P& policy, R&& range)
+    {
+      sort(policy, range, sequence_impl::less_than());
+    }
+
+  template <typename P, typename R, typename C>
+    inline Requires<Execution_policy<P>(), void>
+    stable_sort(const P& policy, R&& range, C comp)
+    {
+      using std::begin;
+      using std::end;
+      using I = Iterator_of<R>;
+      sequence_impl::stable_sort(sequence_impl::Parallel_tag<P, I>(), policy, 
+                                 begin(range), end(range), comp);
+    }
+
+  template <typename P, typename R>
+    inline Requires<Execution_policy<P>(), void>
+    stable_sort(const P& policy, R&& range)
+    {
+      stable_sort(policy, range, sequence_impl::less_than());
+    }
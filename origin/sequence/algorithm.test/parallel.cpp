@@ -0,0 +1,158 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include <list>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <origin/sequence/algorithm.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Tests for the thread pool and the algorithms with execution policies. An
+// explicit pool is used so that the algorithms run on several threads even
+// on a machine with one processor.
+
+bool odd(int n) { return n & 1; }
+
+void test_pool()
+{
+  thread_pool pool(3);
+  assert(pool.size() == 3);
+
+  // Nested task groups complete without deadlock.
+  atomic<int> n(0);
+  task_group g(pool);
+  for (int i = 0; i < 8; ++i)
+    g.run([&]() {
+      task_group h(pool);
+      for (int j = 0; j < 8; ++j)
+        h.run([&]() { ++n; });
+      h.wait();
+    });
+  g.wait();
+  assert(n == 64);
+
+  // Exceptions are rethrown by wait.
+  task_group e(pool);
+  e.run([]() { throw runtime_error("task"); });
+  bool caught = false;
+  try {
+    e.wait();
+  } catch (runtime_error&) {
+    caught = true;
+  }
+  assert(caught);
+
+  // A thread waiting for a task that is running elsewhere blocks rather
+  // than spins.
+  thread_pool one(1);
+  task_group s(one);
+  atomic<bool> started(false);
+  s.run([&]() {
+    started = true;
+    this_thread::sleep_for(chrono::milliseconds(300));
+  });
+  while (!started)
+    this_thread::sleep_for(chrono::milliseconds(1));
+  const clock_t start = clock();
+  s.wait();
+  assert(clock() - start < CLOCKS_PER_SEC / 10);
+
+  // A pool without workers runs tasks immediately.
+  thread_pool none(0);
+  int m = 0;
+  task_group z(none);
+  z.run([&]() { ++m; });
+  assert(m == 1);
+  z.wait();
+}
+
+template <typename P>
+  void test_policy(const P& p)
+  {
+    const int n = 1000003;
+    vector<int> v(n);
+    for (int i = 0; i < n; ++i)
+      v[i] = i;
+
+    assert(count_if(p, v, odd) == count_if(v, odd));
+    assert(count(p, v, 77) == 1);
+    assert(find(p, v, 500000) == v.begin() + 500000);
+    assert(find(p, v, -1) == v.end());
+    assert(find_if(p, v, [](int x) { return x > 999000; }) == v.begin() + 999001);
+    assert(find_if_not(p, v, [](int x) { return x < 3; }) == v.begin() + 3);
+    assert(all_of(p, v, [](int x) { return x >= 0; }));
+    assert(!all_of(p, v, [](int x) { return x < 900000; }));
+    assert(any_of(p, v, [](int x) { return x == n - 1; }));
+    assert(none_of(p, v, [](int x) { return x < 0; }));
+
+    // The first of several matches is found.
+    vector<int> w(n, 0);
+    for (int i : {123456, 5000, 900000})
+      w[i] = 1;
+    assert(find(p, w, 1) == w.begin() + 5000);
+
+    vector<int> u(n);
+    assert(range_transform(p, v, u, [](int x) { return 2 * x; }) == u.end());
+    assert(u[n - 1] == 2 * (n - 1) && u[12345] == 24690);
+    range_transform(p, v, u, u, [](int x, int y) { return x + y; });
+    assert(u[n - 1] == 3 * (n - 1));
+
+    for_each(p, u, [](int& x) { x = -x; });
+    assert(u[0] == 0 && u[7] == -21);
+
+    fill(p, u, 4);
+    assert(count(p, u, 4) == n);
+    assert(copy(p, v, u) == u.end());
+    assert(range_equal(p, u, v));
+    u[777777] = 0;
+    assert(!range_equal(p, u, v));
+    auto mm = range_mismatch(p, u, v);
+    assert(mm.first == u.begin() + 777777 && mm.second == v.begin() + 777777);
+    assert(range_equal(p, u, v, [](int x, int y) { return x <= y; }));
+
+    // Ranges without random access run sequentially.
+    list<int> l(v.begin(), v.begin() + 100);
+    assert(count_if(p, l, odd) == 50);
+    assert(*find(p, l, 42) == 42);
+  }
+
+void test_exceptions()
+{
+  thread_pool pool(3);
+  vector<int> v(1 << 20, 1);
+  bool caught = false;
+  v[(1 << 20) - 1] = 2;
+  try {
+    for_each(par.on(pool), v, [](int x) {
+      if (x == 2)
+        throw runtime_error("element");
+    });
+  } catch (runtime_error&) {
+    caught = true;
+  }
+  assert(caught);
+}
+
+int main()
+{
+  test_pool();
+
+  thread_pool pool(3);
+  test_policy(seq);
+  test_policy(par);
+  test_policy(par.on(pool));
+  test_policy(par_unseq.on(pool));
+  test_exceptions();
+}
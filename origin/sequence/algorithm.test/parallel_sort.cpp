@@ -0,0 +1,186 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <origin/sequence/algorithm.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Tests for the parallel sorts.
+
+// Returns n pseudo-random values in [0, m).
+vector<int> random_values(size_t n, uint64_t m, uint64_t seed)
+{
+  vector<int> v(n);
+  uint64_t x = seed;
+  for (auto& e : v) {
+    x = x * 6364136223846793005ull + 1442695040888963407ull;
+    e = int((x >> 33) % m);
+  }
+  return v;
+}
+
+// A value type that is not default constructible.
+struct boxed
+{
+  explicit boxed(int n) : value(n) { }
+  int value;
+};
+
+bool operator<(const boxed& a, const boxed& b) { return a.value < b.value; }
+
+// A value type that counts its objects. The sorts construct and destroy
+// objects in their uninitialized buffers, and must destroy every object
+// they construct.
+struct counted
+{
+  static atomic<long> live;
+
+  explicit counted(int n) : value(n), text(to_string(n)) { ++live; }
+  counted(counted&& x) : value(x.value), text(std::move(x.text)) { ++live; }
+  counted& operator=(counted&&) = default;
+  ~counted() { --live; }
+
+  int value;
+  string text;
+};
+
+atomic<long> counted::live(0);
+
+bool operator<(const counted& a, const counted& b) { return a.value < b.value; }
+
+template <typename P>
+  void test_sort(const P& p)
+  {
+    for (size_t n : {0, 1, 1000, 20000, 200003}) {
+      for (uint64_t m : {uint64_t(1), uint64_t(3), uint64_t(1) << 31}) {
+        vector<int> v = random_values(n, m, n + m);
+        vector<int> w = v;
+        sort(p, v);
+        std::sort(w.begin(), w.end());
+        assert(v == w);
+
+        sort(p, v, greater<int>());
+        std::sort(w.begin(), w.end(), greater<int>());
+        assert(v == w);
+      }
+    }
+
+    // Sorted and reversed input.
+    vector<int> v(100000);
+    for (size_t i = 0; i < v.size(); ++i)
+      v[i] = int(v.size() - i);
+    sort(p, v);
+    assert(std::is_sorted(v.begin(), v.end()));
+    sort(p, v);
+    assert(std::is_sorted(v.begin(), v.end()));
+
+    // Value types that are not default constructible.
+    vector<boxed> b;
+    for (int x : random_values(50000, 1000, 7))
+      b.emplace_back(x);
+    sort(p, b);
+    assert(std::is_sorted(b.begin(), b.end()));
+
+    vector<string> s;
+    for (int x : random_values(20000, 100000, 9))
+      s.push_back(to_string(x));
+    vector<string> t = s;
+    sort(p, s);
+    std::sort(t.begin(), t.end());
+    assert(s == t);
+  }
+
+template <typename P>
+  void test_objects(const P& p)
+  {
+    vector<counted> v;
+    for (int x : random_values(150001, 1000, 5))
+      v.emplace_back(x);
+    assert(counted::live == 150001);
+
+    sort(p, v);
+    assert(counted::live == 150001);
+    assert(std::is_sorted(v.begin(), v.end()));
+
+    for (auto& x : v)
+      x.value = x.value % 10;
+    stable_sort(p, v);
+    assert(counted::live == 150001);
+    for (size_t i = 1; i < v.size(); ++i)
+      assert(v[i - 1].value < v[i].value 
+          || (v[i - 1].value == v[i].value && stoi(v[i - 1].text) <= stoi(v[i].text)));
+  }
+
+template <typename P>
+  void test_stable_sort(const P& p)
+  {
+    // Sort pairs by their first element only; the second records the
+    // original position.
+    auto first_less = [](const pair<int, int>& a, const pair<int, int>& b) {
+      return a.first < b.first;
+    };
+    for (size_t n : {0, 10, 20000, 150001}) {
+      vector<int> keys = random_values(n, 100, n);
+      vector<pair<int, int>> v(n);
+      for (size_t i = 0; i < n; ++i)
+        v[i] = {keys[i], int(i)};
+      vector<pair<int, int>> w = v;
+      stable_sort(p, v, first_less);
+      std::stable_sort(w.begin(), w.end(), first_less);
+      assert(v == w);
+    }
+
+    vector<int> v = random_values(100000, 1000000, 3);
+    vector<int> w = v;
+    stable_sort(p, v);
+    std::stable_sort(w.begin(), w.end());
+    assert(v == w);
+
+    // Moved-from strings are empty, so a merge that reads an element after
+    // it was moved loses it.
+    vector<string> s;
+    for (int x : random_values(300000, 1000000, 4))
+      s.push_back(to_string(x));
+    vector<string> t = s;
+    stable_sort(p, s);
+    std::stable_sort(t.begin(), t.end());
+    assert(s == t);
+  }
+
+int main()
+{
+  thread_pool pool(3);
+  test_sort(seq);
+  test_sort(par);
+  test_sort(par.on(pool));
+  test_stable_sort(seq);
+  test_stable_sort(par.on(pool));
+  test_stable_sort(par_unseq.on(pool));
+  test_objects(par.on(pool));
+
+  // A pool with more threads than the sample sort has buckets.
+  thread_pool large(70);
+  vector<int> big = random_values(4500000, uint64_t(1) << 31, 13);
+  sort(par.on(large), big);
+  assert(std::is_sorted(big.begin(), big.end()));
+
+  // The in-place quicksort on its own.
+  vector<int> v = random_values(100000, 50, 11);
+  vector<int> w = v;
+  sequence_impl::parallel_quicksort(pool, v.begin(), v.end(), less<int>());
+  std::sort(w.begin(), w.end());
+  assert(v == w);
+}
@@ -0,0 +1,160 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <origin/sequence/algorithm.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Tests for the radix sorts.
+
+uint64_t next_random(uint64_t& x)
+{
+  x = x * 6364136223846793005ull + 1442695040888963407ull;
+  return x >> 11;
+}
+
+// Returns n pseudo-random values of type T whose bits are drawn from the
+// low bits of the generator.
+template <typename T>
+  vector<T> random_values(size_t n, uint64_t seed)
+  {
+    vector<T> v(n);
+    for (auto& e : v)
+      e = T(next_random(seed));
+    return v;
+  }
+
+// Check each radix sort against std::sort.
+template <typename T>
+  void check_sorts(const vector<T>& v, thread_pool& pool)
+  {
+    vector<T> w = v;
+    std::sort(w.begin(), w.end());
+
+    vector<T> a = v;
+    radix_sort(a);
+    assert(a == w);
+    vector<T> b = v;
+    radix_sort(par.on(pool), b);
+    assert(b == w);
+    vector<T> c = v;
+    radix_sort_in_place(c);
+    assert(c == w);
+  }
+
+void test_integers(thread_pool& pool)
+{
+  for (size_t n : {0, 1, 50, 1000, 100000}) {
+    check_sorts(random_values<int>(n, n), pool);
+    check_sorts(random_values<unsigned char>(n, n), pool);
+    check_sorts(random_values<short>(n, n), pool);
+    check_sorts(random_values<long long>(n, n), pool);
+    check_sorts(random_values<uint64_t>(n, n), pool);
+  }
+
+  // Small values in a wide type skip the passes over the high bytes.
+  vector<int64_t> v = random_values<int64_t>(70000, 1);
+  for (auto& x : v)
+    x %= 1000;
+  check_sorts(v, pool);
+
+  vector<int> e {numeric_limits<int>::max(), -1, 0, numeric_limits<int>::min(), 1};
+  check_sorts(e, pool);
+}
+
+void test_floating(thread_pool& pool)
+{
+  uint64_t seed = 5;
+  vector<double> d(100000);
+  for (auto& x : d)
+    x = (double(next_random(seed)) / (1ull << 53) - 0.5) * 1e6;
+  d[0] = 0.0;
+  d[1] = -1e-300;
+  d[2] = numeric_limits<double>::infinity();
+  d[3] = -numeric_limits<double>::infinity();
+  check_sorts(d, pool);
+
+  vector<float> f(d.begin(), d.end());
+  check_sorts(f, pool);
+
+  // Negative zero precedes positive zero.
+  vector<double> z {0.0, -0.0};
+  radix_sort(z);
+  assert(signbit(z[0]) && !signbit(z[1]));
+}
+
+void test_composite(thread_pool& pool)
+{
+  vector<pair<int, double>> p;
+  uint64_t seed = 9;
+  for (size_t i = 0; i < 50000; ++i)
+    p.emplace_back(int(next_random(seed) % 100) - 50, double(next_random(seed) % 1000) / 8);
+  check_sorts(p, pool);
+
+  vector<tuple<unsigned char, int, short>> t;
+  for (size_t i = 0; i < 50000; ++i)
+    t.emplace_back(next_random(seed) % 4, int(next_random(seed) % 7) - 3, short(next_random(seed)));
+  check_sorts(t, pool);
+}
+
+void test_keys(thread_pool& pool)
+{
+  // The sort by a key is stable.
+  struct record 
+  { 
+    int key; 
+    string name; 
+    size_t order; 
+  };
+  vector<record> r;
+  uint64_t seed = 3;
+  for (size_t i = 0; i < 60000; ++i)
+    r.push_back({int(next_random(seed) % 300) - 100, to_string(i), i});
+  auto key = [](const record& x) { return x.key; };
+  auto less = [](const record& a, const record& b) {
+    return a.key < b.key || (a.key == b.key && a.order < b.order);
+  };
+
+  vector<record> a = r;
+  radix_sort(a, key);
+  assert(std::is_sorted(a.begin(), a.end(), less));
+
+  vector<record> b = r;
+  radix_sort(par.on(pool), b, key);
+  assert(std::is_sorted(b.begin(), b.end(), less));
+
+  // The elements are moved through the buffer intact.
+  for (size_t i = 0; i < a.size(); ++i)
+    assert(a[i].name == to_string(a[i].order) && b[i].name == to_string(b[i].order));
+
+  vector<record> c = r;
+  radix_sort_in_place(c, key);
+  assert(std::is_sorted(c.begin(), c.end(), [](const record& x, const record& y) {
+    return x.key < y.key;
+  }));
+  for (size_t i = 0; i < c.size(); ++i)
+    assert(c[i].name == to_string(c[i].order));
+}
+
+int main()
+{
+  thread_pool pool(3);
+  test_integers(pool);
+  test_floating(pool);
+  test_composite(pool);
+  test_keys(pool);
+}
@@ -0,0 +1,126 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <list>
+#include <vector>
+
+#include <origin/sequence/algorithm.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Tests for the vectorized find, count, mismatch, equal and min/max
+// element algorithms. Each is compared with the standard algorithm at
+// sizes and positions around the block boundaries of the kernels.
+
+static_assert(sequence_impl::Simd_tag<int*, int>(), "");
+static_assert(sequence_impl::Simd_tag<vector<double>::const_iterator, double>(), "");
+static_assert(!sequence_impl::Simd_tag<list<int>::iterator, int>(), "");
+static_assert(!sequence_impl::Simd_tag<int*, long>(), "");
+static_assert(!sequence_impl::Simd_minmax_tag<float*>(), "");
+static_assert(!sequence_impl::Simd_tag<vector<bool>::iterator, bool>(), "");
+static_assert(sequence_impl::Simd_tag<bool*, bool>(), "");
+
+#ifdef ORIGIN_SEQUENCE_SIMD_DISPATCH
+#  error The kernel macros should not be visible outside the library.
+#endif
+
+template <typename T>
+  void check(size_t n)
+  {
+    vector<T> v(n);
+    for (size_t i = 0; i < n; ++i)
+      v[i] = T(i % 23 + 1);
+    const vector<T>& c = v;
+
+    for (size_t k : {size_t(0), size_t(1), n / 2, n - 1, n}) {
+      vector<T> w = v;
+      if (k < n)
+        w[k] = T(0);
+      assert(find(w, T(0)) == std::find(w.begin(), w.end(), T(0)));
+      assert(count(w, T(0)) == std::count(w.begin(), w.end(), T(0)));
+      assert(range_mismatch(w, v) == std::mismatch(w.begin(), w.end(), v.begin()));
+      assert(range_equal(w, c) == (k >= n));
+    }
+    assert(count(c, T(5)) == std::count(c.begin(), c.end(), T(5)));
+    assert(find(c, T(24)) == c.end());
+
+    // Repeated extremes: min_element and max_element find the first,
+    // and minmax_element the first least and the last greatest.
+    vector<T> m = v;
+    if (n > 2) {
+      m[n / 3] = T(0);
+      m[n - 1] = T(0);
+      m[1] = T(100);
+      m[n / 2] = T(100);
+    }
+    assert(min_element(m) == std::min_element(m.begin(), m.end()));
+    assert(max_element(m) == std::max_element(m.begin(), m.end()));
+    assert(minmax_element(m) == std::minmax_element(m.begin(), m.end()));
+  }
+
+template <typename T>
+  void check_sizes()
+  {
+    for (size_t n : {1, 2, 15, 16, 17, 127, 128, 129, 1000, 4099})
+      check<T>(n);
+  }
+
+int main()
+{
+  check_sizes<char>();
+  check_sizes<unsigned char>();
+  check_sizes<short>();
+  check_sizes<int>();
+  check_sizes<uint32_t>();
+  check_sizes<long long>();
+  check_sizes<float>();
+  check_sizes<double>();
+
+  // Empty ranges.
+  vector<int> e;
+  assert(find(e, 1) == e.end());
+  assert(count(e, 1) == 0);
+  assert(min_element(e) == e.end());
+  assert(minmax_element(e) == make_pair(e.end(), e.end()));
+  assert(range_equal(e, e));
+
+  // Vectors of bool hold proxies and use the standard algorithms.
+  vector<bool> bits(300, false);
+  bits[200] = true;
+  bits[250] = true;
+  assert(find(bits, true) == bits.begin() + 200);
+  assert(count(bits, true) == 2);
+  assert(range_equal(bits, bits));
+  assert(max_element(bits) == bits.begin() + 200);
+
+  // Signed extremes and arrays.
+  int a[300];
+  for (int i = 0; i < 300; ++i)
+    a[i] = i - 150;
+  a[200] = numeric_limits<int>::min();
+  a[17] = numeric_limits<int>::max();
+  assert(min_element(a) == a + 200);
+  assert(max_element(a) == a + 17);
+  assert(find(a, 149) == a + 299);
+
+  // Floating point comparisons keep their meaning: NaN equals nothing and
+  // -0.0 equals 0.0.
+  vector<double> d(200, 1.0);
+  d[150] = nan("");
+  assert(find(d, d[150]) == d.end());
+  assert(range_mismatch(d, d).first == d.begin() + 150);
+  assert(!range_equal(d, d));
+  d[150] = -0.0;
+  assert(find(d, 0.0) == d.begin() + 150);
+  assert(min_element(d) == d.begin() + 150);
+}